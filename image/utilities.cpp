@@ -13,9 +13,16 @@
 
 #include <iostream>
 #include <cmath>
+#include <algorithm>
 #include <boost/math/special_functions/fpclassify.hpp>
+#if defined(__AVX__) || defined(__AVX512F__)
+#include <immintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#endif
 
 #include "utilities.hpp"
+#include "../matrix/transpose.hpp"
 
 namespace stock {
 
@@ -66,7 +73,7 @@ namespace stock {
 
 	/**
 	 * compute the transpose of a matrix
-	 * use boost libs ...
+	 * uses the tiled parallel transpose engine of the matrix library
 	 */
 	bool transpose(unsigned int x_size, unsigned int y_size, const real_t *matrix, real_t* &transp) {
 		if(matrix == NULL) {
@@ -74,13 +81,11 @@ namespace stock {
 			return false;
 		} // if
 		transp = new (std::nothrow) real_t[x_size * y_size];
-		for(unsigned int y = 0; y < y_size; ++ y) {
-			for(unsigned int x = 0; x < x_size; ++ x) {
-				transp[y_size * x + y] = matrix[x_size * y + x];
-			} // for x
-		} // for y
-
-		return true;
+		if(transp == NULL) {
+			std::cerr << "error: failed to allocate memory for transpose" << std::endl;
+			return false;
+		} // if
+		return matrix_transpose(y_size, x_size, matrix, transp);
 	} // transpose()
 
 
@@ -95,9 +100,7 @@ namespace stock {
 	bool mat_mul_3x3(vector3_t a, vector3_t b, vector3_t c,
 					vector3_t d, vector3_t e, vector3_t f,
 					vector3_t& x, vector3_t& y, vector3_t& z) {
-		real_t *A = new (std::nothrow) real_t[9];
-		real_t *B = new (std::nothrow) real_t[9];
-		real_t *C = new (std::nothrow) real_t[9];
+		real_t A[9], B[9], C[9];
 
 		A[0] = a[0]; A[1] = a[1]; A[2] = a[2];
 		A[3] = b[0]; A[4] = b[1]; A[5] = b[2];
@@ -119,9 +122,6 @@ namespace stock {
 		y[0] = C[3]; y[1] = C[4]; y[2] = C[5];
 		z[0] = C[6]; z[1] = C[7]; z[2] = C[8];
 
-		delete[] C;
-		delete[] B;
-		delete[] A;
 		return true;
 	} // mat_mul_3x3()
 
@@ -144,6 +144,222 @@ namespace stock {
 	} // mat_mul_3x1()
 
 
+	/**
+	 * vector operations on real_t used by the batched 3x3 transforms,
+	 * for the widest instruction set available
+	 */
+#if defined(__AVX512F__)
+	#ifdef DOUBLEP
+	typedef __m512d simd_real_t;
+	const size_t SIMD_WIDTH_ = 8;
+	#define SIMD_LOAD_(p) _mm512_loadu_pd(p)
+	#define SIMD_STORE_(p, v) _mm512_storeu_pd(p, v)
+	#define SIMD_SET1_(a) _mm512_set1_pd(a)
+	#define SIMD_FMADD_(a, b, c) _mm512_fmadd_pd(a, b, c)
+	#define SIMD_MUL_(a, b) _mm512_mul_pd(a, b)
+	#else
+	typedef __m512 simd_real_t;
+	const size_t SIMD_WIDTH_ = 16;
+	#define SIMD_LOAD_(p) _mm512_loadu_ps(p)
+	#define SIMD_STORE_(p, v) _mm512_storeu_ps(p, v)
+	#define SIMD_SET1_(a) _mm512_set1_ps(a)
+	#define SIMD_FMADD_(a, b, c) _mm512_fmadd_ps(a, b, c)
+	#define SIMD_MUL_(a, b) _mm512_mul_ps(a, b)
+	#endif
+#elif defined(__AVX__)
+	#ifdef DOUBLEP
+	typedef __m256d simd_real_t;
+	const size_t SIMD_WIDTH_ = 4;
+	#define SIMD_LOAD_(p) _mm256_loadu_pd(p)
+	#define SIMD_STORE_(p, v) _mm256_storeu_pd(p, v)
+	#define SIMD_SET1_(a) _mm256_set1_pd(a)
+	#define SIMD_MUL_(a, b) _mm256_mul_pd(a, b)
+	#ifdef __FMA__
+	#define SIMD_FMADD_(a, b, c) _mm256_fmadd_pd(a, b, c)
+	#else
+	#define SIMD_FMADD_(a, b, c) _mm256_add_pd(_mm256_mul_pd(a, b), c)
+	#endif
+	#else
+	typedef __m256 simd_real_t;
+	const size_t SIMD_WIDTH_ = 8;
+	#define SIMD_LOAD_(p) _mm256_loadu_ps(p)
+	#define SIMD_STORE_(p, v) _mm256_storeu_ps(p, v)
+	#define SIMD_SET1_(a) _mm256_set1_ps(a)
+	#define SIMD_MUL_(a, b) _mm256_mul_ps(a, b)
+	#ifdef __FMA__
+	#define SIMD_FMADD_(a, b, c) _mm256_fmadd_ps(a, b, c)
+	#else
+	#define SIMD_FMADD_(a, b, c) _mm256_add_ps(_mm256_mul_ps(a, b), c)
+	#endif
+	#endif
+#elif defined(__SSE2__)
+	#ifdef DOUBLEP
+	typedef __m128d simd_real_t;
+	const size_t SIMD_WIDTH_ = 2;
+	#define SIMD_LOAD_(p) _mm_loadu_pd(p)
+	#define SIMD_STORE_(p, v) _mm_storeu_pd(p, v)
+	#define SIMD_SET1_(a) _mm_set1_pd(a)
+	#define SIMD_FMADD_(a, b, c) _mm_add_pd(_mm_mul_pd(a, b), c)
+	#define SIMD_MUL_(a, b) _mm_mul_pd(a, b)
+	#else
+	typedef __m128 simd_real_t;
+	const size_t SIMD_WIDTH_ = 4;
+	#define SIMD_LOAD_(p) _mm_loadu_ps(p)
+	#define SIMD_STORE_(p, v) _mm_storeu_ps(p, v)
+	#define SIMD_SET1_(a) _mm_set1_ps(a)
+	#define SIMD_FMADD_(a, b, c) _mm_add_ps(_mm_mul_ps(a, b), c)
+	#define SIMD_MUL_(a, b) _mm_mul_ps(a, b)
+	#endif
+#endif
+
+	// vectors transformed at a time by one thread, small enough for the
+	// inputs and outputs to stay in L1 while several matrices are applied
+	const size_t BATCH_CHUNK_ = 1024;
+
+
+	/**
+	 * out = r x in for vectors [begin, end), r given row-major in 9 values
+	 * all loads of a vector happen before its stores, so out may be the same as in
+	 */
+	static void mat_mul_3x1_soa(const real_t* r, size_t begin, size_t end,
+					const real_t* x, const real_t* y, const real_t* z,
+					real_t* out_x, real_t* out_y, real_t* out_z) {
+		size_t i = begin;
+	#ifdef SIMD_LOAD_
+		simd_real_t r0 = SIMD_SET1_(r[0]), r1 = SIMD_SET1_(r[1]), r2 = SIMD_SET1_(r[2]);
+		simd_real_t r3 = SIMD_SET1_(r[3]), r4 = SIMD_SET1_(r[4]), r5 = SIMD_SET1_(r[5]);
+		simd_real_t r6 = SIMD_SET1_(r[6]), r7 = SIMD_SET1_(r[7]), r8 = SIMD_SET1_(r[8]);
+		for(; i + SIMD_WIDTH_ <= end; i += SIMD_WIDTH_) {
+			simd_real_t vx = SIMD_LOAD_(x + i), vy = SIMD_LOAD_(y + i), vz = SIMD_LOAD_(z + i);
+			SIMD_STORE_(out_x + i, SIMD_FMADD_(r2, vz, SIMD_FMADD_(r1, vy, SIMD_MUL_(r0, vx))));
+			SIMD_STORE_(out_y + i, SIMD_FMADD_(r5, vz, SIMD_FMADD_(r4, vy, SIMD_MUL_(r3, vx))));
+			SIMD_STORE_(out_z + i, SIMD_FMADD_(r8, vz, SIMD_FMADD_(r7, vy, SIMD_MUL_(r6, vx))));
+		} // for
+	#endif
+		for(; i < end; ++ i) {
+			real_t vx = x[i], vy = y[i], vz = z[i];
+			out_x[i] = r[0] * vx + r[1] * vy + r[2] * vz;
+			out_y[i] = r[3] * vx + r[4] * vy + r[5] * vz;
+			out_z[i] = r[6] * vx + r[7] * vy + r[8] * vz;
+		} // for
+	} // mat_mul_3x1_soa()
+
+
+	/**
+	 * out_i = r_i x in_i for vectors [begin, end), with r[k][i] element k of matrix i
+	 */
+	static void mat_mul_3x1_soa(const real_t* const r[9], size_t begin, size_t end,
+					const real_t* x, const real_t* y, const real_t* z,
+					real_t* out_x, real_t* out_y, real_t* out_z) {
+		size_t i = begin;
+	#ifdef SIMD_LOAD_
+		for(; i + SIMD_WIDTH_ <= end; i += SIMD_WIDTH_) {
+			simd_real_t vx = SIMD_LOAD_(x + i), vy = SIMD_LOAD_(y + i), vz = SIMD_LOAD_(z + i);
+			simd_real_t ox = SIMD_MUL_(SIMD_LOAD_(r[0] + i), vx);
+			simd_real_t oy = SIMD_MUL_(SIMD_LOAD_(r[3] + i), vx);
+			simd_real_t oz = SIMD_MUL_(SIMD_LOAD_(r[6] + i), vx);
+			ox = SIMD_FMADD_(SIMD_LOAD_(r[1] + i), vy, ox);
+			oy = SIMD_FMADD_(SIMD_LOAD_(r[4] + i), vy, oy);
+			oz = SIMD_FMADD_(SIMD_LOAD_(r[7] + i), vy, oz);
+			SIMD_STORE_(out_x + i, SIMD_FMADD_(SIMD_LOAD_(r[2] + i), vz, ox));
+			SIMD_STORE_(out_y + i, SIMD_FMADD_(SIMD_LOAD_(r[5] + i), vz, oy));
+			SIMD_STORE_(out_z + i, SIMD_FMADD_(SIMD_LOAD_(r[8] + i), vz, oz));
+		} // for
+	#endif
+		for(; i < end; ++ i) {
+			real_t vx = x[i], vy = y[i], vz = z[i];
+			out_x[i] = r[0][i] * vx + r[1][i] * vy + r[2][i] * vz;
+			out_y[i] = r[3][i] * vx + r[4][i] * vy + r[5][i] * vz;
+			out_z[i] = r[6][i] * vx + r[7][i] * vy + r[8][i] * vz;
+		} // for
+	} // mat_mul_3x1_soa()
+
+
+	/**
+	 * batched matrix vector product of a 3x3 matrix with n vectors stored as
+	 * separate x, y and z arrays:
+	 * out_x[i]   r11 r12 r13   x[i]
+	 * out_y[i] = r21 r22 r23 x y[i]
+	 * out_z[i]   r31 r32 r33   z[i]
+	 * the output arrays may be the input arrays. nothing is allocated
+	 */
+	bool mat_mul_3x1_batch(const matrix3x3_t& r, size_t n,
+					const real_t* x, const real_t* y, const real_t* z,
+					real_t* out_x, real_t* out_y, real_t* out_z) {
+		if(x == NULL || y == NULL || z == NULL || out_x == NULL || out_y == NULL || out_z == NULL) {
+			std::cerr << "error: null vector arrays in batched matrix vector product" << std::endl;
+			return false;
+		} // if
+		real_t rm[9];
+		for(int i = 0; i < 3; ++ i)
+			for(int j = 0; j < 3; ++ j) rm[3 * i + j] = r.mat_[i][j];
+		size_t num_chunks = (n + BATCH_CHUNK_ - 1) / BATCH_CHUNK_;
+		#pragma omp parallel for schedule(static) if(num_chunks > 1)
+		for(size_t c = 0; c < num_chunks; ++ c) {
+			size_t begin = c * BATCH_CHUNK_, end = std::min(n, begin + BATCH_CHUNK_);
+			mat_mul_3x1_soa(rm, begin, end, x, y, z, out_x, out_y, out_z);
+		} // for
+		return true;
+	} // mat_mul_3x1_batch()
+
+
+	/**
+	 * batched matrix vector product with a different matrix for each vector.
+	 * the matrices are stored as structure-of-arrays too: r[3 * j + k][i] is
+	 * element (j, k) of the matrix applied to vector i
+	 */
+	bool mat_mul_3x1_batch(const real_t* const r[9], size_t n,
+					const real_t* x, const real_t* y, const real_t* z,
+					real_t* out_x, real_t* out_y, real_t* out_z) {
+		if(x == NULL || y == NULL || z == NULL || out_x == NULL || out_y == NULL || out_z == NULL) {
+			std::cerr << "error: null vector arrays in batched matrix vector product" << std::endl;
+			return false;
+		} // if
+		for(int k = 0; k < 9; ++ k) {
+			if(r[k] == NULL) {
+				std::cerr << "error: null matrix arrays in batched matrix vector product" << std::endl;
+				return false;
+			} // if
+		} // for
+		size_t num_chunks = (n + BATCH_CHUNK_ - 1) / BATCH_CHUNK_;
+		#pragma omp parallel for schedule(static) if(num_chunks > 1)
+		for(size_t c = 0; c < num_chunks; ++ c) {
+			size_t begin = c * BATCH_CHUNK_, end = std::min(n, begin + BATCH_CHUNK_);
+			mat_mul_3x1_soa(r, begin, end, x, y, z, out_x, out_y, out_z);
+		} // for
+		return true;
+	} // mat_mul_3x1_batch()
+
+
+	/**
+	 * apply each of num_mats matrices to all n vectors. the result of matrix m is
+	 * stored at [m * n, (m + 1) * n) of the output arrays. each chunk of vectors
+	 * is read once and transformed by all the matrices while it is in cache
+	 */
+	bool mat_mul_3x1_batch(unsigned int num_mats, const matrix3x3_t* r, size_t n,
+					const real_t* x, const real_t* y, const real_t* z,
+					real_t* out_x, real_t* out_y, real_t* out_z) {
+		if(r == NULL || x == NULL || y == NULL || z == NULL
+				|| out_x == NULL || out_y == NULL || out_z == NULL) {
+			std::cerr << "error: null arrays in batched matrix vector product" << std::endl;
+			return false;
+		} // if
+		size_t num_chunks = (n + BATCH_CHUNK_ - 1) / BATCH_CHUNK_;
+		#pragma omp parallel for schedule(static) if(num_chunks * num_mats > 1)
+		for(size_t c = 0; c < num_chunks; ++ c) {
+			size_t begin = c * BATCH_CHUNK_, end = std::min(n, begin + BATCH_CHUNK_);
+			for(unsigned int m = 0; m < num_mats; ++ m) {
+				real_t rm[9];
+				for(int i = 0; i < 3; ++ i)
+					for(int j = 0; j < 3; ++ j) rm[3 * i + j] = r[m].mat_[i][j];
+				size_t offset = m * n;
+				mat_mul_3x1_soa(rm, begin, end, x, y, z, out_x + offset, out_y + offset, out_z + offset);
+			} // for
+		} // for
+		return true;
+	} // mat_mul_3x1_batch()
+
+
 	/**
 	 * specialized floor function
 	 */
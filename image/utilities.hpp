@@ -175,6 +175,31 @@ namespace stock {
 	 */
 	extern bool mat_mul_3x1(vector3_t a, vector3_t b, vector3_t c, vector3_t d, vector3_t& x);
 
+	/** batched matrix vector product of a 3x3 matrix with n vectors stored as
+	 * separate x, y and z arrays (structure of arrays):
+	 * out_x[i]   r11 r12 r13   x[i]
+	 * out_y[i] = r21 r22 r23 x y[i]
+	 * out_z[i]   r31 r32 r33   z[i]
+	 * the output arrays may be the input arrays. uses SIMD and OpenMP, and does not allocate
+	 */
+	extern bool mat_mul_3x1_batch(const matrix3x3_t& r, size_t n,
+					const real_t* x, const real_t* y, const real_t* z,
+					real_t* out_x, real_t* out_y, real_t* out_z);
+
+	/** batched matrix vector product with a different matrix for each of the n vectors.
+	 * r[3 * j + k] is an array of n values, element (j, k) of each matrix
+	 */
+	extern bool mat_mul_3x1_batch(const real_t* const r[9], size_t n,
+					const real_t* x, const real_t* y, const real_t* z,
+					real_t* out_x, real_t* out_y, real_t* out_z);
+
+	/** apply each of num_mats matrices to all n vectors. the output arrays hold
+	 * num_mats * n values, the results of matrix m starting at m * n
+	 */
+	extern bool mat_mul_3x1_batch(unsigned int num_mats, const matrix3x3_t* r, size_t n,
+					const real_t* x, const real_t* y, const real_t* z,
+					real_t* out_x, real_t* out_y, real_t* out_z);
+
 	extern complex_t integral_e(real_t, real_t, complex_t);
 	extern complex_t integral_xe(real_t, real_t, real_t, real_t, complex_t);
 
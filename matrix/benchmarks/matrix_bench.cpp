@@ -0,0 +1,421 @@
+/**
+ *  Project: The Stock Libraries
+ *
+ *  File: matrix_bench.cpp
+ *  Created: Oct 18, 2026
+ *
+ *  Author: Abhinav Sarje <abhinav.sarje@gmail.com>
+ *
+ *  Copyright (c) 2012-2017 Abhinav Sarje
+ *  Distributed under the Boost Software License.
+ *  See accompanying LICENSE file.
+ */
+
+/* microbenchmarks of Matrix2D operations over a sweep of matrix sizes, from L1 resident
+ * to DRAM resident, and over a list of thread counts. reports ns per element, GB/s and
+ * the speedup over the first thread count, as a table or as csv to diff between versions.
+ *
+ * build:	g++ -O3 -march=native -fopenmp -I../.. matrix_bench.cpp -o matrix_bench
+ * usage:	matrix_bench [--csv] [--threads 1,2,4] [--max-bytes bytes] [--min-time sec] [--filter name]
+ */
+
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <string>
+#include <vector>
+#include <time.h>
+#include <unistd.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+#include "../matrix.hpp"
+
+using namespace stock;
+
+typedef double bench_t;
+
+volatile double bench_sink_ = 0.0;		// keeps results of read-only benchmarks alive
+
+
+// ////
+// monotonic time in seconds
+// ////
+double bench_now() {
+	struct timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec + ts.tv_nsec * 1e-9;
+} // bench_now()
+
+
+/* a benchmarked operation. setup() is not timed. operations which change the matrix
+ * shape return true from resets(), and are set up again before every timed run */
+class MatrixBenchmark {
+	public:
+		virtual ~MatrixBenchmark() { }
+
+		virtual const char* name() const = 0;
+		virtual const char* layout() const = 0;
+		virtual void setup(size_t rows, size_t cols) = 0;
+		virtual void run() = 0;
+		virtual double elements() const = 0;		// elements processed by one run
+		virtual double bytes() const = 0;			// bytes read and written by one run
+		virtual size_t operands() const { return 1; }	// matrices of the given size in use
+		virtual bool resets() const { return false; }
+		virtual size_t side(size_t n) const { return n; }	// matrix side used for a sweep size n
+}; // class MatrixBenchmark
+
+
+template <typename layout_t>
+const char* layout_name() { return (layout_t::kind == layout_row_major) ? "row_major" : "column_major"; }
+
+
+/* fill() */
+template <typename layout_t>
+class FillBenchmark : public MatrixBenchmark {
+	private:
+		Matrix2D<bench_t, layout_t> mat_;
+		bench_t value_;
+
+	public:
+		FillBenchmark(): mat_(1, 1), value_(0) { }
+		const char* name() const { return "fill"; }
+		const char* layout() const { return layout_name<layout_t>(); }
+		void setup(size_t rows, size_t cols) { mat_.resize(rows, cols); }
+		void run() { mat_.fill(value_ += 1); }
+		double elements() const { return (double) mat_.size(); }
+		double bytes() const { return (double) mat_.size() * sizeof(bench_t); }
+}; // class FillBenchmark
+
+
+/* matrix_add() */
+template <typename layout_t>
+class AddBenchmark : public MatrixBenchmark {
+	private:
+		Matrix2D<bench_t, layout_t> a_, b_, c_;
+
+	public:
+		AddBenchmark(): a_(1, 1), b_(1, 1), c_(1, 1) { }
+		const char* name() const { return "matrix_add"; }
+		const char* layout() const { return layout_name<layout_t>(); }
+		void setup(size_t rows, size_t cols) {
+			a_.resize(rows, cols); b_.resize(rows, cols); c_.resize(rows, cols);
+			a_.fill(1); b_.fill(2);
+		} // setup()
+		void run() { matrix_add(a_, b_, c_); }
+		double elements() const { return (double) c_.size(); }
+		double bytes() const { return 3.0 * c_.size() * sizeof(bench_t); }
+		size_t operands() const { return 3; }
+}; // class AddBenchmark
+
+
+/* matrix_min_max() */
+template <typename layout_t>
+class MinMaxBenchmark : public MatrixBenchmark {
+	private:
+		Matrix2D<bench_t, layout_t> mat_;
+
+	public:
+		MinMaxBenchmark(): mat_(1, 1) { }
+		const char* name() const { return "matrix_min_max"; }
+		const char* layout() const { return layout_name<layout_t>(); }
+		void setup(size_t rows, size_t cols) {
+			mat_.resize(rows, cols);
+			for(size_t k = 0; k < mat_.size(); ++ k) mat_[k] = (bench_t) ((k * 7919) % 1000);
+		} // setup()
+		void run() {
+			bench_t mn = 0, mx = 0;
+			matrix_min_max(mat_, mn, mx);
+			bench_sink_ += mx - mn;
+		} // run()
+		double elements() const { return (double) mat_.size(); }
+		double bytes() const { return (double) mat_.size() * sizeof(bench_t); }
+}; // class MinMaxBenchmark
+
+
+/* sum of all elements by one of several traversals, parallel over the outer loop:
+ * row iterators, raw pointer over the buffer, (i, j) in row order, (i, j) in column order */
+enum SumTraversal { sum_iterator, sum_pointer, sum_row_order, sum_column_order };
+
+template <typename layout_t, SumTraversal TRAVERSAL>
+class SumBenchmark : public MatrixBenchmark {
+	private:
+		Matrix2D<bench_t, layout_t> mat_;
+
+	public:
+		SumBenchmark(): mat_(1, 1) { }
+		const char* name() const {
+			switch(TRAVERSAL) {
+				case sum_iterator: return "sum_iterator";
+				case sum_pointer: return "sum_pointer";
+				case sum_row_order: return "sum_row_order";
+				default: return "sum_column_order";
+			} // switch
+		} // name()
+		const char* layout() const { return layout_name<layout_t>(); }
+		void setup(size_t rows, size_t cols) { mat_.resize(rows, cols); mat_.fill(1); }
+		void run() {
+			const Matrix2D<bench_t, layout_t>& mat = mat_;
+			long rows = mat.num_rows(), cols = mat.num_cols();
+			double sum = 0.0;
+			if(TRAVERSAL == sum_iterator) {
+				// row() exposes the buffer, which writes the matrix: take the iterators serially
+				std::vector<typename Matrix2D<bench_t, layout_t>::row_iterator> row_its(rows);
+				for(long i = 0; i < rows; ++ i) row_its[i] = mat_.row(i);
+				#pragma omp parallel for schedule(static) reduction(+:sum)
+				for(long i = 0; i < rows; ++ i) {
+					typename Matrix2D<bench_t, layout_t>::row_iterator r = row_its[i];
+					for(long j = 0; j < cols; ++ j) sum += r[j];
+				} // for
+			} else if(TRAVERSAL == sum_pointer) {
+				const bench_t* data = mat.data();
+				long num = rows * cols;
+				#pragma omp parallel for schedule(static) reduction(+:sum)
+				for(long k = 0; k < num; ++ k) sum += data[k];
+			} else if(TRAVERSAL == sum_row_order) {
+				#pragma omp parallel for schedule(static) reduction(+:sum)
+				for(long i = 0; i < rows; ++ i)
+					for(long j = 0; j < cols; ++ j) sum += mat(i, j);
+			} else {
+				#pragma omp parallel for schedule(static) reduction(+:sum)
+				for(long j = 0; j < cols; ++ j)
+					for(long i = 0; i < rows; ++ i) sum += mat(i, j);
+			} // if-else
+			bench_sink_ += sum;
+		} // run()
+		double elements() const { return (double) mat_.size(); }
+		double bytes() const { return (double) mat_.size() * sizeof(bench_t); }
+}; // class SumBenchmark
+
+
+/* column order walk of a row-major matrix whose dimensions are rounded down to a power
+ * of two, the worst case for cache-set aliasing, with and without padded rows */
+template <MatrixPadding PADDING>
+class ColumnWalkBenchmark : public MatrixBenchmark {
+	private:
+		Matrix2D<bench_t> mat_;
+
+	public:
+		ColumnWalkBenchmark(): mat_(1, 1, PADDING) { }
+		const char* name() const { return (PADDING == padding_none) ? "col_walk" : "col_walk_padded"; }
+		const char* layout() const { return layout_name<RowMajor>(); }
+		void setup(size_t rows, size_t cols) { mat_.resize(rows, cols); mat_.fill(1); }
+		void run() {
+			long rows = mat_.num_rows(), cols = mat_.num_cols();
+			double sum = 0.0;
+			#pragma omp parallel for schedule(static) reduction(+:sum)
+			for(long j = 0; j < cols; ++ j) {
+				Matrix2D<bench_t>::col_iterator c = mat_.column(j);
+				for(long i = 0; i < rows; ++ i) sum += c[i];
+			} // for
+			bench_sink_ += sum;
+		} // run()
+		double elements() const { return (double) mat_.size(); }
+		double bytes() const { return (double) mat_.size() * sizeof(bench_t); }
+		size_t side(size_t n) const {
+			size_t p = 1;
+			while(2 * p <= n) p *= 2;
+			return p;
+		} // side()
+}; // class ColumnWalkBenchmark
+
+
+/* insert_row() in the middle of the matrix, capacity reserved beforehand */
+template <typename layout_t>
+class InsertRowBenchmark : public MatrixBenchmark {
+	private:
+		static const size_t INSERTS_ = 8;
+		Matrix2D<bench_t, layout_t> mat_;
+		std::vector<bench_t> row_;
+		size_t rows_, cols_;
+
+	public:
+		InsertRowBenchmark(): mat_(1, 1), rows_(0), cols_(0) { }
+		const char* name() const { return "insert_row"; }
+		const char* layout() const { return layout_name<layout_t>(); }
+		void setup(size_t rows, size_t cols) {
+			rows_ = rows; cols_ = cols;
+			mat_.resize(rows, cols);
+			mat_.reserve_rows(rows + INSERTS_);
+			row_.assign(cols, 1);
+		} // setup()
+		void run() {
+			for(size_t k = 0; k < INSERTS_; ++ k) mat_.insert_row(mat_.num_rows() / 2, &row_[0], cols_);
+		} // run()
+		// elements moved: about half of the matrix per insertion
+		double elements() const { return (double) INSERTS_ * (rows_ / 2 + 1) * cols_; }
+		double bytes() const { return 2.0 * elements() * sizeof(bench_t); }
+		bool resets() const { return true; }
+}; // class InsertRowBenchmark
+
+
+/* incr_columns(): every row is moved */
+template <typename layout_t>
+class IncrColumnsBenchmark : public MatrixBenchmark {
+	private:
+		static const size_t INCREMENTS_ = 2;
+		Matrix2D<bench_t, layout_t> mat_;
+		size_t rows_, cols_;
+
+	public:
+		IncrColumnsBenchmark(): mat_(1, 1), rows_(0), cols_(0) { }
+		const char* name() const { return "incr_columns"; }
+		const char* layout() const { return layout_name<layout_t>(); }
+		void setup(size_t rows, size_t cols) {
+			rows_ = rows; cols_ = cols;
+			mat_.resize(rows, cols);
+			mat_.reserve_cols(cols + INCREMENTS_);
+		} // setup()
+		void run() {
+			for(size_t k = 0; k < INCREMENTS_; ++ k) mat_.incr_columns(1);
+		} // run()
+		double elements() const { return (double) INCREMENTS_ * rows_ * cols_; }
+		double bytes() const { return 2.0 * elements() * sizeof(bench_t); }
+		bool resets() const { return true; }
+}; // class IncrColumnsBenchmark
+
+
+// ////
+// time a benchmark for at least min_time seconds, returns seconds per run
+// ////
+double bench_time(MatrixBenchmark& bench, size_t rows, size_t cols, double min_time, size_t& reps) {
+	bench.setup(rows, cols);
+	bench.run();			// warm up
+	double total = 0.0;
+	reps = 0;
+	if(bench.resets()) {
+		while(total < min_time) {
+			bench.setup(rows, cols);
+			double start = bench_now();
+			bench.run();
+			total += bench_now() - start;
+			++ reps;
+		} // while
+		return total / reps;
+	} // if
+	size_t batch = 1;
+	while(total < min_time) {
+		double start = bench_now();
+		for(size_t r = 0; r < batch; ++ r) bench.run();
+		total += bench_now() - start;
+		reps += batch;
+		batch *= 2;
+	} // while
+	return total / reps;
+} // bench_time()
+
+
+// ////
+// lowest cache level which holds the working set
+// ////
+const char* bench_residency(size_t bytes) {
+	long l1 = -1, l2 = -1, l3 = -1;
+	#ifdef _SC_LEVEL1_DCACHE_SIZE
+	l1 = sysconf(_SC_LEVEL1_DCACHE_SIZE);
+	l2 = sysconf(_SC_LEVEL2_CACHE_SIZE);
+	l3 = sysconf(_SC_LEVEL3_CACHE_SIZE);
+	#endif
+	if(l1 > 0 && bytes <= (size_t) l1) return "L1";
+	if(l2 > 0 && bytes <= (size_t) l2) return "L2";
+	if(l3 > 0 && bytes <= (size_t) l3) return "L3";
+	return "DRAM";
+} // bench_residency()
+
+
+// ////
+// parse a comma separated list of thread counts
+// ////
+std::vector<int> bench_thread_list(const char* list) {
+	std::vector<int> threads;
+	std::string s(list);
+	size_t pos = 0;
+	while(pos < s.size()) {
+		size_t next = s.find(',', pos);
+		if(next == std::string::npos) next = s.size();
+		int t = atoi(s.substr(pos, next - pos).c_str());
+		if(t > 0) threads.push_back(t);
+		pos = next + 1;
+	} // while
+	return threads;
+} // bench_thread_list()
+
+
+int main(int narg, char** args) {
+	bool csv = false;
+	double min_time = 0.2;
+	size_t max_bytes = std::min(std::max(bulk_streaming_bytes() * 4, (size_t) 64 << 20), (size_t) 256 << 20);
+	std::string filter;
+	std::vector<int> threads;
+	for(int i = 1; i < narg; ++ i) {
+		if(strcmp(args[i], "--csv") == 0) csv = true;
+		else if(strcmp(args[i], "--threads") == 0 && i + 1 < narg) threads = bench_thread_list(args[++ i]);
+		else if(strcmp(args[i], "--max-bytes") == 0 && i + 1 < narg) max_bytes = strtoull(args[++ i], NULL, 10);
+		else if(strcmp(args[i], "--min-time") == 0 && i + 1 < narg) min_time = atof(args[++ i]);
+		else if(strcmp(args[i], "--filter") == 0 && i + 1 < narg) filter = args[++ i];
+		else {
+			std::cerr << "usage: " << args[0] << " [--csv] [--threads 1,2,4] [--max-bytes bytes]"
+						<< " [--min-time sec] [--filter name]" << std::endl;
+			return 1;
+		} // if-else
+	} // for
+	if(threads.empty()) {
+		int max_threads = 1;
+		#ifdef _OPENMP
+		max_threads = omp_get_max_threads();
+		#endif
+		for(int t = 1; t < max_threads; t *= 2) threads.push_back(t);
+		threads.push_back(max_threads);
+	} // if
+
+	std::vector<MatrixBenchmark*> benchmarks;
+	benchmarks.push_back(new FillBenchmark<RowMajor>());
+	benchmarks.push_back(new AddBenchmark<RowMajor>());
+	benchmarks.push_back(new MinMaxBenchmark<RowMajor>());
+	benchmarks.push_back(new SumBenchmark<RowMajor, sum_pointer>());
+	benchmarks.push_back(new SumBenchmark<RowMajor, sum_iterator>());
+	benchmarks.push_back(new SumBenchmark<RowMajor, sum_row_order>());
+	benchmarks.push_back(new SumBenchmark<RowMajor, sum_column_order>());
+	benchmarks.push_back(new SumBenchmark<ColumnMajor, sum_row_order>());
+	benchmarks.push_back(new SumBenchmark<ColumnMajor, sum_column_order>());
+	benchmarks.push_back(new ColumnWalkBenchmark<padding_none>());
+	benchmarks.push_back(new ColumnWalkBenchmark<padding_auto>());
+	benchmarks.push_back(new InsertRowBenchmark<RowMajor>());
+	benchmarks.push_back(new IncrColumnsBenchmark<RowMajor>());
+
+	if(csv) printf("benchmark,layout,rows,cols,bytes,resident,threads,reps,ns_per_element,gb_per_sec,speedup\n");
+	else printf("%-16s %-12s %6s %6s %10s %5s %7s %10s %9s %8s\n", "benchmark", "layout",
+				"rows", "cols", "bytes", "res", "threads", "ns/elem", "GB/s", "speedup");
+
+	// square matrices of 16 KB, 64 KB, ... up to max_bytes each
+	for(size_t b = 0; b < benchmarks.size(); ++ b) {
+		MatrixBenchmark& bench = *benchmarks[b];
+		if(!filter.empty() && filter != bench.name()) continue;
+		for(size_t bytes = (size_t) 16 << 10; bytes <= max_bytes; bytes *= 4) {
+			size_t n = bench.side((size_t) std::sqrt((double) bytes / sizeof(bench_t)));
+			size_t working_set = n * n * sizeof(bench_t) * bench.operands();
+			double base_time = 0.0;
+			for(size_t t = 0; t < threads.size(); ++ t) {
+				#ifdef _OPENMP
+				omp_set_num_threads(threads[t]);
+				#endif
+				size_t reps = 0;
+				double sec = bench_time(bench, n, n, min_time, reps);
+				if(t == 0) base_time = sec;
+				double ns = sec * 1e9 / bench.elements();
+				double gbs = bench.bytes() / sec * 1e-9;
+				if(csv) printf("%s,%s,%zu,%zu,%zu,%s,%d,%zu,%.4f,%.3f,%.3f\n", bench.name(), bench.layout(),
+								n, n, n * n * sizeof(bench_t), bench_residency(working_set), threads[t], reps,
+								ns, gbs, base_time / sec);
+				else printf("%-16s %-12s %6zu %6zu %10zu %5s %7d %10.4f %9.3f %8.2f\n", bench.name(), bench.layout(),
+								n, n, n * n * sizeof(bench_t), bench_residency(working_set), threads[t],
+								ns, gbs, base_time / sec);
+				fflush(stdout);
+			} // for
+		} // for
+	} // for
+
+	for(size_t b = 0; b < benchmarks.size(); ++ b) delete benchmarks[b];
+	return 0;
+} // main()
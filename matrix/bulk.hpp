@@ -0,0 +1,332 @@
+/**
+ *  Project: The Stock Libraries
+ *
+ *  File: bulk.hpp
+ *  Created: Oct 18, 2026
+ *
+ *  Author: Abhinav Sarje <abhinav.sarje@gmail.com>
+ *
+ *  Copyright (c) 2012-2017 Abhinav Sarje
+ *  Distributed under the Boost Software License.
+ *  See accompanying LICENSE file.
+ */
+
+#ifndef __BULK_HPP__
+#define __BULK_HPP__
+
+#include <cstring>
+#include <cstddef>
+#include <algorithm>
+#include <unistd.h>
+#include <stdint.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+#ifdef __SSE2__
+#include <immintrin.h>
+#endif
+
+namespace stock {
+
+	/* bulk initialization and copy of buffers: zero, fill, copy, strided copy.
+	 * large buffers are split into one contiguous chunk per thread: the chunks of a static omp
+	 * schedule over the elements, with their boundaries moved up to cache lines so threads never
+	 * share a line. buffers larger than the last level cache are written with non-temporal
+	 * stores, which do not read the destination lines first and do not evict data that is still
+	 * in use. */
+
+	const size_t BULK_PARALLEL_BYTES_ = 1 << 18;	// smaller buffers are handled by one thread
+	const size_t BULK_LINE_ = 64;					// cache line, in bytes
+
+	// ////
+	// size of the last level cache, 8 MB when it is not known
+	// ////
+	inline size_t bulk_default_streaming_bytes() {
+		long llc = -1;
+		#ifdef _SC_LEVEL3_CACHE_SIZE
+		llc = sysconf(_SC_LEVEL3_CACHE_SIZE);
+		if(llc <= 0) llc = sysconf(_SC_LEVEL2_CACHE_SIZE);
+		#endif
+		return (llc > 0) ? (size_t) llc : ((size_t) 8 << 20);
+	} // bulk_default_streaming_bytes()
+
+	// ////
+	// buffers of at least this many bytes are written with non-temporal stores.
+	// defaults to the size of the last level cache. the value is set by its static
+	// initializer, so threads using it for the first time do not race
+	// ////
+	inline size_t& bulk_streaming_bytes() {
+		static size_t bytes = bulk_default_streaming_bytes();
+		return bytes;
+	} // bulk_streaming_bytes()
+
+	// ////
+	// change the size above which stores are non-temporal, 0 restores the default.
+	// not to be called while other threads are copying
+	// ////
+	inline void set_bulk_streaming_bytes(size_t bytes) {
+		bulk_streaming_bytes() = (bytes == 0) ? bulk_default_streaming_bytes() : bytes;
+	} // set_bulk_streaming_bytes()
+
+
+	// ////
+	// element range [begin, end) of part p out of parts for num elements of elem_size bytes at base.
+	// the first num % parts parts get one element more, as in the static omp schedule of libgomp.
+	// boundaries are then moved up to cache lines when lines start on element boundaries
+	// ////
+	inline void bulk_split(const void* base, size_t num, size_t elem_size, size_t p, size_t parts,
+							size_t& begin, size_t& end) {
+		uintptr_t addr = (uintptr_t) base;
+		bool on_lines = (BULK_LINE_ % elem_size == 0) && (addr % elem_size == 0);
+		size_t bound[2];
+		for(int b = 0; b < 2; ++ b) {
+			size_t q = p + b;
+			size_t i = (q >= parts) ? num : (num / parts) * q + std::min(q, num % parts);
+			if(on_lines && q > 0 && q < parts) {
+				uintptr_t at = addr + i * elem_size;
+				at = (at + BULK_LINE_ - 1) & ~((uintptr_t) BULK_LINE_ - 1);
+				i = std::min(num, (size_t) (at - addr) / elem_size);
+			} // if
+			bound[b] = i;
+		} // for
+		begin = bound[0];
+		end = bound[1];
+	} // bulk_split()
+
+	// ////
+	// range of the calling thread inside a parallel region
+	// ////
+	inline void bulk_thread_range(const void* base, size_t num, size_t elem_size, size_t& begin, size_t& end) {
+		size_t parts = 1, p = 0;
+		#ifdef _OPENMP
+		parts = omp_get_num_threads();
+		p = omp_get_thread_num();
+		#endif
+		bulk_split(base, num, elem_size, p, parts, begin, end);
+	} // bulk_thread_range()
+
+
+	// ////
+	// write bytes whole cache lines from the 64 byte pattern at line to dst, which is line aligned,
+	// bypassing the cache
+	// ////
+	inline void bulk_stream_lines(char* dst, const char* line, size_t bytes) {
+	#if defined(__AVX512F__)
+		__m512i v = _mm512_loadu_si512((const void*) line);
+		for(size_t i = 0; i < bytes; i += BULK_LINE_) _mm512_stream_si512((__m512i*) (dst + i), v);
+		_mm_sfence();
+	#elif defined(__AVX__)
+		__m256i v0 = _mm256_loadu_si256((const __m256i*) line);
+		__m256i v1 = _mm256_loadu_si256((const __m256i*) (line + 32));
+		for(size_t i = 0; i < bytes; i += BULK_LINE_) {
+			_mm256_stream_si256((__m256i*) (dst + i), v0);
+			_mm256_stream_si256((__m256i*) (dst + i + 32), v1);
+		} // for
+		_mm_sfence();
+	#elif defined(__SSE2__)
+		__m128i v0 = _mm_loadu_si128((const __m128i*) line);
+		__m128i v1 = _mm_loadu_si128((const __m128i*) (line + 16));
+		__m128i v2 = _mm_loadu_si128((const __m128i*) (line + 32));
+		__m128i v3 = _mm_loadu_si128((const __m128i*) (line + 48));
+		for(size_t i = 0; i < bytes; i += BULK_LINE_) {
+			_mm_stream_si128((__m128i*) (dst + i), v0);
+			_mm_stream_si128((__m128i*) (dst + i + 16), v1);
+			_mm_stream_si128((__m128i*) (dst + i + 32), v2);
+			_mm_stream_si128((__m128i*) (dst + i + 48), v3);
+		} // for
+		_mm_sfence();
+	#else
+		for(size_t i = 0; i < bytes; i += BULK_LINE_) memcpy(dst + i, line, BULK_LINE_);
+	#endif
+	} // bulk_stream_lines()
+
+	// ////
+	// copy bytes whole cache lines from src to dst, which is line aligned, bypassing the cache
+	// ////
+	inline void bulk_stream_copy_lines(char* dst, const char* src, size_t bytes) {
+	#if defined(__AVX512F__)
+		for(size_t i = 0; i < bytes; i += BULK_LINE_)
+			_mm512_stream_si512((__m512i*) (dst + i), _mm512_loadu_si512((const void*) (src + i)));
+		_mm_sfence();
+	#elif defined(__AVX__)
+		for(size_t i = 0; i < bytes; i += BULK_LINE_) {
+			__m256i v0 = _mm256_loadu_si256((const __m256i*) (src + i));
+			__m256i v1 = _mm256_loadu_si256((const __m256i*) (src + i + 32));
+			_mm256_stream_si256((__m256i*) (dst + i), v0);
+			_mm256_stream_si256((__m256i*) (dst + i + 32), v1);
+		} // for
+		_mm_sfence();
+	#elif defined(__SSE2__)
+		for(size_t i = 0; i < bytes; i += BULK_LINE_) {
+			for(size_t j = 0; j < BULK_LINE_; j += 16)
+				_mm_stream_si128((__m128i*) (dst + i + j), _mm_loadu_si128((const __m128i*) (src + i + j)));
+		} // for
+		_mm_sfence();
+	#else
+		memcpy(dst, src, bytes);
+	#endif
+	} // bulk_stream_copy_lines()
+
+	// ////
+	// copy bytes from src to dst with non-temporal stores for the line aligned part of dst
+	// ////
+	inline void bulk_stream_copy(char* dst, const char* src, size_t bytes) {
+		size_t head = (BULK_LINE_ - (uintptr_t) dst % BULK_LINE_) % BULK_LINE_;
+		if(head >= bytes) {
+			memcpy(dst, src, bytes);
+			return;
+		} // if
+		size_t body = (bytes - head) / BULK_LINE_ * BULK_LINE_;
+		memcpy(dst, src, head);
+		bulk_stream_copy_lines(dst + head, src + head, body);
+		memcpy(dst + head + body, src + head + body, bytes - head - body);
+	} // bulk_stream_copy()
+
+
+	// ////
+	// fill elements [begin, end) of dst with val. with stream set the line aligned part is
+	// written with non-temporal stores, when lines hold whole elements
+	// ////
+	template <typename value_type>
+	inline void bulk_fill_range(value_type* dst, size_t begin, size_t end, const value_type& val, bool stream) {
+		const size_t elem = sizeof(value_type);
+		if(!stream || BULK_LINE_ % elem != 0 || (uintptr_t) dst % elem != 0) {
+			std::fill(dst + begin, dst + end, val);
+			return;
+		} // if
+		size_t first = begin;
+		while(first < end && (uintptr_t) (dst + first) % BULK_LINE_ != 0) ++ first;
+		size_t lines = (end - first) * elem / BULK_LINE_;
+		size_t last = first + lines * BULK_LINE_ / elem;
+		std::fill(dst + begin, dst + first, val);
+		if(lines > 0) {
+			value_type line[(BULK_LINE_ + sizeof(value_type) - 1) / sizeof(value_type)];
+			std::fill(line, line + BULK_LINE_ / elem, val);
+			bulk_stream_lines((char*) (dst + first), (const char*) line, lines * BULK_LINE_);
+		} // if
+		std::fill(dst + last, dst + end, val);
+	} // bulk_fill_range()
+
+	// ////
+	// whether all bytes of val are zero
+	// ////
+	template <typename value_type>
+	inline bool bulk_is_zero(const value_type& val) {
+		const char* bytes = (const char*) &val;
+		for(size_t i = 0; i < sizeof(value_type); ++ i) if(bytes[i] != 0) return false;
+		return true;
+	} // bulk_is_zero()
+
+
+	// ////
+	// zero bytes at dst
+	// ////
+	inline void bulk_zero(void* dst, size_t bytes) {
+		if(bytes == 0) return;
+		static const char zero_line[BULK_LINE_] = { 0 };
+		bool stream = (bytes >= bulk_streaming_bytes());
+		if(bytes < BULK_PARALLEL_BYTES_) {
+			memset(dst, 0, bytes);
+			return;
+		} // if
+		#pragma omp parallel
+		{
+			size_t begin, end;
+			bulk_thread_range(dst, bytes, 1, begin, end);
+			char* d = (char*) dst + begin;
+			if(stream) {
+				size_t head = std::min(end - begin, (BULK_LINE_ - (uintptr_t) d % BULK_LINE_) % BULK_LINE_);
+				size_t body = (end - begin - head) / BULK_LINE_ * BULK_LINE_;
+				memset(d, 0, head);
+				bulk_stream_lines(d + head, zero_line, body);
+				memset(d + head + body, 0, end - begin - head - body);
+			} else {
+				memset(d, 0, end - begin);
+			} // if-else
+		}
+	} // bulk_zero()
+
+	// ////
+	// copy bytes from src to dst, which do not overlap
+	// ////
+	inline void bulk_copy(void* dst, const void* src, size_t bytes) {
+		if(bytes == 0 || dst == src) return;
+		bool stream = (bytes >= bulk_streaming_bytes());
+		if(bytes < BULK_PARALLEL_BYTES_) {
+			memcpy(dst, src, bytes);
+			return;
+		} // if
+		#pragma omp parallel
+		{
+			size_t begin, end;
+			bulk_thread_range(dst, bytes, 1, begin, end);
+			if(stream) bulk_stream_copy((char*) dst + begin, (const char*) src + begin, end - begin);
+			else memcpy((char*) dst + begin, (const char*) src + begin, end - begin);
+		}
+	} // bulk_copy()
+
+	// ////
+	// set num elements at dst to val
+	// ////
+	template <typename value_type>
+	void bulk_fill(value_type* dst, size_t num, const value_type& val) {
+		if(num == 0) return;
+		if(bulk_is_zero(val)) {
+			bulk_zero(dst, num * sizeof(value_type));
+			return;
+		} // if
+		size_t bytes = num * sizeof(value_type);
+		bool stream = (bytes >= bulk_streaming_bytes());
+		if(bytes < BULK_PARALLEL_BYTES_) {
+			std::fill(dst, dst + num, val);
+			return;
+		} // if
+		#pragma omp parallel
+		{
+			size_t begin, end;
+			bulk_thread_range(dst, num, sizeof(value_type), begin, end);
+			bulk_fill_range(dst, begin, end, val, stream);
+		}
+	} // bulk_fill()
+
+	// ////
+	// copy num elements from src to dst, consecutive elements being src_stride and dst_stride
+	// elements apart, strides may be negative. unit strides are a plain copy
+	// ////
+	template <typename value_type>
+	void bulk_copy_strided(value_type* dst, ptrdiff_t dst_stride,
+							const value_type* src, ptrdiff_t src_stride, size_t num) {
+		if(dst_stride == 1 && src_stride == 1) {
+			bulk_copy(dst, src, num * sizeof(value_type));
+			return;
+		} // if
+		bool parallel = (num * sizeof(value_type) >= BULK_PARALLEL_BYTES_);
+		#pragma omp parallel for schedule(static) if(parallel)
+		for(ptrdiff_t i = 0; i < (ptrdiff_t) num; ++ i) dst[i * dst_stride] = src[i * src_stride];
+	} // bulk_copy_strided()
+
+	// ////
+	// copy a rows x cols block between buffers whose rows start dst_pitch and src_pitch
+	// elements apart. rows are copied whole by one thread each
+	// ////
+	template <typename value_type>
+	void bulk_copy_2d(value_type* dst, size_t dst_pitch, const value_type* src, size_t src_pitch,
+						size_t rows, size_t cols) {
+		if(dst_pitch == cols && src_pitch == cols) {
+			bulk_copy(dst, src, rows * cols * sizeof(value_type));
+			return;
+		} // if
+		size_t bytes = rows * cols * sizeof(value_type);
+		bool stream = (bytes >= bulk_streaming_bytes());
+		bool parallel = (bytes >= BULK_PARALLEL_BYTES_);
+		#pragma omp parallel for schedule(static) if(parallel)
+		for(size_t i = 0; i < rows; ++ i) {
+			if(stream) bulk_stream_copy((char*) (dst + i * dst_pitch), (const char*) (src + i * src_pitch),
+										cols * sizeof(value_type));
+			else memcpy(dst + i * dst_pitch, src + i * src_pitch, cols * sizeof(value_type));
+		} // for
+	} // bulk_copy_2d()
+
+} // namespace stock
+
+#endif // __BULK_HPP__
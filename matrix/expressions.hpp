@@ -0,0 +1,275 @@
+/**
+ *  Project: The Stock Libraries
+ *
+ *  File: expressions.hpp
+ *  Created: Oct 18, 2026
+ *
+ *  Author: Abhinav Sarje <abhinav.sarje@gmail.com>
+ *
+ *  Copyright (c) 2012-2017 Abhinav Sarje
+ *  Distributed under the Boost Software License.
+ *  See accompanying LICENSE file.
+ */
+
+#ifndef __EXPRESSIONS_HPP__
+#define __EXPRESSIONS_HPP__
+
+#include <cmath>
+#include <iostream>
+
+namespace stock {
+
+	/* lazy element-wise arithmetic on Matrix2D.
+	 * an expression such as a + b * s - c only builds a small tree of nodes; the whole tree is
+	 * evaluated in a single fused parallel loop when it is assigned to a Matrix2D.
+	 * all the matrices in an expression must have the same dimensions and layout, since
+	 * elements are combined by their position in the buffer. when their leading dimensions
+	 * differ, or the expression is assigned to a matrix of another layout, at(i, j) combines
+	 * them by (row, col) instead. */
+
+	/* base of all expression nodes (curiously recurring template) */
+	template <typename expr_t>
+	class MatrixExpression {
+		public:
+			const expr_t& derived() const { return static_cast<const expr_t&>(*this); }
+	}; // class MatrixExpression
+
+
+	/* layout of an expression combining two operands. scalars have void layout.
+	 * combining matrices of different layouts fails to compile */
+	template <typename l1_t, typename l2_t> struct CommonLayout { };
+	template <typename l_t> struct CommonLayout<l_t, l_t> { typedef l_t type; };
+	template <typename l_t> struct CommonLayout<l_t, void> { typedef l_t type; };
+	template <typename l_t> struct CommonLayout<void, l_t> { typedef l_t type; };
+	template <> struct CommonLayout<void, void> { typedef void type; };
+
+
+	/* leaf node: a matrix */
+	template <typename data_t, typename layout_t>
+	class MatrixTerminal : public MatrixExpression<MatrixTerminal<data_t, layout_t> > {
+		private:
+			const data_t* data_;
+			size_t num_rows_;
+			size_t num_cols_;
+			size_t ld_;
+
+		public:
+			typedef data_t value_type;
+			typedef layout_t layout_type;
+
+			MatrixTerminal(const Matrix2D<data_t, layout_t>& mat):
+				data_(mat.data()),
+				num_rows_(mat.num_rows()), num_cols_(mat.num_cols()), ld_(mat.leading_dim()) { }
+
+			size_t num_rows() const { return num_rows_; }
+			size_t num_cols() const { return num_cols_; }
+			size_t leading_dim() const { return ld_; }
+			bool is_scalar() const { return false; }
+			data_t operator[](size_t i) const { return data_[i]; }
+			data_t at(size_t i, size_t j) const { return data_[layout_t::index(i, j, num_rows_, num_cols_, ld_)]; }
+	}; // class MatrixTerminal
+
+
+	/* leaf node: a scalar */
+	template <typename data_t>
+	class ScalarTerminal : public MatrixExpression<ScalarTerminal<data_t> > {
+		private:
+			data_t value_;
+
+		public:
+			typedef data_t value_type;
+			typedef void layout_type;
+
+			ScalarTerminal(data_t value): value_(value) { }
+
+			size_t num_rows() const { return 0; }
+			size_t num_cols() const { return 0; }
+			size_t leading_dim() const { return 0; }
+			bool is_scalar() const { return true; }
+			data_t operator[](size_t) const { return value_; }
+			data_t at(size_t, size_t) const { return value_; }
+	}; // class ScalarTerminal
+
+
+	/* element-wise binary operation */
+	template <typename lhs_t, typename rhs_t, typename op_t>
+	class BinaryExpression : public MatrixExpression<BinaryExpression<lhs_t, rhs_t, op_t> > {
+		private:
+			lhs_t lhs_;
+			rhs_t rhs_;
+			size_t num_rows_;
+			size_t num_cols_;
+
+		public:
+			typedef typename lhs_t::value_type value_type;
+			typedef typename CommonLayout<typename lhs_t::layout_type,
+											typename rhs_t::layout_type>::type layout_type;
+
+			BinaryExpression(const lhs_t& lhs, const rhs_t& rhs): lhs_(lhs), rhs_(rhs) {
+				num_rows_ = lhs.is_scalar() ? rhs.num_rows() : lhs.num_rows();
+				num_cols_ = lhs.is_scalar() ? rhs.num_cols() : lhs.num_cols();
+				if(!lhs.is_scalar() && !rhs.is_scalar() &&
+						(lhs.num_rows() != rhs.num_rows() || lhs.num_cols() != rhs.num_cols())) {
+					std::cerr << "error: matrices in expression should have equal dimensions" << std::endl;
+					num_rows_ = num_cols_ = 0;
+				} // if
+			} // BinaryExpression()
+
+			size_t num_rows() const { return num_rows_; }
+			size_t num_cols() const { return num_cols_; }
+			// common leading dimension of the operands, 0 for scalars and -1 when they differ
+			size_t leading_dim() const {
+				if(lhs_.leading_dim() == 0 || lhs_.leading_dim() == rhs_.leading_dim()) return rhs_.leading_dim();
+				return (rhs_.leading_dim() == 0) ? lhs_.leading_dim() : (size_t) -1;
+			} // leading_dim()
+			bool is_scalar() const { return false; }
+			value_type operator[](size_t i) const { return op_t::apply(lhs_[i], rhs_[i]); }
+			value_type at(size_t i, size_t j) const { return op_t::apply(lhs_.at(i, j), rhs_.at(i, j)); }
+	}; // class BinaryExpression
+
+
+	/* element-wise unary function */
+	template <typename expr_t, typename func_t>
+	class UnaryExpression : public MatrixExpression<UnaryExpression<expr_t, func_t> > {
+		private:
+			expr_t expr_;
+			func_t func_;
+
+		public:
+			typedef typename expr_t::value_type value_type;
+			typedef typename expr_t::layout_type layout_type;
+
+			UnaryExpression(const expr_t& expr, const func_t& func): expr_(expr), func_(func) { }
+
+			size_t num_rows() const { return expr_.num_rows(); }
+			size_t num_cols() const { return expr_.num_cols(); }
+			size_t leading_dim() const { return expr_.leading_dim(); }
+			bool is_scalar() const { return false; }
+			value_type operator[](size_t i) const { return func_(expr_[i]); }
+			value_type at(size_t i, size_t j) const { return func_(expr_.at(i, j)); }
+	}; // class UnaryExpression
+
+
+	/* operators and functions */
+
+	struct ExprAdd { template <typename a_t, typename b_t> static a_t apply(a_t a, b_t b) { return a + b; } };
+	struct ExprSub { template <typename a_t, typename b_t> static a_t apply(a_t a, b_t b) { return a - b; } };
+	struct ExprMul { template <typename a_t, typename b_t> static a_t apply(a_t a, b_t b) { return a * b; } };
+	struct ExprDiv { template <typename a_t, typename b_t> static a_t apply(a_t a, b_t b) { return a / b; } };
+
+	struct ExprNeg { template <typename a_t> a_t operator()(a_t a) const { return - a; } };
+	struct ExprAbs { template <typename a_t> a_t operator()(a_t a) const { return std::abs(a); } };
+	struct ExprSqrt { template <typename a_t> a_t operator()(a_t a) const { return std::sqrt(a); } };
+	struct ExprExp { template <typename a_t> a_t operator()(a_t a) const { return std::exp(a); } };
+	struct ExprLog { template <typename a_t> a_t operator()(a_t a) const { return std::log(a); } };
+
+
+	/* maps operand types to expression nodes.
+	 * only Matrix2D and expression nodes are expressions, anything else is taken as a scalar */
+	template <typename type_t>
+	struct ExpressionTraits {
+		static const bool is_expression = false;
+	}; // struct ExpressionTraits
+
+	template <typename data_t, typename layout_t>
+	struct ExpressionTraits<Matrix2D<data_t, layout_t> > {
+		static const bool is_expression = true;
+		typedef MatrixTerminal<data_t, layout_t> type;
+		static type wrap(const Matrix2D<data_t, layout_t>& mat) { return type(mat); }
+	}; // struct ExpressionTraits
+
+	template <typename data_t, typename layout_t>
+	struct ExpressionTraits<MatrixTerminal<data_t, layout_t> > {
+		static const bool is_expression = true;
+		typedef MatrixTerminal<data_t, layout_t> type;
+		static const type& wrap(const type& expr) { return expr; }
+	}; // struct ExpressionTraits
+
+	template <typename lhs_t, typename rhs_t, typename op_t>
+	struct ExpressionTraits<BinaryExpression<lhs_t, rhs_t, op_t> > {
+		static const bool is_expression = true;
+		typedef BinaryExpression<lhs_t, rhs_t, op_t> type;
+		static const type& wrap(const type& expr) { return expr; }
+	}; // struct ExpressionTraits
+
+	template <typename expr_t, typename func_t>
+	struct ExpressionTraits<UnaryExpression<expr_t, func_t> > {
+		static const bool is_expression = true;
+		typedef UnaryExpression<expr_t, func_t> type;
+		static const type& wrap(const type& expr) { return expr; }
+	}; // struct ExpressionTraits
+
+
+	/* result types of the operators, defined only for valid operand combinations */
+	template <typename a_t, typename b_t, typename op_t,
+				bool a_expr = ExpressionTraits<a_t>::is_expression,
+				bool b_expr = ExpressionTraits<b_t>::is_expression>
+	struct BinaryResult { };
+
+	template <typename a_t, typename b_t, typename op_t>
+	struct BinaryResult<a_t, b_t, op_t, true, true> {
+		typedef BinaryExpression<typename ExpressionTraits<a_t>::type,
+									typename ExpressionTraits<b_t>::type, op_t> type;
+		static type make(const a_t& a, const b_t& b) {
+			return type(ExpressionTraits<a_t>::wrap(a), ExpressionTraits<b_t>::wrap(b));
+		} // make()
+	}; // struct BinaryResult
+
+	template <typename a_t, typename b_t, typename op_t>
+	struct BinaryResult<a_t, b_t, op_t, true, false> {
+		typedef typename ExpressionTraits<a_t>::type a_expr_t;
+		typedef ScalarTerminal<typename a_expr_t::value_type> b_expr_t;
+		typedef BinaryExpression<a_expr_t, b_expr_t, op_t> type;
+		static type make(const a_t& a, const b_t& b) {
+			return type(ExpressionTraits<a_t>::wrap(a), b_expr_t(b));
+		} // make()
+	}; // struct BinaryResult
+
+	template <typename a_t, typename b_t, typename op_t>
+	struct BinaryResult<a_t, b_t, op_t, false, true> {
+		typedef typename ExpressionTraits<b_t>::type b_expr_t;
+		typedef ScalarTerminal<typename b_expr_t::value_type> a_expr_t;
+		typedef BinaryExpression<a_expr_t, b_expr_t, op_t> type;
+		static type make(const a_t& a, const b_t& b) {
+			return type(a_expr_t(a), ExpressionTraits<b_t>::wrap(b));
+		} // make()
+	}; // struct BinaryResult
+
+
+	template <typename a_t, typename b_t>
+	typename BinaryResult<a_t, b_t, ExprAdd>::type operator+(const a_t& a, const b_t& b) {
+		return BinaryResult<a_t, b_t, ExprAdd>::make(a, b);
+	} // operator+()
+
+	template <typename a_t, typename b_t>
+	typename BinaryResult<a_t, b_t, ExprSub>::type operator-(const a_t& a, const b_t& b) {
+		return BinaryResult<a_t, b_t, ExprSub>::make(a, b);
+	} // operator-()
+
+	template <typename a_t, typename b_t>
+	typename BinaryResult<a_t, b_t, ExprMul>::type operator*(const a_t& a, const b_t& b) {
+		return BinaryResult<a_t, b_t, ExprMul>::make(a, b);
+	} // operator*()
+
+	template <typename a_t, typename b_t>
+	typename BinaryResult<a_t, b_t, ExprDiv>::type operator/(const a_t& a, const b_t& b) {
+		return BinaryResult<a_t, b_t, ExprDiv>::make(a, b);
+	} // operator/()
+
+
+	// ////
+	// apply a unary function object element-wise
+	// ////
+	template <typename a_t, typename func_t>
+	UnaryExpression<typename ExpressionTraits<a_t>::type, func_t> apply(const a_t& a, const func_t& func) {
+		return UnaryExpression<typename ExpressionTraits<a_t>::type, func_t>(ExpressionTraits<a_t>::wrap(a), func);
+	} // apply()
+
+	template <typename a_t>
+	UnaryExpression<typename ExpressionTraits<a_t>::type, ExprNeg> operator-(const a_t& a) {
+		return apply(a, ExprNeg());
+	} // operator-()
+
+} // namespace stock
+
+#endif // __EXPRESSIONS_HPP__
@@ -0,0 +1,655 @@
+/**
+ *  Project: The Stock Libraries
+ *
+ *  File: factor.hpp
+ *  Created: Oct 18, 2026
+ *
+ *  Author: Abhinav Sarje <abhinav.sarje@gmail.com>
+ *
+ *  Copyright (c) 2012-2017 Abhinav Sarje
+ *  Distributed under the Boost Software License.
+ *  See accompanying LICENSE file.
+ */
+
+#ifndef __FACTOR_HPP__
+#define __FACTOR_HPP__
+
+#include <vector>
+#include <complex>
+#include <cmath>
+#include <iostream>
+#include <algorithm>
+#include <cstddef>
+
+namespace stock {
+
+	/* dense LU (with partial pivoting) and Cholesky factorizations, and triangular solves,
+	 * of float, double and std::complex matrices.
+	 *
+	 * both factorizations are right-looking and blocked: a panel of FACTOR_BLOCK_ columns
+	 * is factored, and the trailing matrix is updated with gemm(), which is where nearly all
+	 * the work goes and which runs on all threads. LU panels are factored recursively
+	 * (splitting the columns in halves), and triangular solves with many right hand sides
+	 * recurse the same way, so that these also go through gemm().
+	 *
+	 * operands are worked on in place through a pointer and a row and a column stride, as in
+	 * gemm(). matrices of tiled layouts go through a row-major copy */
+
+	const size_t FACTOR_BLOCK_ = 128;			// columns per panel of the blocked factorizations
+	const size_t FACTOR_PANEL_BASE_ = 8;		// LU panels this narrow are factored column by column
+	const size_t FACTOR_TRSM_BASE_ = 64;		// triangles this small are solved by substitution
+	const size_t FACTOR_TRSM_COLS_ = 256;		// right hand sides per thread in substitution
+	const size_t FACTOR_SERIAL_ = 1 << 15;		// less work than this is done by one thread
+
+	enum TriangularPart {
+		triangular_lower,		/* the lower triangle and the diagonal */
+		triangular_upper		/* the upper triangle and the diagonal */
+	};
+
+
+	// ////
+	// conjugation and the pivoting magnitude of real and complex elements
+	// ////
+	template <typename value_type>
+	struct FactorTraits {
+		typedef value_type real_type;
+		static const bool is_complex = false;
+		static value_type conj(value_type x) { return x; }
+		static real_type real(value_type x) { return x; }
+		static real_type abs1(value_type x) { return std::abs(x); }
+	}; // struct FactorTraits
+
+	template <typename real_t>
+	struct FactorTraits<std::complex<real_t> > {
+		typedef real_t real_type;
+		static const bool is_complex = true;
+		static std::complex<real_t> conj(std::complex<real_t> x) { return std::conj(x); }
+		static real_type real(std::complex<real_t> x) { return x.real(); }
+		// |re| + |im|, as in LAPACK, which orders pivots about as well as the modulus
+		static real_type abs1(std::complex<real_t> x) { return std::abs(x.real()) + std::abs(x.imag()); }
+	}; // struct FactorTraits
+
+
+	// ////
+	// conjugate an m x n block in place. nothing to do for real types
+	// ////
+	template <typename value_type>
+	void factor_conjugate(size_t m, size_t n, value_type* a, ptrdiff_t rs, ptrdiff_t cs) {
+		typedef FactorTraits<value_type> traits_t;
+		if(!traits_t::is_complex) return;
+		#pragma omp parallel for schedule(static) if(m * n > FACTOR_SERIAL_)
+		for(size_t i = 0; i < m; ++ i) {
+			for(size_t j = 0; j < n; ++ j) a[i * rs + j * cs] = traits_t::conj(a[i * rs + j * cs]);
+		} // for
+	} // factor_conjugate()
+
+
+	// ////
+	// interchange rows k and piv[k] of the ncols columns of a, for k = k_begin .. k_end - 1
+	// in order. the columns are split over threads
+	// ////
+	template <typename value_type>
+	void factor_swap_rows(size_t ncols, value_type* a, ptrdiff_t rs, ptrdiff_t cs,
+							const size_t* piv, size_t k_begin, size_t k_end) {
+		if(ncols == 0 || k_begin >= k_end) return;
+		const size_t chunk = FACTOR_TRSM_COLS_;
+		#pragma omp parallel for schedule(static) if(ncols * (k_end - k_begin) > FACTOR_SERIAL_)
+		for(size_t j0 = 0; j0 < ncols; j0 += chunk) {
+			size_t j1 = std::min(ncols, j0 + chunk);
+			for(size_t k = k_begin; k < k_end; ++ k) {
+				if(piv[k] == k) continue;
+				value_type* r0 = a + k * rs;
+				value_type* r1 = a + piv[k] * rs;
+				for(size_t j = j0; j < j1; ++ j) std::swap(r0[j * cs], r1[j * cs]);
+			} // for
+		} // for
+	} // factor_swap_rows()
+
+
+	// ////
+	// substitution for triangular solves: L X = B (lower) or U X = B (upper), where the
+	// triangle t is n x n and B is n x m, overwritten with X. the diagonal of t is taken as
+	// ones when unit is set. B with contiguous rows is updated row by row over chunks of
+	// columns, otherwise each column is solved in a buffer of the thread
+	// ////
+	template <typename value_type>
+	void factor_substitute(TriangularPart part, bool unit, size_t n, size_t m,
+							const value_type* t, ptrdiff_t rs_t, ptrdiff_t cs_t,
+							value_type* b, ptrdiff_t rs_b, ptrdiff_t cs_b) {
+		if(n == 0 || m == 0) return;
+		const bool lower = (part == triangular_lower);
+		if(cs_b == 1 && m >= 8) {
+			const size_t chunk = FACTOR_TRSM_COLS_;
+			#pragma omp parallel for schedule(static) if(n * n * m > FACTOR_SERIAL_)
+			for(size_t j0 = 0; j0 < m; j0 += chunk) {
+				size_t j1 = std::min(m, j0 + chunk);
+				for(size_t s = 0; s < n; ++ s) {
+					size_t i = lower ? s : n - 1 - s;
+					value_type* bi = b + i * rs_b;
+					size_t p_begin = lower ? 0 : i + 1, p_end = lower ? i : n;
+					for(size_t p = p_begin; p < p_end; ++ p) {
+						value_type tip = t[i * rs_t + p * cs_t];
+						const value_type* bp = b + p * rs_b;
+						for(size_t j = j0; j < j1; ++ j) bi[j] -= tip * bp[j];
+					} // for
+					if(!unit) {
+						value_type tii = t[i * rs_t + i * cs_t];
+						for(size_t j = j0; j < j1; ++ j) bi[j] /= tii;
+					} // if
+				} // for
+			} // for
+			return;
+		} // if
+
+		#pragma omp parallel if(n * n * m > FACTOR_SERIAL_)
+		{
+			std::vector<value_type> x(n);
+			#pragma omp for schedule(static)
+			for(size_t j = 0; j < m; ++ j) {
+				value_type* bj = b + j * cs_b;
+				for(size_t i = 0; i < n; ++ i) x[i] = bj[i * rs_b];
+				if(cs_t == 1) {
+					// rows of t are contiguous: one dot product per row
+					for(size_t s = 0; s < n; ++ s) {
+						size_t i = lower ? s : n - 1 - s;
+						const value_type* ti = t + i * rs_t;
+						size_t p_begin = lower ? 0 : i + 1, p_end = lower ? i : n;
+						value_type sum = x[i];
+						for(size_t p = p_begin; p < p_end; ++ p) sum -= ti[p] * x[p];
+						x[i] = unit ? sum : sum / ti[i];
+					} // for
+				} else {
+					// one update with each column of t
+					for(size_t s = 0; s < n; ++ s) {
+						size_t p = lower ? s : n - 1 - s;
+						const value_type* tp = t + p * cs_t;
+						if(!unit) x[p] /= tp[p * rs_t];
+						value_type xp = x[p];
+						size_t i_begin = lower ? p + 1 : 0, i_end = lower ? n : p;
+						for(size_t i = i_begin; i < i_end; ++ i) x[i] -= tp[i * rs_t] * xp;
+					} // for
+				} // if-else
+				for(size_t i = 0; i < n; ++ i) bj[i * rs_b] = x[i];
+			} // for
+		}
+	} // factor_substitute()
+
+
+	// ////
+	// triangular solve with many right hand sides: the triangle is split in halves, and the
+	// off-diagonal block is applied with gemm() between the solves with the two halves
+	// ////
+	template <typename value_type>
+	void factor_trsm(TriangularPart part, bool unit, size_t n, size_t m,
+						const value_type* t, ptrdiff_t rs_t, ptrdiff_t cs_t,
+						value_type* b, ptrdiff_t rs_b, ptrdiff_t cs_b) {
+		if(n <= FACTOR_TRSM_BASE_ || m < 8) {
+			factor_substitute(part, unit, n, m, t, rs_t, cs_t, b, rs_b, cs_b);
+			return;
+		} // if
+		size_t n1 = n / 2, n2 = n - n1;
+		const value_type* t21 = t + n1 * rs_t;			// below the first half
+		const value_type* t12 = t + n1 * cs_t;			// right of the first half
+		const value_type* t22 = t21 + n1 * cs_t;
+		value_type* b2 = b + n1 * rs_b;
+		if(part == triangular_lower) {
+			factor_trsm(part, unit, n1, m, t, rs_t, cs_t, b, rs_b, cs_b);
+			gemm(n2, m, n1, value_type(-1), t21, rs_t, cs_t, b, rs_b, cs_b,
+					value_type(1), b2, rs_b, cs_b);
+			factor_trsm(part, unit, n2, m, t22, rs_t, cs_t, b2, rs_b, cs_b);
+		} else {
+			factor_trsm(part, unit, n2, m, t22, rs_t, cs_t, b2, rs_b, cs_b);
+			gemm(n1, m, n2, value_type(-1), t12, rs_t, cs_t, b2, rs_b, cs_b,
+					value_type(1), b, rs_b, cs_b);
+			factor_trsm(part, unit, n1, m, t, rs_t, cs_t, b, rs_b, cs_b);
+		} // if-else
+	} // factor_trsm()
+
+
+	// ////
+	// LU of an m x n panel, m >= n, with partial pivoting within the panel. piv[k] is the row,
+	// relative to the panel, interchanged with row k. singular is set on a zero pivot
+	// ////
+	template <typename value_type>
+	void factor_lu_panel(size_t m, size_t n, value_type* a, ptrdiff_t rs, ptrdiff_t cs,
+							size_t* piv, bool& singular) {
+		typedef FactorTraits<value_type> traits_t;
+		typedef typename traits_t::real_type real_type;
+		if(n <= FACTOR_PANEL_BASE_) {
+			for(size_t k = 0; k < n; ++ k) {
+				value_type* akk = a + k * rs + k * cs;
+				size_t p = k;
+				real_type max = traits_t::abs1(*akk);
+				for(size_t i = k + 1; i < m; ++ i) {
+					real_type v = traits_t::abs1(a[i * rs + k * cs]);
+					if(v > max) { max = v; p = i; }
+				} // for
+				piv[k] = p;
+				if(p != k) {
+					for(size_t j = 0; j < n; ++ j) std::swap(a[k * rs + j * cs], a[p * rs + j * cs]);
+				} // if
+				if(*akk == value_type(0)) {
+					singular = true;
+					continue;
+				} // if
+				value_type inv = value_type(1) / *akk;
+				for(size_t i = k + 1; i < m; ++ i) {
+					value_type* ai = a + i * rs;
+					value_type lik = (ai[k * cs] *= inv);
+					for(size_t j = k + 1; j < n; ++ j) ai[j * cs] -= lik * akk[(j - k) * cs];
+				} // for
+			} // for
+			return;
+		} // if
+
+		size_t n1 = n / 2, n2 = n - n1;
+		value_type* a12 = a + n1 * cs;
+		value_type* a21 = a + n1 * rs;
+		value_type* a22 = a21 + n1 * cs;
+		factor_lu_panel(m, n1, a, rs, cs, piv, singular);
+		factor_swap_rows(n2, a12, rs, cs, piv, 0, n1);
+		factor_trsm(triangular_lower, true, n1, n2, a, rs, cs, a12, rs, cs);
+		gemm(m - n1, n2, n1, value_type(-1), a21, rs, cs, a12, rs, cs, value_type(1), a22, rs, cs);
+		factor_lu_panel(m - n1, n2, a22, rs, cs, piv + n1, singular);
+		for(size_t k = n1; k < n; ++ k) piv[k] += n1;
+		factor_swap_rows(n1, a, rs, cs, piv, n1, n);
+	} // factor_lu_panel()
+
+
+	// ////
+	// blocked right-looking LU of an m x n matrix: P A = L U, L unit lower triangular (below
+	// the diagonal of a), U upper triangular. returns false when A is singular
+	// ////
+	template <typename value_type>
+	bool factor_lu(size_t m, size_t n, value_type* a, ptrdiff_t rs, ptrdiff_t cs, size_t* piv) {
+		bool singular = false;
+		size_t mn = std::min(m, n);
+		for(size_t k0 = 0; k0 < mn; k0 += FACTOR_BLOCK_) {
+			size_t kb = std::min(FACTOR_BLOCK_, mn - k0);
+			size_t k1 = k0 + kb;
+			value_type* a11 = a + k0 * rs + k0 * cs;
+			factor_lu_panel(m - k0, kb, a11, rs, cs, piv + k0, singular);
+			for(size_t k = k0; k < k1; ++ k) piv[k] += k0;
+			// apply the interchanges of the panel to the columns left and right of it
+			factor_swap_rows(k0, a, rs, cs, piv, k0, k1);
+			factor_swap_rows(n - k1, a + k1 * cs, rs, cs, piv, k0, k1);
+			if(k1 < n) {
+				value_type* a12 = a11 + kb * cs;
+				factor_trsm(triangular_lower, true, kb, n - k1, a11, rs, cs, a12, rs, cs);
+				if(k1 < m) {
+					// trailing update A22 -= L21 U12
+					gemm(m - k1, n - k1, kb, value_type(-1), a11 + kb * rs, rs, cs, a12, rs, cs,
+							value_type(1), a12 + kb * rs, rs, cs);
+				} // if
+			} // if
+		} // for
+		return !singular;
+	} // factor_lu()
+
+
+	// ////
+	// unblocked Cholesky of an n x n diagonal block, lower triangle. false when the block
+	// is not positive definite
+	// ////
+	template <typename value_type>
+	bool factor_cholesky_block(size_t n, value_type* a, ptrdiff_t rs, ptrdiff_t cs) {
+		typedef FactorTraits<value_type> traits_t;
+		typedef typename traits_t::real_type real_type;
+		for(size_t j = 0; j < n; ++ j) {
+			value_type* aj = a + j * rs;
+			real_type d = traits_t::real(aj[j * cs]);
+			for(size_t p = 0; p < j; ++ p) d -= traits_t::real(aj[p * cs] * traits_t::conj(aj[p * cs]));
+			if(!(d > real_type(0))) return false;
+			real_type ljj = std::sqrt(d);
+			aj[j * cs] = value_type(ljj);
+			for(size_t i = j + 1; i < n; ++ i) {
+				value_type* ai = a + i * rs;
+				value_type sum = ai[j * cs];
+				for(size_t p = 0; p < j; ++ p) sum -= ai[p * cs] * traits_t::conj(aj[p * cs]);
+				ai[j * cs] = sum / ljj;
+			} // for
+		} // for
+		return true;
+	} // factor_cholesky_block()
+
+
+	// ////
+	// blocked right-looking Cholesky of an n x n hermitian positive definite matrix: A = L L^H,
+	// with L written to the lower triangle and the strict upper triangle set to zero. only the
+	// lower triangle of A is read. returns false when A is not positive definite
+	// ////
+	template <typename value_type>
+	bool factor_cholesky(size_t n, value_type* a, ptrdiff_t rs, ptrdiff_t cs) {
+		typedef FactorTraits<value_type> traits_t;
+		std::vector<value_type> w;		// conj(L21)^T of the current panel, row-major
+		for(size_t k0 = 0; k0 < n; k0 += FACTOR_BLOCK_) {
+			size_t kb = std::min(FACTOR_BLOCK_, n - k0);
+			size_t n2 = n - k0 - kb;
+			value_type* a11 = a + k0 * rs + k0 * cs;
+			if(!factor_cholesky_block(kb, a11, rs, cs)) return false;
+			if(n2 == 0) break;
+
+			// L21 = A21 L11^-H, solved as L11 conj(L21)^T = conj(A21)^T in a row-major buffer,
+			// where the solve runs along contiguous rows whatever the layout of A
+			value_type* a21 = a11 + kb * rs;
+			w.resize(kb * n2);
+			#pragma omp parallel for schedule(static) if(n2 * kb > FACTOR_SERIAL_)
+			for(size_t i = 0; i < n2; ++ i) {
+				for(size_t p = 0; p < kb; ++ p) w[p * n2 + i] = traits_t::conj(a21[i * rs + p * cs]);
+			} // for
+			factor_trsm(triangular_lower, false, kb, n2, a11, rs, cs, &w[0], (ptrdiff_t) n2, (ptrdiff_t) 1);
+			#pragma omp parallel for schedule(static) if(n2 * kb > FACTOR_SERIAL_)
+			for(size_t i = 0; i < n2; ++ i) {
+				for(size_t p = 0; p < kb; ++ p) a21[i * rs + p * cs] = traits_t::conj(w[p * n2 + i]);
+			} // for
+
+			// trailing update A22 -= L21 L21^H, lower triangle only, a block of columns at a time
+			value_type* a22 = a21 + kb * cs;
+			for(size_t j0 = 0; j0 < n2; j0 += FACTOR_BLOCK_) {
+				size_t jb = std::min(FACTOR_BLOCK_, n2 - j0);
+				gemm(n2 - j0, jb, kb, value_type(-1), a21 + j0 * rs, rs, cs, &w[j0], (ptrdiff_t) n2, (ptrdiff_t) 1,
+						value_type(1), a22 + j0 * rs + j0 * cs, rs, cs);
+			} // for
+		} // for
+		#pragma omp parallel for schedule(static) if(n * n > FACTOR_SERIAL_)
+		for(size_t i = 0; i < n; ++ i) {
+			for(size_t j = i + 1; j < n; ++ j) a[i * rs + j * cs] = value_type(0);
+		} // for
+		return true;
+	} // factor_cholesky()
+
+
+	// ////
+	// solve A X = B given the LU factors of A, B is n x m and overwritten with X
+	// ////
+	template <typename value_type>
+	void factor_lu_solve(size_t n, const value_type* lu, ptrdiff_t rs, ptrdiff_t cs, const size_t* piv,
+							size_t m, value_type* b, ptrdiff_t rs_b, ptrdiff_t cs_b) {
+		factor_swap_rows(m, b, rs_b, cs_b, piv, 0, n);
+		factor_trsm(triangular_lower, true, n, m, lu, rs, cs, b, rs_b, cs_b);
+		factor_trsm(triangular_upper, false, n, m, lu, rs, cs, b, rs_b, cs_b);
+	} // factor_lu_solve()
+
+	// ////
+	// solve A X = B given the Cholesky factor L of A: L Y = B, then L^H X = Y, which is
+	// solved as L^T conj(X) = conj(Y)
+	// ////
+	template <typename value_type>
+	void factor_cholesky_solve(size_t n, const value_type* l, ptrdiff_t rs, ptrdiff_t cs,
+								size_t m, value_type* b, ptrdiff_t rs_b, ptrdiff_t cs_b) {
+		factor_trsm(triangular_lower, false, n, m, l, rs, cs, b, rs_b, cs_b);
+		factor_conjugate(n, m, b, rs_b, cs_b);
+		factor_trsm(triangular_upper, false, n, m, l, cs, rs, b, rs_b, cs_b);
+		factor_conjugate(n, m, b, rs_b, cs_b);
+	} // factor_cholesky_solve()
+
+
+	// ////
+	// copies between a matrix of any layout and a row-major one, rows in parallel
+	// ////
+	template <typename value_type, typename layout_t>
+	void factor_copy(const Matrix2D<value_type, layout_t>& in, Matrix2D<value_type, RowMajor>& out) {
+		size_t rows = in.num_rows(), cols = in.num_cols();
+		out.resize(rows, cols);
+		value_type* dst = out.kernel_data();
+		size_t ld = out.leading_dim();
+		#pragma omp parallel for schedule(static)
+		for(size_t i = 0; i < rows; ++ i)
+			for(size_t j = 0; j < cols; ++ j) dst[i * ld + j] = in(i, j);
+	} // factor_copy()
+
+	template <typename value_type, typename layout_t>
+	void factor_copy_back(const Matrix2D<value_type, RowMajor>& in, Matrix2D<value_type, layout_t>& out) {
+		size_t rows = in.num_rows(), cols = in.num_cols();
+		value_type* dst = out.kernel_data();
+		#pragma omp parallel for schedule(static)
+		for(size_t i = 0; i < rows; ++ i)
+			for(size_t j = 0; j < cols; ++ j) dst[out.index(i, j)] = in(i, j);
+	} // factor_copy_back()
+
+
+	// ////
+	// LU factorization with partial pivoting, in place: P A = L U. mat holds U in its upper
+	// triangle and L, with a unit diagonal, below it. pivots[k] is the row interchanged with
+	// row k. returns false when A is singular, the factors are then complete but U has a zero
+	// on the diagonal
+	// ////
+	template <typename value_type, typename layout_t>
+	bool matrix_lu(Matrix2D<value_type, layout_t>& mat, std::vector<size_t>& pivots) {
+		size_t m = mat.num_rows(), n = mat.num_cols();
+		pivots.resize(std::min(m, n));
+		if(pivots.empty()) return true;
+		ptrdiff_t rs, cs;
+		if(!gemm_operand(mat, false, rs, cs)) {
+			Matrix2D<value_type, RowMajor> temp(m, n);
+			factor_copy(mat, temp);
+			bool ok = matrix_lu(temp, pivots);
+			factor_copy_back(temp, mat);
+			return ok;
+		} // if
+		if(!factor_lu(m, n, mat.kernel_data(), rs, cs, &pivots[0])) {
+			std::cerr << "error: matrix is singular" << std::endl;
+			return false;
+		} // if
+		return true;
+	} // matrix_lu()
+
+	// ////
+	// solve A X = B with the LU factors of the square matrix A from matrix_lu().
+	// B is overwritten with X
+	// ////
+	template <typename value_type, typename layout_t, typename layout_b>
+	bool matrix_lu_solve(const Matrix2D<value_type, layout_t>& lu, const std::vector<size_t>& pivots,
+							Matrix2D<value_type, layout_b>& b) {
+		size_t n = lu.num_rows();
+		if(lu.num_cols() != n || pivots.size() != n || b.num_rows() != n) {
+			std::cerr << "error: dimensions of the factors and the right hand sides do not match" << std::endl;
+			return false;
+		} // if
+		if(n == 0 || b.num_cols() == 0) return true;
+		ptrdiff_t rs, cs, rs_b, cs_b;
+		if(!gemm_operand(lu, false, rs, cs)) {
+			Matrix2D<value_type, RowMajor> temp(n, n);
+			factor_copy(lu, temp);
+			return matrix_lu_solve(temp, pivots, b);
+		} // if
+		if(!gemm_operand(b, false, rs_b, cs_b)) {
+			Matrix2D<value_type, RowMajor> temp(n, b.num_cols());
+			factor_copy(b, temp);
+			bool ok = matrix_lu_solve(lu, pivots, temp);
+			factor_copy_back(temp, b);
+			return ok;
+		} // if
+		factor_lu_solve(n, &lu[0], rs, cs, &pivots[0], b.num_cols(), b.kernel_data(), rs_b, cs_b);
+		return true;
+	} // matrix_lu_solve()
+
+	// ////
+	// solve A x = b for a single right hand side, b is overwritten with x
+	// ////
+	template <typename value_type, typename layout_t>
+	bool matrix_lu_solve(const Matrix2D<value_type, layout_t>& lu, const std::vector<size_t>& pivots,
+							std::vector<value_type>& b) {
+		size_t n = lu.num_rows();
+		if(lu.num_cols() != n || pivots.size() != n || b.size() != n) {
+			std::cerr << "error: dimensions of the factors and the right hand side do not match" << std::endl;
+			return false;
+		} // if
+		if(n == 0) return true;
+		ptrdiff_t rs, cs;
+		if(!gemm_operand(lu, false, rs, cs)) {
+			Matrix2D<value_type, RowMajor> temp(n, n);
+			factor_copy(lu, temp);
+			return matrix_lu_solve(temp, pivots, b);
+		} // if
+		factor_lu_solve(n, &lu[0], rs, cs, &pivots[0], 1, &b[0], 1, 1);
+		return true;
+	} // matrix_lu_solve()
+
+
+	// ////
+	// Cholesky factorization of a hermitian (symmetric) positive definite matrix, in place:
+	// A = L L^H. only the lower triangle of mat is read, on return mat holds L with zeros
+	// above the diagonal. returns false when A is not positive definite
+	// ////
+	template <typename value_type, typename layout_t>
+	bool matrix_cholesky(Matrix2D<value_type, layout_t>& mat) {
+		size_t n = mat.num_rows();
+		if(mat.num_cols() != n) {
+			std::cerr << "error: matrix for Cholesky factorization is not square" << std::endl;
+			return false;
+		} // if
+		if(n == 0) return true;
+		ptrdiff_t rs, cs;
+		if(!gemm_operand(mat, false, rs, cs)) {
+			Matrix2D<value_type, RowMajor> temp(n, n);
+			factor_copy(mat, temp);
+			bool ok = matrix_cholesky(temp);
+			factor_copy_back(temp, mat);
+			return ok;
+		} // if
+		if(!factor_cholesky(n, mat.kernel_data(), rs, cs)) {
+			std::cerr << "error: matrix is not positive definite" << std::endl;
+			return false;
+		} // if
+		return true;
+	} // matrix_cholesky()
+
+	// ////
+	// solve A X = B with the Cholesky factor of A from matrix_cholesky().
+	// B is overwritten with X
+	// ////
+	template <typename value_type, typename layout_t, typename layout_b>
+	bool matrix_cholesky_solve(const Matrix2D<value_type, layout_t>& l, Matrix2D<value_type, layout_b>& b) {
+		size_t n = l.num_rows();
+		if(l.num_cols() != n || b.num_rows() != n) {
+			std::cerr << "error: dimensions of the factor and the right hand sides do not match" << std::endl;
+			return false;
+		} // if
+		if(n == 0 || b.num_cols() == 0) return true;
+		ptrdiff_t rs, cs, rs_b, cs_b;
+		if(!gemm_operand(l, false, rs, cs)) {
+			Matrix2D<value_type, RowMajor> temp(n, n);
+			factor_copy(l, temp);
+			return matrix_cholesky_solve(temp, b);
+		} // if
+		if(!gemm_operand(b, false, rs_b, cs_b)) {
+			Matrix2D<value_type, RowMajor> temp(n, b.num_cols());
+			factor_copy(b, temp);
+			bool ok = matrix_cholesky_solve(l, temp);
+			factor_copy_back(temp, b);
+			return ok;
+		} // if
+		factor_cholesky_solve(n, &l[0], rs, cs, b.num_cols(), b.kernel_data(), rs_b, cs_b);
+		return true;
+	} // matrix_cholesky_solve()
+
+	// ////
+	// solve A x = b for a single right hand side, b is overwritten with x
+	// ////
+	template <typename value_type, typename layout_t>
+	bool matrix_cholesky_solve(const Matrix2D<value_type, layout_t>& l, std::vector<value_type>& b) {
+		size_t n = l.num_rows();
+		if(l.num_cols() != n || b.size() != n) {
+			std::cerr << "error: dimensions of the factor and the right hand side do not match" << std::endl;
+			return false;
+		} // if
+		if(n == 0) return true;
+		ptrdiff_t rs, cs;
+		if(!gemm_operand(l, false, rs, cs)) {
+			Matrix2D<value_type, RowMajor> temp(n, n);
+			factor_copy(l, temp);
+			return matrix_cholesky_solve(temp, b);
+		} // if
+		factor_cholesky_solve(n, &l[0], rs, cs, 1, &b[0], 1, 1);
+		return true;
+	} // matrix_cholesky_solve()
+
+
+	// ////
+	// forward (lower) or back (upper) substitution with a square triangular matrix:
+	// T X = B, B is overwritten with X. the other triangle of t is not read, and neither is
+	// the diagonal when unit_diagonal is set
+	// ////
+	template <typename value_type, typename layout_t, typename layout_b>
+	bool matrix_triangular_solve(const Matrix2D<value_type, layout_t>& t, TriangularPart part,
+									bool unit_diagonal, Matrix2D<value_type, layout_b>& b) {
+		size_t n = t.num_rows();
+		if(t.num_cols() != n || b.num_rows() != n) {
+			std::cerr << "error: dimensions of the triangular matrix and the right hand sides do not match"
+						<< std::endl;
+			return false;
+		} // if
+		if(n == 0 || b.num_cols() == 0) return true;
+		ptrdiff_t rs, cs, rs_b, cs_b;
+		if(!gemm_operand(t, false, rs, cs)) {
+			Matrix2D<value_type, RowMajor> temp(n, n);
+			factor_copy(t, temp);
+			return matrix_triangular_solve(temp, part, unit_diagonal, b);
+		} // if
+		if(!gemm_operand(b, false, rs_b, cs_b)) {
+			Matrix2D<value_type, RowMajor> temp(n, b.num_cols());
+			factor_copy(b, temp);
+			bool ok = matrix_triangular_solve(t, part, unit_diagonal, temp);
+			factor_copy_back(temp, b);
+			return ok;
+		} // if
+		factor_trsm(part, unit_diagonal, n, b.num_cols(), &t[0], rs, cs, b.kernel_data(), rs_b, cs_b);
+		return true;
+	} // matrix_triangular_solve()
+
+	// ////
+	// triangular solve for a single right hand side, b is overwritten with x
+	// ////
+	template <typename value_type, typename layout_t>
+	bool matrix_triangular_solve(const Matrix2D<value_type, layout_t>& t, TriangularPart part,
+									bool unit_diagonal, std::vector<value_type>& b) {
+		size_t n = t.num_rows();
+		if(t.num_cols() != n || b.size() != n) {
+			std::cerr << "error: dimensions of the triangular matrix and the right hand side do not match"
+						<< std::endl;
+			return false;
+		} // if
+		if(n == 0) return true;
+		ptrdiff_t rs, cs;
+		if(!gemm_operand(t, false, rs, cs)) {
+			Matrix2D<value_type, RowMajor> temp(n, n);
+			factor_copy(t, temp);
+			return matrix_triangular_solve(temp, part, unit_diagonal, b);
+		} // if
+		factor_substitute(part, unit_diagonal, n, 1, &t[0], rs, cs, &b[0], 1, 1);
+		return true;
+	} // matrix_triangular_solve()
+
+
+	// ////
+	// solve A X = B for a square A through its LU factorization. A is not changed,
+	// B is overwritten with X
+	// ////
+	template <typename value_type, typename layout_t, typename layout_b>
+	bool matrix_solve(const Matrix2D<value_type, layout_t>& a, Matrix2D<value_type, layout_b>& b) {
+		if(a.num_rows() != a.num_cols()) {
+			std::cerr << "error: matrix of the linear system is not square" << std::endl;
+			return false;
+		} // if
+		Matrix2D<value_type, layout_t> lu(a);
+		std::vector<size_t> pivots;
+		if(!matrix_lu(lu, pivots)) return false;
+		return matrix_lu_solve(lu, pivots, b);
+	} // matrix_solve()
+
+	template <typename value_type, typename layout_t>
+	bool matrix_solve(const Matrix2D<value_type, layout_t>& a, std::vector<value_type>& b) {
+		if(a.num_rows() != a.num_cols()) {
+			std::cerr << "error: matrix of the linear system is not square" << std::endl;
+			return false;
+		} // if
+		Matrix2D<value_type, layout_t> lu(a);
+		std::vector<size_t> pivots;
+		if(!matrix_lu(lu, pivots)) return false;
+		return matrix_lu_solve(lu, pivots, b);
+	} // matrix_solve()
+
+} // namespace stock
+
+#endif // __FACTOR_HPP__
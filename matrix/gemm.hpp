@@ -0,0 +1,479 @@
+/**
+ *  Project: The Stock Libraries
+ *
+ *  File: gemm.hpp
+ *  Created: Oct 18, 2026
+ *
+ *  Author: Abhinav Sarje <abhinav.sarje@gmail.com>
+ *
+ *  Copyright (c) 2012-2017 Abhinav Sarje
+ *  Distributed under the Boost Software License.
+ *  See accompanying LICENSE file.
+ */
+
+#ifndef __GEMM_HPP__
+#define __GEMM_HPP__
+
+#include <vector>
+#include <complex>
+#include <iostream>
+#include <algorithm>
+#include <cstddef>
+#ifdef __SSE2__
+#include <immintrin.h>
+#endif
+
+namespace stock {
+
+	/* general matrix multiply C = alpha * op(A) * op(B) + beta * C.
+	 *
+	 * operands are given by a pointer and a row and a column stride, so row-major,
+	 * column-major and transposed operands are all read in place. the product is computed
+	 * in the usual three levels of blocking:
+	 *   nc columns of B (packed into panels of NR columns) are kept in L3,
+	 *   kc x mc of A (packed into panels of MR rows) is kept in L2,
+	 *   one kc x NR panel of B is streamed through L1 against an MR x NR block of C held in
+	 *   registers by the micro-kernel.
+	 * the micro-tiles of each block of C are distributed over threads. */
+
+	const size_t GEMM_L1_BYTES_ = 32 << 10;		// data cache sizes the blocking is tuned for
+	const size_t GEMM_L2_BYTES_ = 1 << 20;
+	const size_t GEMM_L3_BYTES_ = 8 << 20;
+
+	/* cache block sizes, in elements */
+	struct GemmBlocking {
+		size_t mc, kc, nc;
+		GemmBlocking(): mc(0), kc(0), nc(0) { }
+		GemmBlocking(size_t m, size_t k, size_t n): mc(m), kc(k), nc(n) { }
+	}; // struct GemmBlocking
+
+
+	/* micro-kernels: c[MR x NR] += alpha * a[kc x MR]^T * b[kc x NR], with a and b packed
+	 * so that each step p reads MR consecutive elements of a and NR consecutive of b,
+	 * and c stored with row stride ldc and unit column stride */
+
+	// ////
+	// generic kernel, also used for complex types
+	// ////
+	template <typename value_type>
+	struct GemmKernel {
+		static const size_t MR = 4;
+		static const size_t NR = 4;
+
+		static void run(size_t kc, const value_type* a, const value_type* b, value_type alpha,
+						value_type* c, size_t ldc) {
+			value_type acc[MR][NR];
+			for(size_t i = 0; i < MR; ++ i)
+				for(size_t j = 0; j < NR; ++ j) acc[i][j] = value_type(0);
+			for(size_t p = 0; p < kc; ++ p, a += MR, b += NR) {
+				for(size_t i = 0; i < MR; ++ i)
+					for(size_t j = 0; j < NR; ++ j) acc[i][j] += a[i] * b[j];
+			} // for
+			for(size_t i = 0; i < MR; ++ i)
+				for(size_t j = 0; j < NR; ++ j) c[i * ldc + j] += alpha * acc[i][j];
+		} // run()
+	}; // struct GemmKernel
+
+
+#if defined(__AVX512F__)
+	// ////
+	// double, avx-512: 8 x 16 block in 16 zmm accumulators
+	// ////
+	template <>
+	struct GemmKernel<double> {
+		static const size_t MR = 8;
+		static const size_t NR = 16;
+
+		static void run(size_t kc, const double* a, const double* b, double alpha, double* c, size_t ldc) {
+			__m512d acc[MR][2];
+			for(size_t i = 0; i < MR; ++ i) acc[i][0] = acc[i][1] = _mm512_setzero_pd();
+			for(size_t p = 0; p < kc; ++ p, a += MR, b += NR) {
+				__m512d b0 = _mm512_loadu_pd(b), b1 = _mm512_loadu_pd(b + 8);
+				for(size_t i = 0; i < MR; ++ i) {
+					__m512d ai = _mm512_set1_pd(a[i]);
+					acc[i][0] = _mm512_fmadd_pd(ai, b0, acc[i][0]);
+					acc[i][1] = _mm512_fmadd_pd(ai, b1, acc[i][1]);
+				} // for
+			} // for
+			__m512d va = _mm512_set1_pd(alpha);
+			for(size_t i = 0; i < MR; ++ i) {
+				double* ci = c + i * ldc;
+				_mm512_storeu_pd(ci, _mm512_fmadd_pd(va, acc[i][0], _mm512_loadu_pd(ci)));
+				_mm512_storeu_pd(ci + 8, _mm512_fmadd_pd(va, acc[i][1], _mm512_loadu_pd(ci + 8)));
+			} // for
+		} // run()
+	}; // struct GemmKernel
+
+	// ////
+	// float, avx-512: 8 x 32 block in 16 zmm accumulators
+	// ////
+	template <>
+	struct GemmKernel<float> {
+		static const size_t MR = 8;
+		static const size_t NR = 32;
+
+		static void run(size_t kc, const float* a, const float* b, float alpha, float* c, size_t ldc) {
+			__m512 acc[MR][2];
+			for(size_t i = 0; i < MR; ++ i) acc[i][0] = acc[i][1] = _mm512_setzero_ps();
+			for(size_t p = 0; p < kc; ++ p, a += MR, b += NR) {
+				__m512 b0 = _mm512_loadu_ps(b), b1 = _mm512_loadu_ps(b + 16);
+				for(size_t i = 0; i < MR; ++ i) {
+					__m512 ai = _mm512_set1_ps(a[i]);
+					acc[i][0] = _mm512_fmadd_ps(ai, b0, acc[i][0]);
+					acc[i][1] = _mm512_fmadd_ps(ai, b1, acc[i][1]);
+				} // for
+			} // for
+			__m512 va = _mm512_set1_ps(alpha);
+			for(size_t i = 0; i < MR; ++ i) {
+				float* ci = c + i * ldc;
+				_mm512_storeu_ps(ci, _mm512_fmadd_ps(va, acc[i][0], _mm512_loadu_ps(ci)));
+				_mm512_storeu_ps(ci + 16, _mm512_fmadd_ps(va, acc[i][1], _mm512_loadu_ps(ci + 16)));
+			} // for
+		} // run()
+	}; // struct GemmKernel
+
+#elif defined(__AVX__)
+	#ifdef __FMA__
+	#define GEMM_FMADD_PD_(a, b, c) _mm256_fmadd_pd(a, b, c)
+	#define GEMM_FMADD_PS_(a, b, c) _mm256_fmadd_ps(a, b, c)
+	#else
+	#define GEMM_FMADD_PD_(a, b, c) _mm256_add_pd(_mm256_mul_pd(a, b), c)
+	#define GEMM_FMADD_PS_(a, b, c) _mm256_add_ps(_mm256_mul_ps(a, b), c)
+	#endif
+
+	// ////
+	// double, avx: 6 x 8 block in 12 ymm accumulators
+	// ////
+	template <>
+	struct GemmKernel<double> {
+		static const size_t MR = 6;
+		static const size_t NR = 8;
+
+		static void run(size_t kc, const double* a, const double* b, double alpha, double* c, size_t ldc) {
+			__m256d acc[MR][2];
+			for(size_t i = 0; i < MR; ++ i) acc[i][0] = acc[i][1] = _mm256_setzero_pd();
+			for(size_t p = 0; p < kc; ++ p, a += MR, b += NR) {
+				__m256d b0 = _mm256_loadu_pd(b), b1 = _mm256_loadu_pd(b + 4);
+				for(size_t i = 0; i < MR; ++ i) {
+					__m256d ai = _mm256_broadcast_sd(a + i);
+					acc[i][0] = GEMM_FMADD_PD_(ai, b0, acc[i][0]);
+					acc[i][1] = GEMM_FMADD_PD_(ai, b1, acc[i][1]);
+				} // for
+			} // for
+			__m256d va = _mm256_set1_pd(alpha);
+			for(size_t i = 0; i < MR; ++ i) {
+				double* ci = c + i * ldc;
+				_mm256_storeu_pd(ci, GEMM_FMADD_PD_(va, acc[i][0], _mm256_loadu_pd(ci)));
+				_mm256_storeu_pd(ci + 4, GEMM_FMADD_PD_(va, acc[i][1], _mm256_loadu_pd(ci + 4)));
+			} // for
+		} // run()
+	}; // struct GemmKernel
+
+	// ////
+	// float, avx: 6 x 16 block in 12 ymm accumulators
+	// ////
+	template <>
+	struct GemmKernel<float> {
+		static const size_t MR = 6;
+		static const size_t NR = 16;
+
+		static void run(size_t kc, const float* a, const float* b, float alpha, float* c, size_t ldc) {
+			__m256 acc[MR][2];
+			for(size_t i = 0; i < MR; ++ i) acc[i][0] = acc[i][1] = _mm256_setzero_ps();
+			for(size_t p = 0; p < kc; ++ p, a += MR, b += NR) {
+				__m256 b0 = _mm256_loadu_ps(b), b1 = _mm256_loadu_ps(b + 8);
+				for(size_t i = 0; i < MR; ++ i) {
+					__m256 ai = _mm256_broadcast_ss(a + i);
+					acc[i][0] = GEMM_FMADD_PS_(ai, b0, acc[i][0]);
+					acc[i][1] = GEMM_FMADD_PS_(ai, b1, acc[i][1]);
+				} // for
+			} // for
+			__m256 va = _mm256_set1_ps(alpha);
+			for(size_t i = 0; i < MR; ++ i) {
+				float* ci = c + i * ldc;
+				_mm256_storeu_ps(ci, GEMM_FMADD_PS_(va, acc[i][0], _mm256_loadu_ps(ci)));
+				_mm256_storeu_ps(ci + 8, GEMM_FMADD_PS_(va, acc[i][1], _mm256_loadu_ps(ci + 8)));
+			} // for
+		} // run()
+	}; // struct GemmKernel
+
+	#undef GEMM_FMADD_PD_
+	#undef GEMM_FMADD_PS_
+
+#elif defined(__SSE2__)
+	// ////
+	// double, sse2: 4 x 4 block in 8 xmm accumulators
+	// ////
+	template <>
+	struct GemmKernel<double> {
+		static const size_t MR = 4;
+		static const size_t NR = 4;
+
+		static void run(size_t kc, const double* a, const double* b, double alpha, double* c, size_t ldc) {
+			__m128d acc[MR][2];
+			for(size_t i = 0; i < MR; ++ i) acc[i][0] = acc[i][1] = _mm_setzero_pd();
+			for(size_t p = 0; p < kc; ++ p, a += MR, b += NR) {
+				__m128d b0 = _mm_loadu_pd(b), b1 = _mm_loadu_pd(b + 2);
+				for(size_t i = 0; i < MR; ++ i) {
+					__m128d ai = _mm_set1_pd(a[i]);
+					acc[i][0] = _mm_add_pd(_mm_mul_pd(ai, b0), acc[i][0]);
+					acc[i][1] = _mm_add_pd(_mm_mul_pd(ai, b1), acc[i][1]);
+				} // for
+			} // for
+			__m128d va = _mm_set1_pd(alpha);
+			for(size_t i = 0; i < MR; ++ i) {
+				double* ci = c + i * ldc;
+				_mm_storeu_pd(ci, _mm_add_pd(_mm_mul_pd(va, acc[i][0]), _mm_loadu_pd(ci)));
+				_mm_storeu_pd(ci + 2, _mm_add_pd(_mm_mul_pd(va, acc[i][1]), _mm_loadu_pd(ci + 2)));
+			} // for
+		} // run()
+	}; // struct GemmKernel
+
+	// ////
+	// float, sse2: 4 x 8 block in 8 xmm accumulators
+	// ////
+	template <>
+	struct GemmKernel<float> {
+		static const size_t MR = 4;
+		static const size_t NR = 8;
+
+		static void run(size_t kc, const float* a, const float* b, float alpha, float* c, size_t ldc) {
+			__m128 acc[MR][2];
+			for(size_t i = 0; i < MR; ++ i) acc[i][0] = acc[i][1] = _mm_setzero_ps();
+			for(size_t p = 0; p < kc; ++ p, a += MR, b += NR) {
+				__m128 b0 = _mm_loadu_ps(b), b1 = _mm_loadu_ps(b + 4);
+				for(size_t i = 0; i < MR; ++ i) {
+					__m128 ai = _mm_set1_ps(a[i]);
+					acc[i][0] = _mm_add_ps(_mm_mul_ps(ai, b0), acc[i][0]);
+					acc[i][1] = _mm_add_ps(_mm_mul_ps(ai, b1), acc[i][1]);
+				} // for
+			} // for
+			__m128 va = _mm_set1_ps(alpha);
+			for(size_t i = 0; i < MR; ++ i) {
+				float* ci = c + i * ldc;
+				_mm_storeu_ps(ci, _mm_add_ps(_mm_mul_ps(va, acc[i][0]), _mm_loadu_ps(ci)));
+				_mm_storeu_ps(ci + 4, _mm_add_ps(_mm_mul_ps(va, acc[i][1]), _mm_loadu_ps(ci + 4)));
+			} // for
+		} // run()
+	}; // struct GemmKernel
+#endif
+
+
+	// ////
+	// block sizes from the cache sizes: a kc x MR panel of A and a kc x NR panel of B fill L1,
+	// an mc x kc block of A a quarter of L2, and a kc x nc block of B half of L3
+	// ////
+	template <typename value_type>
+	GemmBlocking gemm_blocking() {
+		typedef GemmKernel<value_type> kernel_t;
+		const size_t MR = kernel_t::MR, NR = kernel_t::NR;
+		size_t kc = std::max((size_t) 16, GEMM_L1_BYTES_ / ((MR + NR) * sizeof(value_type)) / 8 * 8);
+		size_t mc = std::max(MR, (GEMM_L2_BYTES_ / 4 / (kc * sizeof(value_type))) / MR * MR);
+		size_t nc = std::max(NR, (GEMM_L3_BYTES_ / 2 / (kc * sizeof(value_type))) / NR * NR);
+		return GemmBlocking(mc, kc, nc);
+	} // gemm_blocking()
+
+
+	// ////
+	// C = alpha * A * B + beta * C on strided operands. A is m x k, B is k x n, C is m x n,
+	// element (i, j) of X is at x[i * rs_x + j * cs_x]. C must not overlap A or B
+	// ////
+	template <typename value_type>
+	void gemm(size_t m, size_t n, size_t k, value_type alpha,
+				const value_type* a, ptrdiff_t rs_a, ptrdiff_t cs_a,
+				const value_type* b, ptrdiff_t rs_b, ptrdiff_t cs_b,
+				value_type beta, value_type* c, ptrdiff_t rs_c, ptrdiff_t cs_c,
+				GemmBlocking blocking = GemmBlocking()) {
+		typedef GemmKernel<value_type> kernel_t;
+		const size_t MR = kernel_t::MR, NR = kernel_t::NR;
+		if(m == 0 || n == 0) return;
+		// the kernels need unit column stride in C. for a column-major C compute C^T = B^T A^T
+		if(cs_c != 1 && rs_c == 1) {
+			std::swap(m, n);
+			std::swap(a, b);
+			std::swap(rs_a, cs_b);
+			std::swap(cs_a, rs_b);
+			std::swap(rs_c, cs_c);
+		} // if
+
+		// scale C by beta once, so the kernels only accumulate
+		if(beta != value_type(1)) {
+			#pragma omp parallel for schedule(static)
+			for(size_t i = 0; i < m; ++ i) {
+				for(size_t j = 0; j < n; ++ j) {
+					value_type& cij = c[i * rs_c + j * cs_c];
+					cij = (beta == value_type(0)) ? value_type(0) : beta * cij;
+				} // for
+			} // for
+		} // if
+		if(k == 0 || alpha == value_type(0)) return;
+
+		if(blocking.mc == 0 || blocking.kc == 0 || blocking.nc == 0) blocking = gemm_blocking<value_type>();
+		const size_t MC = std::max(MR, blocking.mc / MR * MR);
+		const size_t KC = blocking.kc;
+		const size_t NC = std::max(NR, blocking.nc / NR * NR);
+		// pack buffers no larger than the operands, small products are frequent in blocked factorizations
+		std::vector<value_type> a_pack(std::min(MC, (m + MR - 1) / MR * MR) * std::min(KC, k));
+		std::vector<value_type> b_pack(std::min(NC, (n + NR - 1) / NR * NR) * std::min(KC, k));
+		value_type* ap = &a_pack[0];
+		value_type* bp = &b_pack[0];
+		const bool direct_c = (cs_c == 1);
+
+		#pragma omp parallel
+		{
+			value_type edge[MR * NR];		// partial micro-tiles and C with non-unit column stride
+			for(size_t jc = 0; jc < n; jc += NC) {
+				size_t nc = std::min(NC, n - jc);
+				size_t n_panels = (nc + NR - 1) / NR;
+				for(size_t pc = 0; pc < k; pc += KC) {
+					size_t kc = std::min(KC, k - pc);
+
+					// pack B(pc : pc + kc, jc : jc + nc) into panels of NR columns, zero padded
+					#pragma omp for schedule(static)
+					for(size_t jp = 0; jp < n_panels; ++ jp) {
+						value_type* dst = bp + jp * NR * kc;
+						size_t j0 = jc + jp * NR, nr = std::min(NR, jc + nc - j0);
+						for(size_t p = 0; p < kc; ++ p) {
+							const value_type* src = b + (pc + p) * rs_b + j0 * cs_b;
+							for(size_t j = 0; j < nr; ++ j) dst[p * NR + j] = src[j * cs_b];
+							for(size_t j = nr; j < NR; ++ j) dst[p * NR + j] = value_type(0);
+						} // for
+					} // for
+
+					for(size_t ic = 0; ic < m; ic += MC) {
+						size_t mc = std::min(MC, m - ic);
+						size_t m_panels = (mc + MR - 1) / MR;
+
+						// pack A(ic : ic + mc, pc : pc + kc) into panels of MR rows, zero padded
+						#pragma omp for schedule(static)
+						for(size_t ip = 0; ip < m_panels; ++ ip) {
+							value_type* dst = ap + ip * MR * kc;
+							size_t i0 = ic + ip * MR, mr = std::min(MR, ic + mc - i0);
+							for(size_t p = 0; p < kc; ++ p) {
+								const value_type* src = a + i0 * rs_a + (pc + p) * cs_a;
+								for(size_t i = 0; i < mr; ++ i) dst[p * MR + i] = src[i * rs_a];
+								for(size_t i = mr; i < MR; ++ i) dst[p * MR + i] = value_type(0);
+							} // for
+						} // for
+
+						// micro-tiles of this block of C, consecutive tiles of a thread share a B panel
+						#pragma omp for collapse(2) schedule(static)
+						for(size_t jp = 0; jp < n_panels; ++ jp) {
+							for(size_t ip = 0; ip < m_panels; ++ ip) {
+								size_t i0 = ic + ip * MR, j0 = jc + jp * NR;
+								size_t mr = std::min(MR, m - i0), nr = std::min(NR, n - j0);
+								value_type* cij = c + i0 * rs_c + j0 * cs_c;
+								if(direct_c && mr == MR && nr == NR) {
+									kernel_t::run(kc, ap + ip * MR * kc, bp + jp * NR * kc, alpha, cij, rs_c);
+								} else {
+									for(size_t e = 0; e < MR * NR; ++ e) edge[e] = value_type(0);
+									kernel_t::run(kc, ap + ip * MR * kc, bp + jp * NR * kc, alpha, edge, NR);
+									for(size_t i = 0; i < mr; ++ i)
+										for(size_t j = 0; j < nr; ++ j) cij[i * rs_c + j * cs_c] += edge[i * NR + j];
+								} // if-else
+							} // for
+						} // for
+					} // for
+				} // for
+			} // for
+		}
+	} // gemm()
+
+
+	// ////
+	// strides of a matrix of a strided layout, or of its transpose
+	// ////
+	template <typename value_type, typename layout_t>
+	bool gemm_operand(const Matrix2D<value_type, layout_t>& mat, bool transpose,
+						ptrdiff_t& rs, ptrdiff_t& cs) {
+		long int row_stride = 0, col_stride = 0;
+		if(!mat.strides(row_stride, col_stride)) return false;
+		rs = transpose ? col_stride : row_stride;
+		cs = transpose ? row_stride : col_stride;
+		return true;
+	} // gemm_operand()
+
+
+	// ////
+	// copy mat into the packed row-major out of the same size, rows in parallel
+	// ////
+	template <typename value_type, typename layout_t>
+	void gemm_copy_row_major(const Matrix2D<value_type, layout_t>& mat, Matrix2D<value_type, RowMajor>& out) {
+		size_t rows = mat.num_rows(), cols = mat.num_cols();
+		value_type* dst = out.kernel_data();
+		#pragma omp parallel for schedule(static)
+		for(size_t i = 0; i < rows; ++ i)
+			for(size_t j = 0; j < cols; ++ j) dst[i * cols + j] = mat(i, j);
+	} // gemm_copy_row_major()
+
+
+	// ////
+	// C = alpha * op(A) * op(B) + beta * C, where op(X) is X, or X^T when transpose_x is set.
+	// transposed operands are read in place. operands of tiled layouts are multiplied
+	// through a row-major copy. with beta == 0, C is resized as needed. C may also be A or B
+	// ////
+	template <typename value_type, typename layout_a, typename layout_b, typename layout_c,
+				typename alpha_t, typename beta_t>
+	bool matrix_multiply(const Matrix2D<value_type, layout_a>& A, const Matrix2D<value_type, layout_b>& B,
+							Matrix2D<value_type, layout_c>& C, alpha_t alpha_in, beta_t beta_in,
+							bool transpose_a = false, bool transpose_b = false) {
+		value_type alpha = value_type(alpha_in), beta = value_type(beta_in);
+		size_t m = transpose_a ? A.num_cols() : A.num_rows();
+		size_t k = transpose_a ? A.num_rows() : A.num_cols();
+		size_t kb = transpose_b ? B.num_cols() : B.num_rows();
+		size_t n = transpose_b ? B.num_rows() : B.num_cols();
+		if(k != kb) {
+			std::cerr << "error: inner dimensions of matrices to multiply do not match" << std::endl;
+			return false;
+		} // if
+		if((C.num_rows() != m || C.num_cols() != n) && beta != value_type(0)) {
+			std::cerr << "error: dimensions of the product do not match the result matrix" << std::endl;
+			return false;
+		} // if
+		if((const void*) &C == (const void*) &A || (const void*) &C == (const void*) &B) {
+			// C is also an operand, which must not be resized or overwritten while it is read:
+			// compute into a separate matrix and swap it in
+			Matrix2D<value_type, layout_c> temp(m, n, C.padding(), C.storage());
+			if(beta != value_type(0)) temp = C;		// of the same size, copied in bulk
+			if(!matrix_multiply(A, B, temp, alpha, beta, transpose_a, transpose_b)) return false;
+			C.swap(temp);
+			return true;
+		} // if
+		if(C.num_rows() != m || C.num_cols() != n) C.resize(m, n);
+		ptrdiff_t rs_a, cs_a, rs_b, cs_b, rs_c, cs_c;
+		if(!gemm_operand(A, transpose_a, rs_a, cs_a)) {
+			Matrix2D<value_type, RowMajor> temp(A.num_rows(), A.num_cols());
+			gemm_copy_row_major(A, temp);
+			return matrix_multiply(temp, B, C, alpha, beta, transpose_a, transpose_b);
+		} // if
+		if(!gemm_operand(B, transpose_b, rs_b, cs_b)) {
+			Matrix2D<value_type, RowMajor> temp(B.num_rows(), B.num_cols());
+			gemm_copy_row_major(B, temp);
+			return matrix_multiply(A, temp, C, alpha, beta, transpose_a, transpose_b);
+		} // if
+		const value_type* a = &A[0];
+		const value_type* b = &B[0];
+		value_type* c = C.kernel_data();
+		if(!gemm_operand(C, false, rs_c, cs_c) || c == a || c == b) {
+			// tiled or aliased result: compute into a separate row-major matrix
+			Matrix2D<value_type, RowMajor> temp(m, n);
+			if(beta != value_type(0)) gemm_copy_row_major((const Matrix2D<value_type, layout_c>&) C, temp);
+			gemm(m, n, k, alpha, a, rs_a, cs_a, b, rs_b, cs_b, beta, temp.kernel_data(), (ptrdiff_t) n, (ptrdiff_t) 1);
+			return C.populate(temp.kernel_data());
+		} // if
+		gemm(m, n, k, alpha, a, rs_a, cs_a, b, rs_b, cs_b, beta, c, rs_c, cs_c);
+		return true;
+	} // matrix_multiply()
+
+	// ////
+	// C = A * B
+	// ////
+	template <typename value_type, typename layout_a, typename layout_b, typename layout_c>
+	bool matrix_multiply(const Matrix2D<value_type, layout_a>& A, const Matrix2D<value_type, layout_b>& B,
+							Matrix2D<value_type, layout_c>& C) {
+		return matrix_multiply(A, B, C, value_type(1), value_type(0));
+	} // matrix_multiply()
+
+} // namespace stock
+
+#endif // __GEMM_HPP__
@@ -23,7 +23,7 @@ namespace stock {
 	class DimensionIterator {
 		public:
 
-			DimensionIterator(unsigned int d, unsigned int size, unsigned int i, value_type* mat):
+			DimensionIterator(size_t d, size_t size, size_t i, value_type* mat):
 				dim_num_(d), dim_size_(size), dim_index_(i), dim_pointer_(mat) { }
 			~DimensionIterator() { }
 
@@ -32,20 +32,21 @@ namespace stock {
 
 		protected:
 
-			unsigned int dim_num_;			// dimension number
-			unsigned int dim_size_;			// size of the dimension
-			unsigned int dim_index_;		// index of the current dimension vector
+			size_t dim_num_;				// dimension number
+			size_t dim_size_;				// size of the dimension
+			size_t dim_index_;				// index of the current dimension vector
 			value_type* dim_pointer_;		// pointer to current dimension vector
 
 	}; // class DimensionIterator
 
 
 	/* column vector for Matrix2D */
-	template <typename value_type>
+	template <typename value_type, typename layout_t>
 	class ColumnIterator : public DimensionIterator <value_type> {
 		private:
-			Matrix2D<value_type>* parent_mat_;					// is iterator of this object
-			typename Matrix2D<value_type>::index_type index_;	// index in matrix
+			typedef Matrix2D<value_type, layout_t> matrix_t;
+			matrix_t* parent_mat_;								// is iterator of this object
+			typename matrix_t::index_type index_;				// index in matrix
 
 		public:
 			/* create an iterator pointing to column 0 */
@@ -55,12 +56,12 @@ namespace stock {
 				index_.idx_ = 0;
 			} // ColumnIterator()
 
-			ColumnIterator(unsigned int i, unsigned int num_rows, unsigned int num_cols,
-							Matrix2D<value_type>* mat): 
+			ColumnIterator(size_t i, size_t num_rows, size_t num_cols,
+							matrix_t* mat): 
 				DimensionIterator<value_type>(1, num_rows, i, mat->mat_) {
 				parent_mat_ = mat;
 				if(i >= num_cols) {
-					index_ = Matrix2D<value_type>::end_index;
+					index_ = matrix_t::end_index;
 				} else {
 					index_.num_ = i;
 					index_.idx_ = 0;
@@ -69,31 +70,29 @@ namespace stock {
 
 			/* increment to next column */
 			void operator++() {		// next column
-				if(index_ == Matrix2D<value_type>::end_index) {
+				if(index_ == matrix_t::end_index) {
 					// do nothing
 				} else if(index_.num_ == parent_mat_->num_cols_ - 1) {
-					index_ = Matrix2D<value_type>::end_index;
+					index_ = matrix_t::end_index;
 					this->dim_pointer_ = NULL;
 				} else {
 					++ index_.num_;
 					index_.idx_ = 0;
-					unsigned int index = index_.idx_ * parent_mat_->num_cols_ + index_.num_;
-					this->dim_pointer_ = &(parent_mat_->mat_[index]);
+					this->dim_pointer_ = &(*parent_mat_)(index_.idx_, index_.num_);
 				} // if-else
 			} // operator++()
 
 			/* decrement to previous column */
 			void operator--() {		// previous column
-				if(index_ == Matrix2D<value_type>::end_index) {
+				if(index_ == matrix_t::end_index) {
 					index_.num_ = parent_mat_->num_cols_ - 1;
 				} else if(index_.num_ == 0) {
-					index_ = Matrix2D<value_type>::begin_index;
+					index_ = matrix_t::begin_index;
 				} else if(index_.num_ != 0) {
 					-- index_.num_;
 				} // if-else
 				index_.idx_ = 0;
-				unsigned int index = index_.idx_ * parent_mat_->num_cols_ + index_.num_;
-				this->dim_pointer_ = &(parent_mat_->mat_[index]);
+				this->dim_pointer_ = &(*parent_mat_)(index_.idx_, index_.num_);
 			} // operator--()
 
 			/* assign a pointer to the iterator */
@@ -103,14 +102,13 @@ namespace stock {
 			} // operator=()
 
 			/* return the i-th element of current column */
-			value_type& operator[](unsigned int i) {
+			value_type& operator[](size_t i) {
 				if(i >= parent_mat_->num_rows_) {
 					// return the last element
-					return parent_mat_->mat_[(parent_mat_->num_rows_ - 1) * parent_mat_->num_cols_ +
-												parent_mat_->num_rows_ - 1];
+					return (*parent_mat_)(parent_mat_->num_rows_ - 1, parent_mat_->num_cols_ - 1);
 				} // if
 			//	index_.idx_ = i;
-				return parent_mat_->mat_[i * parent_mat_->num_cols_ + index_.num_];
+				return (*parent_mat_)(i, index_.num_);
 			} // operator[]()
 
 			/* comparison operators */
@@ -125,21 +123,21 @@ namespace stock {
 
 			/* return the value of current column's current index */
 			value_type value() const {
-				unsigned int index = index_.idx_ * parent_mat_->num_cols_ + index_.num_;
-				return parent_mat_->mat_[index];
+				return (*parent_mat_)(index_.idx_, index_.num_);
 			} // value()
 
-			unsigned int size() const { return parent_mat_->num_rows_; }
+			size_t size() const { return parent_mat_->num_rows_; }
 
 	}; // class ColumnIterator
 
 
 	/* row iterator for Matrix2D */
-	template <typename value_type>
+	template <typename value_type, typename layout_t>
 	class RowIterator : public DimensionIterator <value_type> {
 		private:
-			Matrix2D<value_type>* parent_mat_;					// is iterator of this object
-			typename Matrix2D<value_type>::index_type index_;	// index in matrix
+			typedef Matrix2D<value_type, layout_t> matrix_t;
+			matrix_t* parent_mat_;								// is iterator of this object
+			typename matrix_t::index_type index_;				// index in matrix
 
 		public:
 			/* create an iterator pointing to row 0 */
@@ -149,12 +147,12 @@ namespace stock {
 				index_.idx_ = 0;
 			} // ColumnIterator()
 
-			RowIterator(unsigned int i, unsigned int num_cols, unsigned int num_rows,
-							Matrix2D<value_type>* mat): 
+			RowIterator(size_t i, size_t num_cols, size_t num_rows,
+							matrix_t* mat): 
 				DimensionIterator<value_type>(1, num_cols, i, mat->mat_) {
 				parent_mat_ = mat;
 				if(i >= num_rows) {
-					index_ = Matrix2D<value_type>::end_index;
+					index_ = matrix_t::end_index;
 				} else {
 					index_.num_ = i;
 					index_.idx_ = 0;
@@ -163,31 +161,29 @@ namespace stock {
 
 			/* increment to next row */
 			void operator++() {
-				if(index_ == Matrix2D<value_type>::end_index) {
+				if(index_ == matrix_t::end_index) {
 					// do nothing
 				} else if(index_.num_ == parent_mat_->num_rows_ - 1) {
-					index_ = Matrix2D<value_type>::end_index;
+					index_ = matrix_t::end_index;
 					this->dim_pointer_ = NULL;
 				} else {
 					++ index_.num_;
 					index_.idx_ = 0;
-					unsigned int index = parent_mat_->num_cols_ * index_.num_ + index_.idx_;
-					this->dim_pointer_ = &(parent_mat_->mat_[index]);
+					this->dim_pointer_ = &(*parent_mat_)(index_.num_, index_.idx_);
 				} // if-else
 			} // operator++()
 
 			/* decrement to previous row */
 			void operator--() {		// previous column
-				if(index_ == Matrix2D<value_type>::end_index) {
+				if(index_ == matrix_t::end_index) {
 					index_.num_ = parent_mat_->num_rows_ - 1;
 				} else if(index_.num_ == 0) {
-					index_ = Matrix2D<value_type>::begin_index;
+					index_ = matrix_t::begin_index;
 				} else if(index_.num_ != 0) {
 					-- index_.num_;
 				} // if-else
 				index_.idx_ = 0;
-				unsigned int index = parent_mat_->num_cols_ * index_.num_ + index_.idx_;
-				this->dim_pointer_ = &(parent_mat_->mat_[index]);
+				this->dim_pointer_ = &(*parent_mat_)(index_.num_, index_.idx_);
 			} // operator--()
 
 			/* assign a pointer to the iterator */
@@ -197,13 +193,12 @@ namespace stock {
 			} // operator=()
 
 			/* return the i-th element of current row */
-			value_type& operator[](unsigned int i) {
+			value_type& operator[](size_t i) {
 				if(i >= parent_mat_->num_cols_) {
-					return parent_mat_->mat_[(parent_mat_->num_rows_ - 1) * parent_mat_->num_cols_ +
-												parent_mat_->num_cols_ - 1];
+					return (*parent_mat_)(parent_mat_->num_rows_ - 1, parent_mat_->num_cols_ - 1);
 				} // if
 			//	index_.idx_ = i;
-				return parent_mat_->mat_[index_.num_ * parent_mat_->num_cols_ + i];
+				return (*parent_mat_)(index_.num_, i);
 			} // operator[]()
 
 			/* comparison operators */
@@ -218,11 +213,10 @@ namespace stock {
 
 			/* return the value of current row's current index */
 			value_type value() const {
-				unsigned int index = index_.idx_ + parent_mat_->num_cols_ * index_.num_;
-				return parent_mat_->mat_[index];
+				return (*parent_mat_)(index_.num_, index_.idx_);
 			} // value()
 
-			unsigned int size() const { return parent_mat_->num_cols_; }
+			size_t size() const { return parent_mat_->num_cols_; }
 
 	}; // class RowIterator
 
@@ -0,0 +1,327 @@
+/**
+ *  Project: The Stock Libraries
+ *
+ *  File: kernels.hpp
+ *  Created: Oct 18, 2026
+ *
+ *  Author: Abhinav Sarje <abhinav.sarje@gmail.com>
+ *
+ *  Copyright (c) 2012-2017 Abhinav Sarje
+ *  Distributed under the Boost Software License.
+ *  See accompanying LICENSE file.
+ */
+
+#ifndef __KERNELS_HPP__
+#define __KERNELS_HPP__
+
+#include <algorithm>
+
+namespace stock {
+
+	static const size_t KERNEL_GRAIN_ = 4096;		// default number of elements per unit of work
+
+	/* scheduling of the element-wise kernels below.
+	 * grain is the number of elements given to a thread at a time, matrices of at most
+	 * grain elements are processed serially. with tile_rows and tile_cols set,
+	 * matrix_for_each_indexed() visits strided layouts in tiles of that size, so that
+	 * functors which also read the neighbourhood of (i, j) work on cached data.
+	 * tiled layouts are always visited one tile at a time */
+	struct KernelOptions {
+		size_t grain;
+		size_t tile_rows;
+		size_t tile_cols;
+
+		explicit KernelOptions(size_t g = KERNEL_GRAIN_, size_t rows = 0, size_t cols = 0):
+			grain((g > 0) ? g : 1), tile_rows(rows), tile_cols(cols) { }
+	}; // struct KernelOptions
+
+
+	// ////
+	// out[k] = f(in[k]) for num elements, in chunks of grain elements.
+	// each thread works on its own copy of f, whose inlined body is vectorized
+	// ////
+	template <typename in_t, typename out_t, typename func_t>
+	void kernel_map(const in_t* in, out_t* out, size_t num, func_t f, size_t grain) {
+		size_t num_chunks = (num + grain - 1) / grain;
+		#pragma omp parallel for schedule(static) firstprivate(f) if(num_chunks > 1)
+		for(size_t c = 0; c < num_chunks; ++ c) {
+			size_t begin = c * grain, end = std::min(num, begin + grain);
+			for(size_t k = begin; k < end; ++ k) out[k] = f(in[k]);
+		} // for
+	} // kernel_map()
+
+	// ////
+	// out[k] = f(a[k], b[k]) for num elements
+	// ////
+	template <typename a_t, typename b_t, typename out_t, typename func_t>
+	void kernel_zip_map(const a_t* a, const b_t* b, out_t* out, size_t num, func_t f, size_t grain) {
+		size_t num_chunks = (num + grain - 1) / grain;
+		#pragma omp parallel for schedule(static) firstprivate(f) if(num_chunks > 1)
+		for(size_t c = 0; c < num_chunks; ++ c) {
+			size_t begin = c * grain, end = std::min(num, begin + grain);
+			for(size_t k = begin; k < end; ++ k) out[k] = f(a[k], b[k]);
+		} // for
+	} // kernel_zip_map()
+
+	// ////
+	// the same over lines of len elements, which are ld apart in each buffer. used when the
+	// buffers have different leading dimensions or padded lines. chunks hold whole lines
+	// ////
+	template <typename in_t, typename out_t, typename func_t>
+	void kernel_map_lines(const in_t* in, size_t ld_in, out_t* out, size_t ld_out,
+							size_t lines, size_t len, func_t f, size_t grain) {
+		size_t per_chunk = std::max((size_t) 1, grain / std::max(len, (size_t) 1));
+		size_t num_chunks = (lines + per_chunk - 1) / per_chunk;
+		#pragma omp parallel for schedule(static) firstprivate(f) if(num_chunks > 1)
+		for(size_t c = 0; c < num_chunks; ++ c) {
+			size_t begin = c * per_chunk, end = std::min(lines, begin + per_chunk);
+			for(size_t l = begin; l < end; ++ l) {
+				const in_t* src = in + l * ld_in;
+				out_t* dst = out + l * ld_out;
+				for(size_t k = 0; k < len; ++ k) dst[k] = f(src[k]);
+			} // for
+		} // for
+	} // kernel_map_lines()
+
+	template <typename a_t, typename b_t, typename out_t, typename func_t>
+	void kernel_zip_map_lines(const a_t* a, size_t ld_a, const b_t* b, size_t ld_b, out_t* out, size_t ld_out,
+								size_t lines, size_t len, func_t f, size_t grain) {
+		size_t per_chunk = std::max((size_t) 1, grain / std::max(len, (size_t) 1));
+		size_t num_chunks = (lines + per_chunk - 1) / per_chunk;
+		#pragma omp parallel for schedule(static) firstprivate(f) if(num_chunks > 1)
+		for(size_t c = 0; c < num_chunks; ++ c) {
+			size_t begin = c * per_chunk, end = std::min(lines, begin + per_chunk);
+			for(size_t l = begin; l < end; ++ l) {
+				const a_t* src_a = a + l * ld_a;
+				const b_t* src_b = b + l * ld_b;
+				out_t* dst = out + l * ld_out;
+				for(size_t k = 0; k < len; ++ k) dst[k] = f(src_a[k], src_b[k]);
+			} // for
+		} // for
+	} // kernel_zip_map_lines()
+
+	// ////
+	// number and length of the contiguous lines of a strided layout
+	// ////
+	template <typename layout_t>
+	inline void kernel_lines(size_t nrows, size_t ncols, size_t& lines, size_t& len) {
+		bool row_major = (layout_t::kind == layout_row_major);
+		lines = row_major ? nrows : ncols;
+		len = row_major ? ncols : nrows;
+	} // kernel_lines()
+
+
+	/* size of the blocks visited by matrix_for_each_indexed(). a block row is contiguous
+	 * in row-major and tiled layouts, and a block column in column-major layout */
+	template <typename layout_t>
+	struct KernelBlock {
+		static void size(size_t nrows, size_t ncols, const KernelOptions& opts, size_t& rows, size_t& cols) {
+			if(opts.tile_rows > 0 && opts.tile_cols > 0) {
+				rows = opts.tile_rows;
+				cols = opts.tile_cols;
+			} else if(layout_t::kind == layout_column_major) {
+				rows = nrows;
+				cols = std::max((size_t) 1, opts.grain / std::max(nrows, (size_t) 1));
+			} else {
+				rows = std::max((size_t) 1, opts.grain / std::max(ncols, (size_t) 1));
+				cols = ncols;
+			} // if-else
+		} // size()
+	}; // struct KernelBlock
+
+	template <unsigned int TILE_ROWS, unsigned int TILE_COLS>
+	struct KernelBlock<Tiled<TILE_ROWS, TILE_COLS> > {
+		static void size(size_t, size_t, const KernelOptions&, size_t& rows, size_t& cols) {
+			rows = TILE_ROWS;
+			cols = TILE_COLS;
+		} // size()
+	}; // struct KernelBlock
+
+
+	// ////
+	// call f(i, j, element) for every element of a nrows x ncols buffer with leading
+	// dimension ld, one block at a time
+	// ////
+	template <typename layout_t, typename elem_t, typename func_t>
+	void kernel_for_each_indexed(elem_t* buffer, size_t nrows, size_t ncols, size_t ld, func_t f,
+									const KernelOptions& opts) {
+		if(nrows == 0 || ncols == 0) return;
+		size_t rows = 0, cols = 0;
+		KernelBlock<layout_t>::size(nrows, ncols, opts, rows, cols);
+		size_t block_rows = (nrows + rows - 1) / rows, block_cols = (ncols + cols - 1) / cols;
+		size_t num_blocks = block_rows * block_cols;
+		#pragma omp parallel for schedule(static) firstprivate(f) if(nrows * ncols > opts.grain)
+		for(size_t b = 0; b < num_blocks; ++ b) {
+			size_t i0 = (b / block_cols) * rows, j0 = (b % block_cols) * cols;
+			size_t i1 = std::min(nrows, i0 + rows), j1 = std::min(ncols, j0 + cols);
+			if(layout_t::kind == layout_column_major) {
+				for(size_t j = j0; j < j1; ++ j) {
+					elem_t* line = buffer + layout_t::index(i0, j, nrows, ncols, ld) - i0;
+					for(size_t i = i0; i < i1; ++ i) f(i, j, line[i]);
+				} // for
+			} else {
+				for(size_t i = i0; i < i1; ++ i) {
+					elem_t* line = buffer + layout_t::index(i, j0, nrows, ncols, ld) - j0;
+					for(size_t j = j0; j < j1; ++ j) f(i, j, line[j]);
+				} // for
+			} // if-else
+		} // for
+	} // kernel_for_each_indexed()
+
+
+	/* functors for kernel_for_each_indexed() which write into each element f of the elements
+	 * at the same (i, j) of buffers of the same layout and dimensions */
+	template <typename layout_t, typename in_t, typename func_t>
+	struct KernelMapAt {
+		const in_t* in_;
+		size_t nrows_, ncols_, ld_;
+		func_t f_;
+
+		KernelMapAt(const in_t* in, size_t nrows, size_t ncols, size_t ld, func_t f):
+			in_(in), nrows_(nrows), ncols_(ncols), ld_(ld), f_(f) { }
+
+		template <typename out_t>
+		void operator()(size_t i, size_t j, out_t& elem) {
+			elem = f_(in_[layout_t::index(i, j, nrows_, ncols_, ld_)]);
+		} // operator()()
+	}; // struct KernelMapAt
+
+	template <typename layout_t, typename a_t, typename b_t, typename func_t>
+	struct KernelZipMapAt {
+		const a_t* a_;
+		const b_t* b_;
+		size_t nrows_, ncols_, ld_a_, ld_b_;
+		func_t f_;
+
+		KernelZipMapAt(const a_t* a, size_t ld_a, const b_t* b, size_t ld_b, size_t nrows, size_t ncols, func_t f):
+			a_(a), b_(b), nrows_(nrows), ncols_(ncols), ld_a_(ld_a), ld_b_(ld_b), f_(f) { }
+
+		template <typename out_t>
+		void operator()(size_t i, size_t j, out_t& elem) {
+			elem = f_(a_[layout_t::index(i, j, nrows_, ncols_, ld_a_)], b_[layout_t::index(i, j, nrows_, ncols_, ld_b_)]);
+		} // operator()()
+	}; // struct KernelZipMapAt
+
+
+	// ////
+	// out(i, j) = f(in(i, j)) over nrows x ncols buffers of a layout. buffers without padding
+	// are mapped in bulk, others line by line, or one element at a time for tiled layouts,
+	// so that the padding of out stays zero
+	// ////
+	template <typename layout_t, typename in_t, typename out_t, typename func_t>
+	void kernel_map_matrix(const in_t* in, size_t ld_in, out_t* out, size_t ld_out, size_t nrows, size_t ncols,
+							func_t f, const KernelOptions& opts) {
+		size_t num = layout_t::size(nrows, ncols, ld_out);
+		if(ld_in == ld_out && num == nrows * ncols) {
+			kernel_map(in, out, num, f, opts.grain);
+		} else if(layout_t::pitched) {
+			size_t lines = 0, len = 0;
+			kernel_lines<layout_t>(nrows, ncols, lines, len);
+			kernel_map_lines(in, ld_in, out, ld_out, lines, len, f, opts.grain);
+		} else {
+			kernel_for_each_indexed<layout_t>(out, nrows, ncols, ld_out,
+												KernelMapAt<layout_t, in_t, func_t>(in, nrows, ncols, ld_in, f), opts);
+		} // if-else
+	} // kernel_map_matrix()
+
+	template <typename layout_t, typename a_t, typename b_t, typename out_t, typename func_t>
+	void kernel_zip_map_matrix(const a_t* a, size_t ld_a, const b_t* b, size_t ld_b, out_t* out, size_t ld_out,
+								size_t nrows, size_t ncols, func_t f, const KernelOptions& opts) {
+		size_t num = layout_t::size(nrows, ncols, ld_out);
+		if(ld_a == ld_out && ld_b == ld_out && num == nrows * ncols) {
+			kernel_zip_map(a, b, out, num, f, opts.grain);
+		} else if(layout_t::pitched) {
+			size_t lines = 0, len = 0;
+			kernel_lines<layout_t>(nrows, ncols, lines, len);
+			kernel_zip_map_lines(a, ld_a, b, ld_b, out, ld_out, lines, len, f, opts.grain);
+		} else {
+			kernel_for_each_indexed<layout_t>(out, nrows, ncols, ld_out,
+												KernelZipMapAt<layout_t, a_t, b_t, func_t>(a, ld_a, b, ld_b, nrows, ncols, f),
+												opts);
+		} // if-else
+	} // kernel_zip_map_matrix()
+
+
+	// ////
+	// element-wise kernels over Matrix2D, run in parallel with OpenMP.
+	// functors are copied to each thread, and are called concurrently on different elements.
+	// f is applied to the matrix elements only, the padding of the result stays zero
+	// ////
+
+	// ////
+	// mat(i, j) = f(mat(i, j)) for every element
+	// ////
+	template <typename value_type, typename layout_t, typename func_t>
+	bool matrix_map(Matrix2D<value_type, layout_t>& mat, func_t f,
+					const KernelOptions& opts = KernelOptions()) {
+		value_type* buffer = mat.kernel_data();
+		if(buffer == NULL) return false;
+		kernel_map_matrix<layout_t>(buffer, mat.leading_dim(), buffer, mat.leading_dim(), mat.num_rows(), mat.num_cols(),
+									f, opts);
+		return true;
+	} // matrix_map()
+
+	// ////
+	// out(i, j) = f(in(i, j)) for every element. out is resized when its dimensions differ
+	// ////
+	template <typename in_t, typename out_t, typename layout_t, typename func_t>
+	bool matrix_map(const Matrix2D<in_t, layout_t>& in, Matrix2D<out_t, layout_t>& out, func_t f,
+					const KernelOptions& opts = KernelOptions()) {
+		if(out.num_rows() != in.num_rows() || out.num_cols() != in.num_cols())
+			out.resize(in.num_rows(), in.num_cols());
+		out_t* out_mat = out.kernel_data();		// detached first, in case out shares a buffer with in
+		if(in.data() == NULL || out_mat == NULL) return false;
+		kernel_map_matrix<layout_t>(in.data(), in.leading_dim(), out_mat, out.leading_dim(), in.num_rows(), in.num_cols(),
+									f, opts);
+		return true;
+	} // matrix_map()
+
+	// ////
+	// out(i, j) = f(a(i, j), b(i, j)) for every element. a and b have equal dimensions,
+	// out is resized when its dimensions differ. out may be a or b
+	// ////
+	template <typename a_t, typename b_t, typename out_t, typename layout_t, typename func_t>
+	bool matrix_zip_map(const Matrix2D<a_t, layout_t>& a, const Matrix2D<b_t, layout_t>& b,
+						Matrix2D<out_t, layout_t>& out, func_t f,
+						const KernelOptions& opts = KernelOptions()) {
+		if(a.num_rows() != b.num_rows() || a.num_cols() != b.num_cols()) {
+			std::cerr << "error: matrices should have equal dimensions" << std::endl;
+			return false;
+		} // if
+		if(out.num_rows() != a.num_rows() || out.num_cols() != a.num_cols())
+			out.resize(a.num_rows(), a.num_cols());
+		out_t* out_mat = out.kernel_data();		// detached first, in case out shares a buffer with a or b
+		if(a.data() == NULL || b.data() == NULL || out_mat == NULL) return false;
+		kernel_zip_map_matrix<layout_t>(a.data(), a.leading_dim(), b.data(), b.leading_dim(), out_mat, out.leading_dim(),
+										a.num_rows(), a.num_cols(), f, opts);
+		return true;
+	} // matrix_zip_map()
+
+	// ////
+	// call f(i, j, mat(i, j)) for every element, padding excluded. the element is passed
+	// by reference and may be modified
+	// ////
+	template <typename value_type, typename layout_t, typename func_t>
+	bool matrix_for_each_indexed(Matrix2D<value_type, layout_t>& mat, func_t f,
+									const KernelOptions& opts = KernelOptions()) {
+		value_type* buffer = mat.kernel_data();
+		if(buffer == NULL) return false;
+		kernel_for_each_indexed<layout_t>(buffer, mat.num_rows(), mat.num_cols(), mat.leading_dim(), f, opts);
+		return true;
+	} // matrix_for_each_indexed()
+
+	// ////
+	// read-only version, f(i, j, const value_type&)
+	// ////
+	template <typename value_type, typename layout_t, typename func_t>
+	bool matrix_for_each_indexed(const Matrix2D<value_type, layout_t>& mat, func_t f,
+									const KernelOptions& opts = KernelOptions()) {
+		const value_type* buffer = mat.data();
+		if(buffer == NULL) return false;
+		kernel_for_each_indexed<layout_t>(buffer, mat.num_rows(), mat.num_cols(), mat.leading_dim(), f, opts);
+		return true;
+	} // matrix_for_each_indexed()
+
+} // namespace stock
+
+#endif // __KERNELS_HPP__
@@ -0,0 +1,195 @@
+/**
+ *  Project: The Stock Libraries
+ *
+ *  File: layout.hpp
+ *  Created: Oct 18, 2026
+ *
+ *  Author: Abhinav Sarje <abhinav.sarje@gmail.com>
+ *
+ *  Copyright (c) 2012-2017 Abhinav Sarje
+ *  Distributed under the Boost Software License.
+ *  See accompanying LICENSE file.
+ */
+
+#ifndef __LAYOUT_HPP__
+#define __LAYOUT_HPP__
+
+namespace stock {
+
+	enum MatrixLayoutKind {
+		layout_row_major,		/* rows are contiguous */
+		layout_column_major,	/* columns are contiguous */
+		layout_tiled			/* fixed size tiles are contiguous */
+	};
+
+	/* memory layout policies for Matrix2D.
+	 * index() maps (row, col) to the position in the buffer, position() is its inverse,
+	 * size() is the number of buffer elements needed for a rows x cols matrix,
+	 * strides() gives the row and column strides when the layout is strided.
+	 * strided layouts may have a leading dimension ld, the distance between consecutive
+	 * rows (row-major) or columns (column-major), larger than the packed one given by
+	 * leading(). the overloads taking ld address such padded buffers, layouts which have
+	 * no leading dimension (pitched is false) ignore it. */
+
+	/* row-major: element (i, j) at cols * i + j, or at ld * i + j with a leading dimension */
+	struct RowMajor {
+		static const MatrixLayoutKind kind = layout_row_major;
+		static const bool pitched = true;
+
+		static size_t leading(size_t, size_t cols) { return cols; }
+
+		static size_t index(size_t i, size_t j, size_t, size_t cols) {
+			return cols * i + j;
+		} // index()
+
+		static size_t index(size_t i, size_t j, size_t, size_t, size_t ld) {
+			return ld * i + j;
+		} // index()
+
+		static void position(size_t k, size_t, size_t cols, size_t& i, size_t& j) {
+			i = k / cols; j = k % cols;
+		} // position()
+
+		static void position(size_t k, size_t, size_t, size_t ld, size_t& i, size_t& j) {
+			i = k / ld; j = k % ld;
+		} // position()
+
+		static size_t size(size_t rows, size_t cols) { return rows * cols; }
+		static size_t size(size_t rows, size_t, size_t ld) { return rows * ld; }
+
+		static bool strides(size_t rows, size_t cols, long int& row_stride, long int& col_stride) {
+			return strides(rows, cols, cols, row_stride, col_stride);
+		} // strides()
+
+		static bool strides(size_t, size_t, size_t ld, long int& row_stride, long int& col_stride) {
+			row_stride = ld; col_stride = 1;
+			return true;
+		} // strides()
+	}; // struct RowMajor
+
+
+	/* column-major: element (i, j) at rows * j + i, or at ld * j + i with a leading dimension */
+	struct ColumnMajor {
+		static const MatrixLayoutKind kind = layout_column_major;
+		static const bool pitched = true;
+
+		static size_t leading(size_t rows, size_t) { return rows; }
+
+		static size_t index(size_t i, size_t j, size_t rows, size_t) {
+			return rows * j + i;
+		} // index()
+
+		static size_t index(size_t i, size_t j, size_t, size_t, size_t ld) {
+			return ld * j + i;
+		} // index()
+
+		static void position(size_t k, size_t rows, size_t, size_t& i, size_t& j) {
+			i = k % rows; j = k / rows;
+		} // position()
+
+		static void position(size_t k, size_t, size_t, size_t ld, size_t& i, size_t& j) {
+			i = k % ld; j = k / ld;
+		} // position()
+
+		static size_t size(size_t rows, size_t cols) { return rows * cols; }
+		static size_t size(size_t, size_t cols, size_t ld) { return ld * cols; }
+
+		static bool strides(size_t rows, size_t cols, long int& row_stride, long int& col_stride) {
+			return strides(rows, cols, rows, row_stride, col_stride);
+		} // strides()
+
+		static bool strides(size_t, size_t, size_t ld, long int& row_stride, long int& col_stride) {
+			row_stride = 1; col_stride = ld;
+			return true;
+		} // strides()
+	}; // struct ColumnMajor
+
+
+	/* tiled: the matrix is split into TILE_ROWS x TILE_COLS tiles stored one after the other
+	 * in row-major order of tiles, and each tile is stored row-major.
+	 * the matrix is padded to a whole number of tiles; padding is not part of the matrix */
+	template <unsigned int TILE_ROWS, unsigned int TILE_COLS = TILE_ROWS>
+	struct Tiled {
+		static const MatrixLayoutKind kind = layout_tiled;
+		static const bool pitched = false;
+		static const size_t tile_rows = TILE_ROWS;
+		static const size_t tile_cols = TILE_COLS;
+		static const size_t tile_size = TILE_ROWS * TILE_COLS;
+
+		static size_t leading(size_t, size_t cols) { return cols; }
+
+		static size_t index(size_t i, size_t j, size_t, size_t cols) {
+			size_t tiles_per_row = (cols + TILE_COLS - 1) / TILE_COLS;
+			return ((i / TILE_ROWS) * tiles_per_row + j / TILE_COLS) * tile_size +
+					(i % TILE_ROWS) * TILE_COLS + j % TILE_COLS;
+		} // index()
+
+		static size_t index(size_t i, size_t j, size_t rows, size_t cols, size_t) {
+			return index(i, j, rows, cols);
+		} // index()
+
+		static void position(size_t k, size_t, size_t cols, size_t& i, size_t& j) {
+			size_t tiles_per_row = (cols + TILE_COLS - 1) / TILE_COLS;
+			size_t tile = k / tile_size, r = k % tile_size;
+			i = (tile / tiles_per_row) * TILE_ROWS + r / TILE_COLS;
+			j = (tile % tiles_per_row) * TILE_COLS + r % TILE_COLS;
+		} // position()
+
+		static void position(size_t k, size_t rows, size_t cols, size_t, size_t& i, size_t& j) {
+			position(k, rows, cols, i, j);
+		} // position()
+
+		static size_t size(size_t rows, size_t cols) {
+			return ((rows + TILE_ROWS - 1) / TILE_ROWS) * ((cols + TILE_COLS - 1) / TILE_COLS) * tile_size;
+		} // size()
+
+		static size_t size(size_t rows, size_t cols, size_t) { return size(rows, cols); }
+
+		static bool strides(size_t, size_t, long int&, long int&) {
+			return false;
+		} // strides()
+
+		static bool strides(size_t, size_t, size_t, long int&, long int&) {
+			return false;
+		} // strides()
+	}; // struct Tiled
+
+	typedef Tiled<8> Tiled8x8;
+	typedef Tiled<64> Tiled64x64;
+
+	/* whether a buffer of layout l2_t has its elements at the positions layout l1_t expects.
+	 * void stands for a scalar, which has no layout */
+	template <typename l1_t, typename l2_t> struct SameLayout { static const bool value = false; };
+	template <typename l_t> struct SameLayout<l_t, l_t> { static const bool value = true; };
+	template <typename l_t> struct SameLayout<l_t, void> { static const bool value = true; };
+
+
+	/* padding of the leading dimension.
+	 * when the length of a line in bytes is a multiple of a large power of two (frames 1024
+	 * or 4096 wide), the elements of a walk across lines, such as a column of a row-major
+	 * matrix, are a multiple of the cache way size apart: they all fall in the same few cache
+	 * sets and at the same page offset, so they evict each other from the caches and alias in
+	 * the TLB and the store buffer. one extra cache line per line spreads them over all sets */
+	enum MatrixPadding {
+		padding_none,		/* lines are packed */
+		padding_auto		/* lines which would alias are padded by a cache line */
+	};
+
+	const size_t PADDING_LINE_BYTES_ = 64;		// padding added to an aliasing line
+	const size_t PADDING_ALIAS_BYTES_ = 512;	// lines of a multiple of this length alias
+
+	// ////
+	// leading dimension of a rows x cols matrix of elem_size byte elements under the policy
+	// ////
+	template <typename layout_t>
+	size_t padded_leading_dim(size_t rows, size_t cols, size_t elem_size, MatrixPadding padding) {
+		size_t ld = layout_t::leading(rows, cols);
+		if(padding == padding_none || !layout_t::pitched || elem_size == 0) return ld;
+		size_t bytes = ld * elem_size;
+		if(bytes < PADDING_ALIAS_BYTES_ || bytes % PADDING_ALIAS_BYTES_ != 0) return ld;
+		return ld + (PADDING_LINE_BYTES_ + elem_size - 1) / elem_size;
+	} // padded_leading_dim()
+
+} // namespace stock
+
+#endif // __LAYOUT_HPP__
@@ -0,0 +1,251 @@
+/**
+ *  Project: The Stock Libraries
+ *
+ *  File: mapped.hpp
+ *  Created: Oct 18, 2026
+ *
+ *  Author: Abhinav Sarje <abhinav.sarje@gmail.com>
+ *
+ *  Copyright (c) 2012-2017 Abhinav Sarje
+ *  Distributed under the Boost Software License.
+ *  See accompanying LICENSE file.
+ */
+
+#ifndef __MAPPED_HPP__
+#define __MAPPED_HPP__
+
+#include <iostream>
+#include <fcntl.h>
+#include <unistd.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+namespace stock {
+
+	enum MappedFileMode {
+		mapped_read_only,		/* writes to the matrix are not allowed */
+		mapped_read_write,		/* writes go to the file, which is created or extended as needed */
+		mapped_private			/* writes stay in memory, the file is not changed */
+	};
+
+	enum MappedAccess {
+		access_normal,			/* default kernel read-ahead */
+		access_sequential,		/* aggressive read-ahead, pages are dropped after use */
+		access_random			/* no read-ahead */
+	};
+
+
+	/* a region of a file mapped into memory. the page cache does the I/O:
+	 * pages are read on first access and dirty pages are written back by the kernel,
+	 * or on sync() */
+	class MappedFile {
+		private:
+			int fd_;
+			MappedFileMode mode_;
+			void* map_;				// start of the mapping, page aligned
+			size_t map_bytes_;		// length of the mapping
+			char* data_;			// start of the requested region inside the mapping
+			size_t bytes_;			// length of the requested region
+
+			// disable copying, the mapping has a single owner
+			MappedFile(const MappedFile&);
+			MappedFile& operator=(const MappedFile&);
+
+		public:
+			MappedFile(): fd_(-1), mode_(mapped_read_only), map_(NULL), map_bytes_(0), data_(NULL), bytes_(0) { }
+			~MappedFile() { close(); }
+
+			// ////
+			// map bytes of the file starting at offset. offset need not be page aligned.
+			// in read-write mode the file is created, or extended, to hold the region
+			// ////
+			bool open(const char* path, size_t bytes, MappedFileMode mode = mapped_read_only, size_t offset = 0) {
+				close();
+				int flags = (mode == mapped_read_write) ? (O_RDWR | O_CREAT) : O_RDONLY;
+				fd_ = ::open(path, flags, 0644);
+				if(fd_ < 0) {
+					std::cerr << "error: failed to open file " << path << " for mapping" << std::endl;
+					return false;
+				} // if
+				struct stat st;
+				if(fstat(fd_, &st) != 0) {
+					std::cerr << "error: failed to get size of file " << path << std::endl;
+					close();
+					return false;
+				} // if
+				if((size_t) st.st_size < offset + bytes) {
+					if(mode != mapped_read_write) {
+						std::cerr << "error: file " << path << " is too small for the matrix" << std::endl;
+						close();
+						return false;
+					} // if
+					if(ftruncate(fd_, offset + bytes) != 0) {
+						std::cerr << "error: failed to extend file " << path << std::endl;
+						close();
+						return false;
+					} // if
+				} // if
+				size_t page = (size_t) sysconf(_SC_PAGESIZE);
+				size_t map_offset = offset - offset % page;
+				map_bytes_ = bytes + (offset - map_offset);
+				int prot = (mode == mapped_read_only) ? PROT_READ : (PROT_READ | PROT_WRITE);
+				int share = (mode == mapped_private) ? MAP_PRIVATE : MAP_SHARED;
+				map_ = mmap(NULL, (map_bytes_ > 0) ? map_bytes_ : 1, prot, share, fd_, map_offset);
+				if(map_ == MAP_FAILED) {
+					std::cerr << "error: failed to map file " << path << std::endl;
+					map_ = NULL;
+					close();
+					return false;
+				} // if
+				mode_ = mode;
+				data_ = (char*) map_ + (offset - map_offset);
+				bytes_ = bytes;
+				return true;
+			} // open()
+
+			// ////
+			// unmap and close. dirty pages of shared mappings are still written back by the kernel
+			// ////
+			void close() {
+				if(map_ != NULL) munmap(map_, (map_bytes_ > 0) ? map_bytes_ : 1);
+				if(fd_ >= 0) ::close(fd_);
+				fd_ = -1;
+				map_ = NULL;
+				map_bytes_ = 0;
+				data_ = NULL;
+				bytes_ = 0;
+			} // close()
+
+			// ////
+			// access pattern hint for the whole region
+			// ////
+			bool advise(MappedAccess access) {
+				if(map_ == NULL) return false;
+				int advice = MADV_NORMAL;
+				if(access == access_sequential) advice = MADV_SEQUENTIAL;
+				else if(access == access_random) advice = MADV_RANDOM;
+				return madvise(map_, map_bytes_, advice) == 0;
+			} // advise()
+
+			// ////
+			// ask the kernel to start reading bytes at offset (relative to the region) in the background
+			// ////
+			bool prefetch(size_t offset, size_t bytes) {
+				if(map_ == NULL || offset >= bytes_) return false;
+				if(offset + bytes > bytes_) bytes = bytes_ - offset;
+				size_t page = (size_t) sysconf(_SC_PAGESIZE);
+				char* begin = data_ + offset;
+				char* aligned = (char*) map_ + ((begin - (char*) map_) / page) * page;
+				return madvise(aligned, bytes + (begin - aligned), MADV_WILLNEED) == 0;
+			} // prefetch()
+
+			// ////
+			// write dirty pages back to the file. with wait false the write back is only scheduled
+			// ////
+			bool sync(bool wait = true) {
+				if(map_ == NULL) return false;
+				if(mode_ != mapped_read_write) return true;
+				if(msync(map_, map_bytes_, wait ? MS_SYNC : MS_ASYNC) != 0) {
+					std::cerr << "error: failed to sync mapped file" << std::endl;
+					return false;
+				} // if
+				return true;
+			} // sync()
+
+			bool is_open() const { return map_ != NULL; }
+			MappedFileMode mode() const { return mode_; }
+			void* data() const { return data_; }
+			size_t size() const { return bytes_; }
+	}; // class MappedFile
+
+
+	/* holds the mapping of a MappedMatrix, so that the file is mapped before
+	 * the Matrix2D part is constructed around it */
+	class MappedFileMember {
+		protected:
+			MappedFile file_;
+
+			MappedFileMember(const char* path, size_t bytes, MappedFileMode mode, size_t offset) {
+				file_.open(path, bytes, mode, offset);
+			} // MappedFileMember()
+	}; // class MappedFileMember
+
+
+	/* a Matrix2D whose elements live in a memory-mapped file, stored according to layout_t
+	 * starting at offset bytes into the file. it can be passed wherever a Matrix2D is used.
+	 * operations which change the dimensions (insert, resize, transpose of a rectangular
+	 * tiled matrix) move the elements into memory, after which the file is no longer updated.
+	 * writing to a read-only mapped matrix is a segmentation fault */
+	template <typename value_type, typename layout_t = RowMajor>
+	class MappedMatrix : private MappedFileMember, public Matrix2D<value_type, layout_t> {
+		private:
+			// disable copying, copy into a Matrix2D instead
+			MappedMatrix(const MappedMatrix&);
+			MappedMatrix& operator=(const MappedMatrix&);
+
+		public:
+			// ////
+			// map a rows x cols matrix from the file. if mapping fails the matrix is
+			// allocated in memory instead and is_mapped() is false
+			// ////
+			MappedMatrix(const char* path, size_t rows, size_t cols,
+							MappedFileMode mode = mapped_read_only, size_t offset = 0):
+					MappedFileMember(path, layout_t::size(rows, cols) * sizeof(value_type), mode, offset),
+					Matrix2D<value_type, layout_t>(rows, cols, (value_type*) file_.data(), buffer_borrow) {
+			} // MappedMatrix()
+
+			~MappedMatrix() { }
+
+			// expressions of matching dimensions are evaluated directly into the file
+			using Matrix2D<value_type, layout_t>::operator=;
+
+			// ////
+			// whether the elements are still those in the file
+			// ////
+			bool is_mapped() const {
+				return file_.is_open() && this->data() == file_.data();
+			} // is_mapped()
+
+			MappedFile& file() { return file_; }
+
+			bool advise(MappedAccess access) {
+				if(!is_mapped()) return false;
+				return file_.advise(access);
+			} // advise()
+
+			bool sync(bool wait = true) {
+				if(!is_mapped()) return false;
+				return file_.sync(wait);
+			} // sync()
+
+			// ////
+			// start reading rows [begin, end) in the background, e.g. ahead of the rows being processed.
+			// for column-major layout each column segment is requested separately
+			// ////
+			bool prefetch_rows(size_t begin, size_t end) {
+				size_t rows = this->num_rows(), cols = this->num_cols(), ld = this->leading_dim();
+				if(end > rows) end = rows;
+				if(!is_mapped() || begin >= end) return false;
+				const size_t elem = sizeof(value_type);
+				if(layout_t::kind == layout_column_major) {
+					bool status = true;
+					for(size_t j = 0; j < cols; ++ j)
+						status &= file_.prefetch(layout_t::index(begin, j, rows, cols, ld) * elem, (end - begin) * elem);
+					return status;
+				} // if
+				// row-major rows, and tiled rows rounded to whole tile rows, are contiguous
+				size_t first = layout_t::index(begin, 0, rows, cols, ld);
+				first -= first % (layout_t::size(1, cols, ld));
+				size_t last = layout_t::size(end, cols, ld);
+				return file_.prefetch(first * elem, (last - first) * elem);
+			} // prefetch_rows()
+	}; // class MappedMatrix
+
+
+	/* mapped matrices take part in element-wise expressions like any Matrix2D */
+	template <typename data_t, typename layout_t>
+	struct ExpressionTraits<MappedMatrix<data_t, layout_t> > : public ExpressionTraits<Matrix2D<data_t, layout_t> > { };
+
+} // namespace stock
+
+#endif // __MAPPED_HPP__
@@ -14,11 +14,29 @@
 #include <vector>
 #include <cstring>
 #include <iostream>
+#include <utility>
 
 #ifndef __MATRIX_HPP__
 #define __MATRIX_HPP__
 
+#include "bulk.hpp"
+#include "storage.hpp"
+#include "view.hpp"
+#include "layout.hpp"
+#include "ranges.hpp"
+#include "transpose.hpp"
 #include "matrix_def.hpp"
 #include "iterators.hpp"
+#include "expressions.hpp"
+#include "reductions.hpp"
+#include "kernels.hpp"
+#include "stencil.hpp"
+#include "scan.hpp"
+#include "select.hpp"
+#include "gemm.hpp"
+#include "factor.hpp"
+#include "sparse.hpp"
+#include "mapped.hpp"
+#include "serialize.hpp"
 
 #endif // __MATRIX_HPP__
@@ -16,19 +16,39 @@
 
 namespace stock {
 
-	template <typename value_type> class ColumnIterator;
-	template <typename value_type> class RowIterator;
+	template <typename value_type, typename layout_t = RowMajor> class ColumnIterator;
+	template <typename value_type, typename layout_t = RowMajor> class RowIterator;
+	template <typename value_type> class MatrixView;
+	template <typename expr_t> class MatrixExpression;
+	template <typename value_type> struct MatrixStatistics;
+
+	enum MatrixBufferMode {
+		buffer_copy,		/* copy the given data into a new buffer */
+		buffer_adopt,		/* take ownership of the given buffer */
+		buffer_borrow		/* use the given buffer, the caller keeps ownership */
+	};
+
+	/* number of matrices sharing one buffer under copy-on-write */
+	struct MatrixShareCount {
+		long count_;
+		MatrixShareCount(): count_(1) { }
+	};
 
 	template <typename value_type>
 	class Matrix {
 		protected:
 			value_type *mat_;
 			unsigned int num_dims_;				// number of dimensions
-			std::vector<unsigned int> dims_;	// values of dimensions
-			unsigned int capacity_;
-
-			inline unsigned int total_elements() {
-				unsigned int tot_elems = 1;
+			std::vector<size_t> dims_;			// values of dimensions
+			size_t capacity_;
+			MatrixStorage* storage_;			// allocates and releases mat_ (not owned)
+			bool owner_;						// whether mat_ is released by this matrix
+			mutable MatrixShareCount* shared_;	// set while mat_ is shared with copies, NULL otherwise
+			bool copy_on_write_;				// whether copies share mat_ until one of them writes
+			bool exposed_;						// whether writable pointers into mat_ were handed out
+
+			inline size_t total_elements() {
+				size_t tot_elems = 1;
 				for(unsigned int i = 0; i < num_dims_; ++ i) tot_elems *= dims_[i];
 				return tot_elems;
 			} // total_elements()
@@ -38,7 +58,8 @@ namespace stock {
 			// ////
 			// default constructor: matrix size not known
 			// ////
-			Matrix(): mat_(NULL), num_dims_(0) {
+			Matrix(): mat_(NULL), num_dims_(0), capacity_(0), storage_(default_matrix_storage()), owner_(true),
+					shared_(NULL), copy_on_write_(false), exposed_(false) {
 			} // Matrix()
 
 
@@ -46,7 +67,18 @@ namespace stock {
 			// generic constructor
 			// ////
 			Matrix(unsigned int num_dims):
-					mat_(NULL), num_dims_(num_dims), capacity_(0) {
+					mat_(NULL), num_dims_(num_dims), capacity_(0), storage_(default_matrix_storage()), owner_(true),
+					shared_(NULL), copy_on_write_(false), exposed_(false) {
+			} // Matrix()
+
+
+			// ////
+			// constructor with a storage policy
+			// ////
+			Matrix(unsigned int num_dims, MatrixStorage* storage):
+					mat_(NULL), num_dims_(num_dims), capacity_(0), storage_(storage), owner_(true),
+					shared_(NULL), copy_on_write_(false), exposed_(false) {
+				if(storage_ == NULL) storage_ = default_matrix_storage();
 			} // Matrix()
 
 
@@ -54,61 +86,315 @@ namespace stock {
 			// destructor
 			// ////
 			~Matrix() {
-				if(mat_ != NULL) delete[] mat_;
-				mat_ = NULL;
+				release_buffer();
 			} // ~Matrix()
 
 
 			// ////
+			// allocate and release buffers through the storage policy
+			// ////
+			value_type* allocate(size_t size) {
+				return (value_type*) storage_->allocate(size * sizeof(value_type));
+			} // allocate()
+
+			void deallocate(value_type* buffer, size_t size) {
+				storage_->deallocate(buffer, size * sizeof(value_type));
+			} // deallocate()
+
+			// release a buffer of capacity elements from storage, unless it is not owned.
+			// a buffer shared through count is released by the last matrix using it
+			static void release_buffer(MatrixStorage* storage, value_type* buffer, size_t capacity,
+										MatrixShareCount* count, bool owner) {
+				if(buffer != NULL && count != NULL) {
+					if(__sync_sub_and_fetch(&count->count_, 1) == 0) {
+						storage->deallocate(buffer, capacity * sizeof(value_type));
+						delete count;
+					} // if
+				} else if(buffer != NULL && owner) storage->deallocate(buffer, capacity * sizeof(value_type));
+			} // release_buffer()
+
+			// release the current buffer
+			void release_buffer() {
+				release_buffer(storage_, mat_, capacity_, shared_, owner_);
+				shared_ = NULL;
+				mat_ = NULL;
+				capacity_ = 0;
+				owner_ = true;
+				exposed_ = false;
+			} // release_buffer()
+
+			// ////
+			// use the new owned buffer of capacity elements, from storage, in place of the
+			// current one. mat_ is changed by a single store, so that it is never seen NULL,
+			// and the old buffer is released only after that
+			// ////
+			void replace_buffer(value_type* buffer, size_t capacity, MatrixStorage* storage) {
+				MatrixStorage* old_storage = storage_;
+				value_type* old_buffer = mat_;
+				size_t old_capacity = capacity_;
+				MatrixShareCount* old_count = shared_;
+				bool old_owner = owner_;
+				mat_ = buffer;
+				capacity_ = capacity;
+				storage_ = storage;
+				shared_ = NULL;
+				owner_ = true;
+				exposed_ = false;
+				release_buffer(old_storage, old_buffer, old_capacity, old_count, old_owner);
+			} // replace_buffer()
+
+			void replace_buffer(value_type* buffer, size_t capacity) {
+				replace_buffer(buffer, capacity, storage_);
+			} // replace_buffer()
+
+
+			// ////
+			// ////
+			bool init(const std::vector<size_t>& dims) {
+				size_t tot_elems = 1;
+				for(size_t i = 0; i < dims.size(); ++ i) tot_elems *= dims[i];
+				return init(dims, tot_elems);
+			} // init()
+
+
+			// ////
+			// init with the number of buffer elements needed, which may be more than the
+			// number of matrix elements for padded layouts. zeroing can be skipped when
+			// every element is written next. the buffer is of exactly this size: rounding every
+			// buffer up to a power of two would put the same elements of different matrices in
+			// the same cache sets. grow() still doubles for amortized appends
 			// ////
-			bool init(const std::vector<unsigned int>& dims) {
+			bool init(const std::vector<size_t>& dims, size_t tot_elems, bool zero = true) {
 				if(dims.size() != num_dims_) {
 					std::cerr << "error: number of dimensions does not match list of dimension values"
 								<< std::endl;
 					return false;
 				} // if
 				dims_.clear();
-				unsigned int tot_elems = 1;
-				for(unsigned int i = 0; i < num_dims_; ++ i) {
-					dims_.push_back(dims[i]);
-					tot_elems *= dims[i];
-				} // for
-				unsigned int size = 256;
-				while(true) {
-					if(tot_elems <= size) {
-						tot_elems = size;
-						break;
-					} // if
-					size *= 2;
-				} // while
-				return reserve(size);
+				for(unsigned int i = 0; i < num_dims_; ++ i) dims_.push_back(dims[i]);
+				return reserve(std::max(tot_elems, (size_t) 1), zero);
 			} // init()
 
 
 			// ////
-			// reserve memory for given number of elements
+			// reserve memory for given number of elements, zeroed through the storage policy
+			// unless zero is false
 			// ////
-			bool reserve(unsigned int size) {
+			bool reserve(size_t size, bool zero = true) {
+				release_buffer();
 				capacity_ = size;
-				if(mat_ != NULL) delete[] mat_;
-				mat_ = new (std::nothrow) value_type[size];
+				mat_ = allocate(size);
 				if(mat_ == NULL) {
 					std::cerr << "error: failed to reserve memory for the matrix" << std::endl;
+					capacity_ = 0;
 					return false;
 				} // if
-				memset(mat_, 0, size * sizeof(value_type));
+				if(zero) storage_->initialize(mat_, size, sizeof(value_type));
 				return true;
 			} // reserve()
 
 
+			// ////
+			// grow capacity to at least size elements, preserving the first used elements.
+			// capacity is doubled so that repeated growth is amortized
+			// ////
+			bool grow(size_t size, size_t used) {
+				if(size <= capacity_) return true;
+				size_t new_capacity = (capacity_ > 0) ? capacity_ : 256;
+				while(new_capacity < size) new_capacity *= 2;
+				value_type* temp = allocate(new_capacity);
+				if(temp == NULL) {
+					std::cerr << "error: failed to grow memory for the matrix" << std::endl;
+					return false;
+				} // if
+				if(mat_ != NULL) bulk_copy(temp, mat_, used * sizeof(value_type));
+				replace_buffer(temp, new_capacity);
+				return true;
+			} // grow()
+
+
+			// ////
+			// change the storage policy. existing data is moved to a buffer from the new storage
+			// ////
+			bool set_storage(MatrixStorage* storage) {
+				if(storage == NULL) storage = default_matrix_storage();
+				if(storage == storage_) return true;
+				if(mat_ == NULL) {
+					storage_ = storage;
+					return true;
+				} // if
+				value_type* temp = (value_type*) storage->allocate(capacity_ * sizeof(value_type));
+				if(temp == NULL) {
+					std::cerr << "error: failed to allocate memory from the new storage" << std::endl;
+					return false;
+				} // if
+				bulk_copy(temp, mat_, capacity_ * sizeof(value_type));
+				replace_buffer(temp, capacity_, storage);
+				return true;
+			} // set_storage()
+
+
+			// ////
+			// take over an existing buffer of capacity elements, which is later released
+			// through the storage policy. the buffer must come from a compatible allocator
+			// ////
+			void adopt(value_type* buffer, size_t capacity) {
+				if(buffer == mat_) { owner_ = true; return; }
+				release_buffer();
+				mat_ = buffer;
+				capacity_ = capacity;
+				owner_ = true;
+			} // adopt()
+
+			// ////
+			// wrap an existing buffer without taking ownership. the caller keeps it alive,
+			// and any growth moves the data into a new buffer owned by the matrix
+			// ////
+			void borrow(value_type* buffer, size_t capacity) {
+				if(buffer == mat_) { owner_ = false; return; }
+				release_buffer();
+				mat_ = buffer;
+				capacity_ = capacity;
+				owner_ = false;
+			} // borrow()
+
+			// ////
+			// give up the buffer. the caller becomes responsible for releasing it
+			// (through storage()->deallocate() when it was owned)
+			// ////
+			value_type* release() {
+				if(!detach_buffer(capacity_)) return NULL;
+				value_type* buffer = mat_;
+				mat_ = NULL;
+				capacity_ = 0;
+				owner_ = true;
+				exposed_ = false;
+				return buffer;
+			} // release()
+
+			// ////
+			// exchange contents with another matrix, no elements are copied
+			// ////
+			void swap(Matrix& other) {
+				std::swap(mat_, other.mat_);
+				std::swap(num_dims_, other.num_dims_);
+				dims_.swap(other.dims_);
+				std::swap(capacity_, other.capacity_);
+				std::swap(storage_, other.storage_);
+				std::swap(owner_, other.owner_);
+				std::swap(shared_, other.shared_);
+				std::swap(copy_on_write_, other.copy_on_write_);
+				std::swap(exposed_, other.exposed_);
+			} // swap()
+
+
+			// ////
+			// copy-on-write: when enabled, copies of this matrix share its buffer and the
+			// elements are copied only when one of the sharing matrices is first written to
+			// (through non-const element access, data(), iterators, views or modifiers).
+			// copies of a copy-on-write matrix are copy-on-write as well. the rules:
+			// - only owned buffers are shared, borrowed and mapped buffers are always copied.
+			// - once a writable pointer, iterator, range or view into the buffer has been handed
+			//   out, later copies get their own buffer, since writes through it are not seen by
+			//   the matrix. this lasts until the buffer is next reallocated.
+			// - references returned by non-const element access are not to be kept across a copy.
+			//   such access copies a shared buffer even when it only reads, so shared matrices
+			//   are best read through a const reference.
+			// - the first write to a shared matrix from several threads at once must be
+			//   preceded by detach(). a detaching matrix switches to its new buffer with a
+			//   single store, but reading a matrix while another thread modifies it remains
+			//   a data race.
+			// ////
+			void set_copy_on_write(bool cow) { copy_on_write_ = cow; }
+			bool copy_on_write() const { return copy_on_write_; }
+
+			// whether the buffer is currently shared with other matrices
+			bool is_shared() const {
+				return shared_ != NULL && __sync_add_and_fetch(&shared_->count_, 0) > 1;
+			} // is_shared()
+
+			// number of matrices using the buffer
+			long use_count() const {
+				if(mat_ == NULL) return 0;
+				return (shared_ == NULL) ? 1 : __sync_add_and_fetch(&shared_->count_, 0);
+			} // use_count()
+
+
+		protected:
+
+			// ////
+			// use the buffer of other, which must be owned, instead of a copy of it.
+			// returns false, changing nothing, when the buffer cannot be shared
+			// ////
+			bool share(const Matrix& other) {
+				if(other.mat_ == NULL || !other.owner_ || other.exposed_) return false;
+				if(other.mat_ == mat_) return true;
+				#pragma omp critical (matrix_share)
+				{
+					if(other.shared_ == NULL) other.shared_ = new MatrixShareCount();
+					__sync_add_and_fetch(&other.shared_->count_, 1);
+				}
+				release_buffer();
+				mat_ = other.mat_;
+				capacity_ = other.capacity_;
+				storage_ = other.storage_;
+				owner_ = true;
+				shared_ = other.shared_;
+				return true;
+			} // share()
+
+			// ////
+			// give this matrix a private buffer before it is written to. when the buffer is
+			// shared the first used elements are copied into a new one, the rest is left
+			// uninitialized
+			// ////
+			bool detach_buffer(size_t used) {
+				if(shared_ == NULL) return true;
+				bool success = true;
+				#pragma omp critical (matrix_share)
+				{
+					if(shared_ != NULL && __sync_add_and_fetch(&shared_->count_, 0) == 1) {
+						// the other matrices are gone, the buffer is already private
+						delete shared_;
+						shared_ = NULL;
+					} else if(shared_ != NULL) {
+						value_type* temp = allocate(capacity_);
+						if(temp == NULL) {
+							std::cerr << "error: failed to allocate memory for copy-on-write" << std::endl;
+							success = false;
+						} else {
+							if(used > 0) bulk_copy(temp, mat_, used * sizeof(value_type));
+							replace_buffer(temp, capacity_);
+						} // if-else
+					} // if-else
+				}
+				return success;
+			} // detach_buffer()
+
+
+			// ////
+			// detach the buffer before a writable pointer into it is handed out. the buffer
+			// is not shared with later copies after that (see set_copy_on_write())
+			// ////
+			value_type* expose_buffer(size_t used) {
+				detach_buffer(used);
+				exposed_ = true;
+				return mat_;
+			} // expose_buffer()
+
+
+		public:
+
+
 			// ////
 			// if data is given, populate the matrix with it
 			// ////
 			bool populate(value_type* data) {
-				// just need to memcpy everything
-				unsigned int tot_elems = 1;
+				// just need to copy everything
+				size_t tot_elems = 1;
 				for(unsigned int i = 0; i < num_dims_; ++ i) tot_elems *= dims_[i];
-				memcpy(mat_, data, tot_elems * sizeof(value_type));
+				if(!detach_buffer(0)) return false;
+				bulk_copy(mat_, data, tot_elems * sizeof(value_type));
 				return true;
 			} // populate()
 
@@ -116,85 +402,176 @@ namespace stock {
 			// a few accessors
 			// ////
 			unsigned int dims() const { return num_dims_; }
-			unsigned int dim_size(unsigned int i) const { return dims_[i]; }
-			unsigned int capacity() const { return capacity_; }
+			size_t dim_size(unsigned int i) const { return dims_[i]; }
+			size_t capacity() const { return capacity_; }
+			MatrixStorage* storage() const { return storage_; }
+			bool owns_data() const { return owner_; }
 
-			value_type*& data() { return mat_; }
+			value_type*& data() { expose_buffer(capacity_); return mat_; }
+			const value_type* data() const { return mat_; }
+
+			// ////
+			// non-owning n-dimensional view over the whole matrix
+			// ////
+			MatrixView<value_type> view() {
+				return MatrixView<value_type>(expose_buffer(capacity_), dims_);
+			} // view()
 
 	}; // class Matrix
 
 
-	template <typename value_type>
+	/* 2D matrix, with elements arranged in memory according to layout_t (see layout.hpp) */
+	template <typename value_type, typename layout_t = RowMajor>
 	class Matrix2D : public Matrix <value_type> {
 		public:
 
-			typedef ColumnIterator<value_type> col_iterator;
-			typedef RowIterator<value_type> row_iterator;
+			typedef layout_t layout_type;
+			typedef ColumnIterator<value_type, layout_t> col_iterator;
+			typedef RowIterator<value_type, layout_t> row_iterator;
+			typedef typename LineRangeTraits<value_type, layout_t>::row_range row_range_type;
+			typedef typename LineRangeTraits<value_type, layout_t>::column_range column_range_type;
 
-			friend class ColumnIterator<value_type>;
-			friend class RowIterator<value_type>;
+			friend class ColumnIterator<value_type, layout_t>;
+			friend class RowIterator<value_type, layout_t>;
 
 			class IndexType {
 				public:
+					static const size_t npos = (size_t) -1;		// index of end_index
+
 					IndexType(): num_(0), idx_(0) { }
-					IndexType(int a, int b): num_(a), idx_(b) { }
+					IndexType(size_t a, size_t b): num_(a), idx_(b) { }
 					~IndexType() { }
 
 					bool operator==(IndexType other) {
 						return (other.num_ == num_ && other.idx_ == idx_);
 					} // operator==()
 
-					int num_;		// column/row number
-					int idx_;		// index within the column/row
+					size_t num_;	// column/row number
+					size_t idx_;	// index within the column/row
 			}; // class IndexType
 
 			typedef IndexType index_type;
-			static const index_type end_index; // = index_type(-1, -1);
+			static const index_type end_index; // = index_type(index_type::npos, index_type::npos);
 			static const index_type begin_index; // = index_type(0, 0);
 
 
 			// ////
 			// constructor: for empty matrix
 			// ////
-			Matrix2D(unsigned int rows, unsigned int cols):
+			Matrix2D(size_t rows, size_t cols):
 					Matrix<value_type>(2) {
 			//		end_index(-1, -1), begin_index(0, 0) {
 				num_rows_ = rows;
 				num_cols_ = cols;
-				std::vector<unsigned int> dims;
+				padding_ = padding_none;
+				ld_ = layout_t::leading(rows, cols);
+				std::vector<size_t> dims;
+				dims.push_back(num_rows_);
+				dims.push_back(num_cols_);
+				this->init(dims, layout_t::size(num_rows_, num_cols_));
+			} // Matrix2D()
+
+			// ////
+			// constructor: for empty matrix allocated from the given storage
+			// ////
+			Matrix2D(size_t rows, size_t cols, MatrixStorage* storage):
+					Matrix<value_type>(2, storage) {
+				num_rows_ = rows;
+				num_cols_ = cols;
+				padding_ = padding_none;
+				ld_ = layout_t::leading(rows, cols);
+				std::vector<size_t> dims;
+				dims.push_back(num_rows_);
+				dims.push_back(num_cols_);
+				this->init(dims, layout_t::size(num_rows_, num_cols_));
+			} // Matrix2D()
+
+			// ////
+			// constructor: for empty matrix whose leading dimension follows the padding policy,
+			// also when it is later resized (see padded_leading_dim() in layout.hpp)
+			// ////
+			Matrix2D(size_t rows, size_t cols, MatrixPadding padding, MatrixStorage* storage = NULL):
+					Matrix<value_type>(2, storage) {
+				num_rows_ = rows;
+				num_cols_ = cols;
+				padding_ = padding;
+				ld_ = leading_for(rows, cols);
+				std::vector<size_t> dims;
 				dims.push_back(num_rows_);
 				dims.push_back(num_cols_);
-				this->init(dims);
+				this->init(dims, storage_size());
 			} // Matrix2D()
 
 			// ////
 			// constructor: for prefilled matrix
 			// ////
-			Matrix2D(unsigned int rows, unsigned int cols, value_type* data):
+			Matrix2D(size_t rows, size_t cols, value_type* data):
 					Matrix<value_type>(2),
 			//		end_index(-1, -1), begin_index(0, 0),
-					num_rows_(rows), num_cols_(cols) {
-				std::vector<unsigned int> dims;
+					num_rows_(rows), num_cols_(cols),
+					ld_(layout_t::leading(rows, cols)), padding_(padding_none) {
+				std::vector<size_t> dims;
+				dims.push_back(rows);
+				dims.push_back(cols);
+				// populate() writes every element, only padding needs zeroing
+				this->init(dims, storage_size(), storage_size() != size());
+				populate(data);
+			} // Matrix2D()
+
+			// ////
+			// constructor: for an existing buffer, already arranged according to layout_t.
+			// adopted buffers are released through the given storage policy.
+			// leading_dim is the distance between rows (row-major) or columns (column-major)
+			// of the buffer, 0 when they are packed
+			// ////
+			Matrix2D(size_t rows, size_t cols, value_type* data, MatrixBufferMode mode,
+						MatrixStorage* storage = NULL, size_t leading_dim = 0):
+					Matrix<value_type>(2, storage),
+					num_cols_(cols), num_rows_(rows),
+					ld_(layout_t::leading(rows, cols)), padding_(padding_none) {
+				std::vector<size_t> dims;
 				dims.push_back(rows);
 				dims.push_back(cols);
-				this->init(dims);
-				this->populate(data);
+				if(leading_dim != 0 && leading_dim != ld_) {
+					if(!layout_t::pitched || leading_dim < ld_) {
+						std::cerr << "error: invalid leading dimension for the matrix buffer" << std::endl;
+						this->init(dims, storage_size());
+						return;
+					} // if
+					ld_ = leading_dim;
+				} // if
+				size_t size = storage_size();
+				if(mode == buffer_copy || data == NULL) {
+					this->init(dims, size, data == NULL || size != this->size());
+					if(data != NULL) bulk_copy(this->mat_, data, size * sizeof(value_type));
+					return;
+				} // if
+				this->dims_ = dims;
+				if(mode == buffer_adopt) this->adopt(data, size);
+				else this->borrow(data, size);
 			} // Matrix2D()
 
 			// ////
 			// copy constructor
 			// ////
 			Matrix2D(const Matrix2D& mat):
-					Matrix<value_type>(2) {
+					Matrix<value_type>(2, mat.storage_) {
 			//		end_index(-1, -1), begin_index(0, 0) {
 				num_rows_ = mat.num_rows_;
 				num_cols_ = mat.num_cols_;
+				ld_ = mat.ld_;
+				padding_ = mat.padding_;
 				this->num_dims_ = mat.num_dims_;
-				std::vector<unsigned int> dims;
+				std::vector<size_t> dims;
 				dims.push_back(num_rows_);
 				dims.push_back(num_cols_);
-				this->init(dims);
-				this->populate(mat.mat_);
+				this->copy_on_write_ = mat.copy_on_write_;
+				if(mat.copy_on_write_ && this->share(mat)) {
+					this->dims_ = dims;
+					return;
+				} // if
+				this->init(dims, storage_size(), false);
+				bulk_copy(this->mat_, mat.mat_, storage_size() * sizeof(value_type));
 			} // Matrix2D()
 
 
@@ -202,18 +579,108 @@ namespace stock {
 			// assignment operator
 			// ////
 			Matrix2D& operator=(const Matrix2D& mat) {
+				if(this == &mat) return *this;
 				num_rows_ = mat.num_rows_;
 				num_cols_ = mat.num_cols_;
+				ld_ = mat.ld_;
+				padding_ = mat.padding_;
 				this->num_dims_ = mat.num_dims_;
-				std::vector<unsigned int> dims;
+				std::vector<size_t> dims;
 				dims.push_back(num_rows_);
 				dims.push_back(num_cols_);
-				this->init(dims);
-				this->populate(mat.mat_);
+				this->copy_on_write_ = mat.copy_on_write_;
+				if(mat.copy_on_write_ && this->share(mat)) {
+					this->dims_ = dims;
+					return *this;
+				} // if
+				this->init(dims, storage_size(), false);
+				bulk_copy(this->mat_, mat.mat_, storage_size() * sizeof(value_type));
 				return *this;
 			} // Matrix2D()
 
 
+		#if __cplusplus >= 201103L
+			// ////
+			// move constructor: takes over the buffer, leaving mat a valid 0 x 0 matrix
+			// without a buffer
+			// ////
+			Matrix2D(Matrix2D&& mat) noexcept:
+					Matrix<value_type>(2, mat.storage_), num_cols_(0), num_rows_(0), ld_(0), padding_(padding_none) {
+				this->dims_.assign(2, 0);
+				swap(mat);
+			} // Matrix2D()
+
+			// ////
+			// move assignment, mat is left as after the move constructor
+			// ////
+			Matrix2D& operator=(Matrix2D&& mat) noexcept {
+				if(this == &mat) return *this;
+				Matrix2D temp(std::move(mat));
+				swap(temp);
+				return *this;
+			} // operator=()
+		#endif
+
+
+			// ////
+			// exchange contents with another matrix, no elements are copied
+			// ////
+			void swap(Matrix2D& mat) {
+				Matrix<value_type>::swap(mat);
+				std::swap(num_rows_, mat.num_rows_);
+				std::swap(num_cols_, mat.num_cols_);
+				std::swap(ld_, mat.ld_);
+				std::swap(padding_, mat.padding_);
+			} // swap()
+
+
+			// ////
+			// constructor: evaluate an element-wise expression
+			// ////
+			template <typename expr_t>
+			Matrix2D(const MatrixExpression<expr_t>& expr):
+					Matrix<value_type>(2), num_cols_(0), num_rows_(0), ld_(0), padding_(padding_none) {
+				*this = expr;
+			} // Matrix2D()
+
+
+			// ////
+			// assignment of an element-wise expression, evaluated in a single fused loop.
+			// when the operands have different leading dimensions, or a layout other than
+			// this one, the elements are combined by their (row, col) position instead
+			// ////
+			template <typename expr_t>
+			Matrix2D& operator=(const MatrixExpression<expr_t>& expr) {
+				const expr_t& e = expr.derived();
+				if(num_rows_ != e.num_rows() || num_cols_ != e.num_cols() || this->mat_ == NULL)
+					reshape(e.num_rows(), e.num_cols(), false);
+				// every element is written below, padding is not and is kept when detaching
+				else if(!this->detach_buffer(storage_size() == size() ? 0 : storage_size())) return *this;
+				value_type* mat = this->mat_;
+				bool same = SameLayout<layout_t, typename expr_t::layout_type>::value &&
+								(e.leading_dim() == ld_ || e.leading_dim() == 0);
+				size_t num = storage_size();
+				if(same && num == size()) {
+					#pragma omp parallel for schedule(static)
+					for(size_t i = 0; i < num; ++ i) mat[i] = e[i];
+					return *this;
+				} // if
+				if(same && layout_t::pitched) {
+					bool row_major = (layout_t::kind == layout_row_major);
+					size_t lines = row_major ? num_rows_ : num_cols_, len = row_major ? num_cols_ : num_rows_;
+					#pragma omp parallel for schedule(static)
+					for(size_t l = 0; l < lines; ++ l)
+						for(size_t k = l * ld_; k < l * ld_ + len; ++ k) mat[k] = e[k];
+					return *this;
+				} // if
+				#pragma omp parallel for schedule(static)
+				for(size_t i = 0; i < num_rows_; ++ i) {
+					for(size_t j = 0; j < num_cols_; ++ j) mat[index(i, j)] = e.at(i, j);
+				} // for
+				return *this;
+			} // operator=()
+
+
 			// ////
 			// destructor
 			// ////
@@ -228,7 +695,8 @@ namespace stock {
 			// ////
 			// iterator to column
 			// ////
-			col_iterator column(unsigned int i) {
+			col_iterator column(size_t i) {
+				expose();
 				if(i <= 0) {
 					col_iterator start_col(0, num_rows_, num_cols_, this);
 					return start_col;
@@ -245,6 +713,7 @@ namespace stock {
 			// iterator to first column
 			// ////
 			col_iterator begin_col() {
+				expose();
 				col_iterator start_col(0, num_rows_, num_cols_, this);
 				return start_col;
 			} // begin()
@@ -253,6 +722,7 @@ namespace stock {
 			// iterator to column after last (end_index)
 			// ////
 			col_iterator end_col() {
+				expose();
 				col_iterator last_col(num_cols_, num_rows_, num_cols_, this);
 				return last_col;
 			} // end()
@@ -261,7 +731,8 @@ namespace stock {
 			// ////
 			// iterator to row
 			// ////
-			row_iterator row(unsigned int i) {
+			row_iterator row(size_t i) {
+				expose();
 				if(i <= 0) {
 					row_iterator start_row(0, num_cols_, num_rows_, this);
 					return start_row;
@@ -270,7 +741,7 @@ namespace stock {
 					row_iterator last_row(num_rows_ - 1, num_cols_, num_rows_, this);
 					return last_row;
 				} // if
-				row_iterator row(i, num_cols_, num_cols_, this);
+				row_iterator row(i, num_cols_, num_rows_, this);
 				return row;
 			} // column()
 
@@ -278,6 +749,7 @@ namespace stock {
 			// iterator to first row
 			// ////
 			row_iterator begin_row() {
+				expose();
 				row_iterator start_row(0, num_cols_, num_rows_, this);
 				return start_row;
 			} // begin()
@@ -286,33 +758,191 @@ namespace stock {
 			// iterator to row after last (end_index)
 			// ////
 			row_iterator end_row() {
+				expose();
 				row_iterator last_row(num_rows_, num_cols_, num_rows_, this);
 				return last_row;
 			} // end()
 
 
+			// ////
+			// views (no copy)
+			// ////
+
+			// ////
+			// 2D view of the whole matrix. only strided layouts can be viewed,
+			// an empty view is returned for tiled layouts
+			// ////
+			MatrixView<value_type> view() {
+				expose();
+				long int row_stride = 0, col_stride = 0;
+				if(!strides(row_stride, col_stride)) {
+					std::cerr << "error: matrix layout cannot be represented as a strided view" << std::endl;
+					return MatrixView<value_type>();
+				} // if
+				std::vector<size_t> dims;
+				std::vector<long int> strides;
+				dims.push_back(num_rows_); dims.push_back(num_cols_);
+				strides.push_back(row_stride); strides.push_back(col_stride);
+				return MatrixView<value_type>(this->mat_, dims, strides);
+			} // view()
+
+			// ////
+			// view of row i
+			// ////
+			MatrixView<value_type> row_view(size_t i) {
+				return view().slice(0, i);
+			} // row_view()
+
+			// ////
+			// view of column i
+			// ////
+			MatrixView<value_type> column_view(size_t i) {
+				return view().slice(1, i);
+			} // column_view()
+
+			// ////
+			// random-access range over the elements of row i (see ranges.hpp)
+			// ////
+			row_range_type row_range(size_t i) {
+				if(i >= num_rows_) {
+					std::cerr << "error: row index out of range" << std::endl;
+					return row_range_type();
+				} // if
+				expose();
+				return LineRangeTraits<value_type, layout_t>::row(this->mat_, num_rows_, num_cols_, ld_, i);
+			} // row_range()
+
+			// ////
+			// random-access range over the elements of column j
+			// ////
+			column_range_type column_range(size_t j) {
+				if(j >= num_cols_) {
+					std::cerr << "error: column index out of range" << std::endl;
+					return column_range_type();
+				} // if
+				expose();
+				return LineRangeTraits<value_type, layout_t>::column(this->mat_, num_rows_, num_cols_, ld_, j);
+			} // column_range()
+
+			// ////
+			// view of the sub-block of size rows x cols starting at (row, col)
+			// ////
+			MatrixView<value_type> block_view(size_t row, size_t col,
+												size_t rows, size_t cols) {
+				std::vector<size_t> begin, sizes;
+				begin.push_back(row); begin.push_back(col);
+				sizes.push_back(rows); sizes.push_back(cols);
+				return view().block(begin, sizes);
+			} // block_view()
+
+
 			// ////
 			// accessors
 			// ////
 
-			unsigned int num_cols() const { return num_cols_; }
-			unsigned int num_rows() const { return num_rows_; }
-			unsigned int size() const { return num_cols_ * num_rows_; }
+			size_t num_cols() const { return num_cols_; }
+			size_t num_rows() const { return num_rows_; }
+			size_t size() const { return num_cols_ * num_rows_; }
+			// number of buffer elements used by the layout, including any padding
+			size_t storage_size() const { return layout_t::size(num_rows_, num_cols_, ld_); }
+
+			// ////
+			// leading dimension: distance in the buffer between consecutive rows (row-major) or
+			// columns (column-major). larger than num_cols() (num_rows()) when lines are padded
+			// ////
+			size_t leading_dim() const { return ld_; }
+			MatrixPadding padding() const { return padding_; }
+
+			// position of element (i, j) in the buffer
+			size_t index(size_t i, size_t j) const { return layout_t::index(i, j, num_rows_, num_cols_, ld_); }
+
+			// row and column strides of the buffer, false for layouts which are not strided
+			bool strides(long int& row_stride, long int& col_stride) const {
+				return layout_t::strides(num_rows_, num_cols_, ld_, row_stride, col_stride);
+			} // strides()
 
 			// ////
-			// access (i, j)-th element
+			// access (i, j)-th element. non-const access detaches a shared buffer, also when
+			// it only reads. the returned reference is not to be kept across a copy
 			// ////
-			value_type& operator()(unsigned int i, unsigned int j) const {
-				return this->mat_[num_cols_ * i + j];
+			value_type& operator()(size_t i, size_t j) {
+				detach();
+				return this->mat_[index(i, j)];
+			} // operator()()
+
+			const value_type& operator()(size_t i, size_t j) const {
+				return this->mat_[index(i, j)];
 			} // operator()()
 
 			// ////
 			// access an element through sequential indexing
+			// this indexes the buffer directly, in the order of the layout, padding included
 			// ////
-			value_type& operator[](unsigned int index) const {
+			value_type& operator[](size_t index) {
+				detach();
+				return this->mat_[index];
+			} // operator[]()
+
+			const value_type& operator[](size_t index) const {
 				return this->mat_[index];
 			} // operator[]()
 
+			// ////
+			// the buffer, in the order of the layout with lines leading_dim() apart.
+			// non-const access detaches a shared buffer, which is not shared with later copies
+			// ////
+			value_type*& data() { expose(); return this->mat_; }
+			const value_type* data() const { return this->mat_; }
+
+			// ////
+			// copy a shared buffer so that this matrix can be written to without
+			// affecting its copies (see set_copy_on_write())
+			// ////
+			bool detach() {
+				if(this->shared_ == NULL) return true;
+				return this->detach_buffer(storage_size());
+			} // detach()
+
+			// ////
+			// detach before a writable pointer, iterator or view into the buffer is handed out,
+			// after which later copies do not share the buffer
+			// ////
+			value_type* expose() {
+				return this->expose_buffer(storage_size());
+			} // expose()
+
+			// ////
+			// writable buffer for the kernels of this library, which do not keep it beyond the
+			// call. it is detached but, unlike data(), still shared with later copies
+			// ////
+			value_type* kernel_data() {
+				detach();
+				return this->mat_;
+			} // kernel_data()
+
+
+			// ////
+			// change the leading dimension, moving the elements into a new buffer. ld must be at
+			// least the packed one, layouts without a leading dimension only take the packed one.
+			// the padding policy applies again when the matrix is resized
+			// ////
+			bool set_leading_dim(size_t ld) {
+				if(ld == ld_) return true;
+				if(ld < layout_t::leading(num_rows_, num_cols_) || !layout_t::pitched) {
+					std::cerr << "error: invalid leading dimension for the matrix" << std::endl;
+					return false;
+				} // if
+				return relayout(ld);
+			} // set_leading_dim()
+
+			// ////
+			// change the padding policy, and the leading dimension accordingly
+			// ////
+			bool set_padding(MatrixPadding padding) {
+				padding_ = padding;
+				return relayout(leading_for(num_rows_, num_cols_));
+			} // set_padding()
+
 
 			// ////
 			// modifiers
@@ -322,44 +952,52 @@ namespace stock {
 			// fill matrix with a value
 			// ////
 			bool fill(value_type val) {
-				#pragma omp parallel for collapse(2) shared(val)
-				for(unsigned int i = 0; i < num_rows_; ++ i) {
-					for(unsigned int j = 0; j < num_cols_; ++ j) {
-						this->mat_[num_cols_ * i + j] = val;
-					} // for
-				} // for
+				if(storage_size() == size()) {
+					if(!this->detach_buffer(0)) return false;
+					bulk_fill(this->mat_, storage_size(), val);
+					return true;
+				} // if
+				// padding is not written, keep it when detaching
+				if(!this->detach_buffer(storage_size())) return false;
+				value_type* mat = this->mat_;
+				if(layout_t::pitched) {
+					bool row_major = (layout_t::kind == layout_row_major);
+					size_t lines = row_major ? num_rows_ : num_cols_, len = row_major ? num_cols_ : num_rows_;
+					#pragma omp parallel for schedule(static) if(storage_size() * sizeof(value_type) >= BULK_PARALLEL_BYTES_)
+					for(size_t l = 0; l < lines; ++ l) std::fill(mat + l * ld_, mat + l * ld_ + len, val);
+					return true;
+				} // if
+				#pragma omp parallel for schedule(static) if(storage_size() * sizeof(value_type) >= BULK_PARALLEL_BYTES_)
+				for(size_t i = 0; i < num_rows_; ++ i)
+					for(size_t j = 0; j < num_cols_; ++ j) mat[index(i, j)] = val;
 				return true;
 			} // fill()
 
-			/*// specializer for uint
-			bool fill(unsigned int val) {
-				if(val == 0) {
-					memset(this->mat_, 0, num_rows_ * num_cols_ * sizeof(unsigned int));
-				} else {
-					#pragma omp parallel for collapse(2) shared(val)
-					for(unsigned int i = 0; i < num_rows_; ++ i) {
-						for(unsigned int j = 0; j < num_cols_; ++ j) {
-							this->mat_[num_cols_ * i + j] = val;
-						} // for
-					} // for
-				} // if-else
-				return true;
-			} // fill()
 
-			// specializer for int
-			bool fill(int val) {
-				if(val == 0) {
-					memset(this->mat_, 0, num_rows_ * num_cols_ * sizeof(int));
-				} else {
-					#pragma omp parallel for collapse(2) shared(val)
-					for(unsigned int i = 0; i < num_rows_; ++ i) {
-						for(unsigned int j = 0; j < num_cols_; ++ j) {
-							this->mat_[num_cols_ * i + j] = val;
-						} // for
-					} // for
-				} // if-else
+			// ////
+			// populate the matrix from data given in row-major order
+			// ////
+			bool populate(value_type* data) {
+				// padding is not written, keep it when detaching
+				if(!this->detach_buffer(storage_size() == size() ? 0 : storage_size())) return false;
+				if(layout_t::kind == layout_row_major && ld_ == num_cols_) return Matrix<value_type>::populate(data);
+				if(layout_t::kind == layout_row_major) {
+					value_type* mat = this->mat_;
+					#pragma omp parallel for schedule(static)
+					for(size_t i = 0; i < num_rows_; ++ i)
+						memcpy(mat + i * ld_, data + i * num_cols_, num_cols_ * sizeof(value_type));
+					return true;
+				} // if
+				// the column-major buffer is the row-major transpose
+				if(layout_t::kind == layout_column_major)
+					return matrix_transpose(num_rows_, num_cols_, (const value_type*) data, num_cols_, this->mat_, ld_);
+				value_type* mat = this->mat_;
+				#pragma omp parallel for schedule(static)
+				for(size_t i = 0; i < num_rows_; ++ i) {
+					for(size_t j = 0; j < num_cols_; ++ j) mat[index(i, j)] = data[num_cols_ * i + j];
+				} // for
 				return true;
-			} // fill()*/
+			} // populate()
 
 			// ////
 			// insert stuff
@@ -368,85 +1006,116 @@ namespace stock {
 			// ////
 			// insert a new row
 			// ////
-			//bool insert_row(unsigned int i, const std::vector<value_type>& row) {
-			bool insert_row(unsigned int i, value_type* row, unsigned int size) {
+			//bool insert_row(size_t i, const std::vector<value_type>& row) {
+			bool insert_row(size_t i, value_type* row, size_t size) {
 				if(size != num_cols_) {
 					std::cerr << "error: mismatching row size during insertion ("
 								<< size << " != " << num_cols_ << ")" << std::endl;
 					return false;
 				} // if
-				if(i > num_rows_ + 1) {
+				return insert_rows(i, row, 1);
+			} // insert_row()
+
+
+			// ////
+			// insert num new rows at position i. rows holds num rows of num_cols_ elements each,
+			// if rows is NULL the new rows are initialized to zero.
+			// data is shifted in place when capacity allows
+			// ////
+			bool insert_rows(size_t i, const value_type* rows, size_t num) {
+				if(i > num_rows_) {
 					std::cerr << "error: position is greater than resulting number of rows" << std::endl;
 					return false;
 				} // if
-				unsigned int tot_elems = this->total_elements();
-				value_type* temp = NULL;
-				if(tot_elems + num_cols_ > this->capacity_) this->capacity_ *= 2;
-				// TODO: mem allocation can be easily avoided here when there is enough capacity
-				temp = new (std::nothrow) value_type[this->capacity_];
-				if(temp == NULL) {
+				if(num == 0) return true;
+				if(!detach()) return false;
+				bool success = false;
+				switch(layout_t::kind) {
+					case layout_row_major:
+						success = insert_major(i, rows, num, num_rows_, num_cols_, ld_);
+						break;
+					case layout_column_major:
+						// lines which are or become padded are rebuilt with the new leading dimension
+						if(ld_ == num_rows_ && leading_for(num_rows_ + num, num_cols_) == num_rows_ + num) {
+							success = insert_minor(i, rows, num, num_cols_, num_rows_);
+							ld_ = num_rows_;
+						} else success = insert_relayout(true, i, rows, num);
+						break;
+					default:
+						success = insert_relayout(true, i, rows, num);
+				} // switch
+				if(!success) {
 					std::cerr << "error: failed to resize memory during row insertion" << std::endl;
 					return false;
 				} // if
-				// copy all memory until row i
-				// copy new row
-				// copy remaining rows
-				memcpy(temp, this->mat_, i * num_cols_ * sizeof(value_type));
-				memcpy(temp + i * num_cols_, row, num_cols_ * sizeof(value_type));
-				memcpy(temp + (i + 1) * num_cols_, this->mat_ + i * num_cols_,
-						(num_rows_ - i) * num_cols_ * sizeof(value_type));
-				delete[] this->mat_;
-				this->mat_ = temp;
-				temp = NULL;
-				++ num_rows_;
-				++ this->dims_[0];
+				this->dims_[0] = num_rows_;
 
 				return true;
-			} // insert_row()
+			} // insert_rows()
 
 
 			// ////
 			// insert a new column
 			// ////
-			//bool insert_col(unsigned int i, const std::vector<value_type>& col) {
-			bool insert_col(unsigned int i, value_type* &col, unsigned int size) {
+			//bool insert_col(size_t i, const std::vector<value_type>& col) {
+			bool insert_col(size_t i, value_type* &col, size_t size) {
 				if(size != num_rows_) {
 					std::cerr << "error: mismatching column size during insertion ("
 								<< size << " != " << num_rows_ << ")" << std::endl;
 					return false;
 				} // if
-				if(i > num_cols_ + 1) {
+				return insert_cols(i, col, 1);
+			} // insert_col()
+
+
+			// ////
+			// insert num new columns at position i. cols holds num columns of num_rows_ elements
+			// each, one column after the other. if cols is NULL the new columns are set to zero.
+			// data is shifted in place when capacity allows
+			// ////
+			bool insert_cols(size_t i, const value_type* cols, size_t num) {
+				if(i > num_cols_) {
 					std::cerr << "error: position is greater than resulting number of columns" << std::endl;
 					return false;
 				} // if
-				unsigned int tot_elems = this->total_elements();
-				value_type* temp = NULL;
-				if(tot_elems + num_rows_ > this->capacity_) this->capacity_ *= 2;
-				// TODO: can mem allocation be avoided here when there is enough capacity?
-				temp = new (std::nothrow) value_type[this->capacity_];
-				if(temp == NULL) {
+				if(num == 0) return true;
+				if(!detach()) return false;
+				bool success = false;
+				switch(layout_t::kind) {
+					case layout_row_major:
+						// lines which are or become padded are rebuilt with the new leading dimension
+						if(ld_ == num_cols_ && leading_for(num_rows_, num_cols_ + num) == num_cols_ + num) {
+							success = insert_minor(i, cols, num, num_rows_, num_cols_);
+							ld_ = num_cols_;
+						} else success = insert_relayout(false, i, cols, num);
+						break;
+					case layout_column_major:
+						success = insert_major(i, cols, num, num_cols_, num_rows_, ld_);
+						break;
+					default:
+						success = insert_relayout(false, i, cols, num);
+				} // switch
+				if(!success) {
 					std::cerr << "error: failed to resize memory during column insertion" << std::endl;
 					return false;
 				} // if
-				// repeat for each row:
-				// copy memory until column i
-				// copy column i value
-				// copy remaining cols
-				for(unsigned int row = 0; row < num_rows_; ++ row) {
-					memcpy(temp + row * (num_cols_ + 1), this->mat_ + row * num_cols_,
-							i * sizeof(value_type));
-					memcpy(temp + row * (num_cols_ + 1) + i, col + row, sizeof(value_type));
-					memcpy(temp + row * (num_cols_ + 1) + i + 1, this->mat_ + row * num_cols_ + i,
-							(num_cols_ - i) * sizeof(value_type));
-				} // for
-				delete[] this->mat_;
-				this->mat_ = temp;
-				temp = NULL;
-				++ num_cols_;
-				++ this->dims_[1];
+				this->dims_[1] = num_cols_;
 
 				return true;
-			} // insert_col()
+			} // insert_cols()
+
+
+			// ////
+			// capacity hints: make room for the given total number of rows (or columns)
+			// so that appending up to that size does not reallocate
+			// ////
+			bool reserve_rows(size_t rows) {
+				return this->grow(layout_t::size(rows, num_cols_, leading_for(rows, num_cols_)), storage_size());
+			} // reserve_rows()
+
+			bool reserve_cols(size_t cols) {
+				return this->grow(layout_t::size(num_rows_, cols, leading_for(num_rows_, cols)), storage_size());
+			} // reserve_cols()
 
 
 			// ////
@@ -457,58 +1126,16 @@ namespace stock {
 			// increase rows - inserts num rows at the end
 			// preserves initial data, initializes new rows to zero
 			// ////
-			bool incr_rows(unsigned int num) {
-				num_rows_ += num;
-				this->dims_[0] += num;
-				unsigned int tot_elems = this->total_elements();
-				if(tot_elems > this->capacity_) {
-					this->capacity_ *= 2;
-					value_type* temp = new (std::nothrow) value_type[this->capacity_];
-					if(temp == NULL) {
-						std::cerr << "error: failed to resize memory during row insertion" << std::endl;
-						return false;
-					} // if
-					// copy all memory until row the original end
-					memcpy(temp, this->mat_, (num_rows_ - num) * num_cols_ * sizeof(value_type));
-					memset(temp + (num_rows_ - num) * num_cols_, 0, num * num_cols_ * sizeof(value_type));
-					delete[] this->mat_;
-					this->mat_ = temp;
-					temp = NULL;
-				} else {
-					memset(this->mat_ + (num_rows_ - num) * num_cols_, 0,
-							num * num_cols_ * sizeof(value_type));
-				} // if-else
-				return true;
+			bool incr_rows(size_t num) {
+				return insert_rows(num_rows_, NULL, num);
 			} // incr_rows()
 
 			// ////
 			// increase columns - inserts num elements at the end of each row (num cols)
 			// preserves initial data, initializes new cols to zero
 			// ////
-			bool incr_columns(unsigned int num) {
-				num_cols_ += num;
-				this->dims_[1] += num;
-				unsigned int tot_elems = this->total_elements();
-				if(tot_elems > this->capacity_) this->capacity_ *= 2;
-				// TODO: avoid mem allocation when possible
-				value_type* temp = new (std::nothrow) value_type[this->capacity_];
-				if(temp == NULL) {
-					std::cerr << "error: failed to resize memory during column insertion" << std::endl;
-					return false;
-				} // if
-				// repeat for each row:
-				// copy memory until original last column
-				// copy column i value
-				// copy remaining cols
-				for(unsigned int row = 0; row < num_rows_; ++ row) {
-					memcpy(temp + row * num_cols_, this->mat_ + row * (num_cols_ - num),
-							(num_cols_ - num) * sizeof(value_type));
-					memset(temp + row * num_cols_ + num_cols_ - num, 0, num * sizeof(value_type));
-				} // for
-				delete[] this->mat_;
-				this->mat_ = temp;
-				temp = NULL;
-				return true;
+			bool incr_columns(size_t num) {
+				return insert_cols(num_cols_, NULL, num);
 			} // incr_columns()
 
 
@@ -516,30 +1143,218 @@ namespace stock {
 			// resize the matrix to the new dimensions, and initializes to zero
 			// does NOT preserve any initial data
 			// ////
-			bool resize(unsigned int new_rows, unsigned int new_cols) {
+			bool resize(size_t new_rows, size_t new_cols) {
+				return reshape(new_rows, new_cols, true);
+			} // resize()
+
+
+			// ////
+			// transpose the matrix in place
+			// ////
+			bool transpose() {
+				bool success = true;
+				size_t new_ld = leading_for(num_cols_, num_rows_);
+				if((layout_t::kind != layout_row_major && layout_t::kind != layout_column_major) ||
+						ld_ != layout_t::leading(num_rows_, num_cols_) ||
+						new_ld != layout_t::leading(num_cols_, num_rows_)) {
+					// tiled or padded: every element is rewritten from a copy, which may share the buffer
+					const Matrix2D temp(*this);
+					if(layout_t::size(num_cols_, num_rows_, new_ld) <= this->capacity_) {
+						if(!this->detach_buffer(0)) return false;
+						std::swap(num_rows_, num_cols_);
+						ld_ = new_ld;
+						this->dims_[0] = num_rows_;
+						this->dims_[1] = num_cols_;
+						zero_padding();		// the reused buffer holds stale elements where the padding now is
+					} else if(!reshape(num_cols_, num_rows_, false)) return false;
+					value_type* mat = this->mat_;
+					#pragma omp parallel for schedule(static)
+					for(size_t i = 0; i < num_rows_; ++ i) {
+						for(size_t j = 0; j < num_cols_; ++ j) mat[index(i, j)] = temp(j, i);
+					} // for
+					return true;
+				} // if
+				if(!detach()) return false;
+				switch(layout_t::kind) {
+					case layout_row_major:
+						success = matrix_transpose_in(num_rows_, num_cols_, this->mat_);
+						break;
+					case layout_column_major:	// buffer is the row-major transpose
+						success = matrix_transpose_in(num_cols_, num_rows_, this->mat_);
+						break;
+					default:
+						break;
+				} // switch
+				if(!success) return false;
+				std::swap(num_rows_, num_cols_);
+				ld_ = new_ld;
+				this->dims_[0] = num_rows_;
+				this->dims_[1] = num_cols_;
+				return true;
+			} // transpose()
+
+
+		private:
+
+			// ////
+			// new buffer for the given dimensions, zeroed unless every element is written next
+			// ////
+			bool reshape(size_t new_rows, size_t new_cols, bool zero) {
 				num_rows_ = new_rows;
 				num_cols_ = new_cols;
+				ld_ = leading_for(new_rows, new_cols);
 				this->num_dims_ = 2;
-				std::vector<unsigned int> dims;
+				std::vector<size_t> dims;
 				dims.push_back(num_rows_);
 				dims.push_back(num_cols_);
-				this->init(dims);
-				memset(this->mat_, 0, new_rows * new_cols * sizeof(value_type));
+				// padding is zeroed even when every element is written next
+				return this->init(dims, storage_size(), zero || storage_size() != size());
+			} // reshape()
+
+			// ////
+			// leading dimension of a rows x cols matrix under the padding policy of this one
+			// ////
+			size_t leading_for(size_t rows, size_t cols) const {
+				return padded_leading_dim<layout_t>(rows, cols, sizeof(value_type), padding_);
+			} // leading_for()
+
+			// ////
+			// zero the buffer elements which are not matrix elements: the end of each line past
+			// the matrix, or the whole buffer for layouts without a leading dimension, whose
+			// elements are all written next
+			// ////
+			void zero_padding() {
+				if(storage_size() == size()) return;
+				if(!layout_t::pitched) {
+					bulk_zero(this->mat_, storage_size() * sizeof(value_type));
+					return;
+				} // if
+				bool row_major = (layout_t::kind == layout_row_major);
+				size_t lines = row_major ? num_rows_ : num_cols_, len = row_major ? num_cols_ : num_rows_;
+				value_type* mat = this->mat_;
+				#pragma omp parallel for schedule(static) if(storage_size() * sizeof(value_type) >= BULK_PARALLEL_BYTES_)
+				for(size_t l = 0; l < lines; ++ l) memset(mat + l * ld_ + len, 0, (ld_ - len) * sizeof(value_type));
+			} // zero_padding()
+
+			// ////
+			// move the elements into a new buffer with leading dimension ld, padding zeroed
+			// ////
+			bool relayout(size_t ld) {
+				if(ld == ld_) return true;
+				size_t new_size = layout_t::size(num_rows_, num_cols_, ld);
+				value_type* temp = this->allocate(std::max(new_size, (size_t) 1));
+				if(temp == NULL) {
+					std::cerr << "error: failed to allocate memory for the new leading dimension" << std::endl;
+					return false;
+				} // if
+				if(new_size != size()) bulk_zero(temp, new_size * sizeof(value_type));
+				bool row_major = (layout_t::kind == layout_row_major);
+				size_t lines = row_major ? num_rows_ : num_cols_, len = row_major ? num_cols_ : num_rows_;
+				const value_type* mat = this->mat_;
+				#pragma omp parallel for schedule(static)
+				for(size_t l = 0; l < lines; ++ l) memcpy(temp + l * ld, mat + l * ld_, len * sizeof(value_type));
+				this->replace_buffer(temp, std::max(new_size, (size_t) 1));
+				ld_ = ld;
 				return true;
-			} // resize()
+			} // relayout()
 
+			// ////
+			// insertion helpers for strided layouts, in terms of the major (contiguous) dimension
+			// with num_major lines of num_minor elements each.
+			// new data holds num lines of the inserted dimension one after the other
+			// ////
 
-		private:
-			unsigned int num_cols_;		// number of columns = row size
-			unsigned int num_rows_;		// number of rows = col size
+			// ////
+			// insert num major lines at position i: shift the later lines. lines are ld apart
+			// ////
+			bool insert_major(size_t i, const value_type* data, size_t num,
+								size_t& num_major, size_t num_minor, size_t ld) {
+				if(!this->grow((num_major + num) * ld, num_major * ld)) return false;
+				if(i < num_major)		// the buffer may still be NULL when there is nothing to shift
+					memmove(this->mat_ + (i + num) * ld, this->mat_ + i * ld,
+							(num_major - i) * ld * sizeof(value_type));
+				if(data == NULL) bulk_zero(this->mat_ + i * ld, num * ld * sizeof(value_type));
+				else if(ld == num_minor) bulk_copy(this->mat_ + i * ld, data, num * ld * sizeof(value_type));
+				else {
+					for(size_t k = 0; k < num; ++ k) {
+						value_type* line = this->mat_ + (i + k) * ld;
+						memcpy(line, data + k * num_minor, num_minor * sizeof(value_type));
+						memset(line + num_minor, 0, (ld - num_minor) * sizeof(value_type));
+					} // for
+				} // if-else
+				num_major += num;
+				return true;
+			} // insert_major()
+
+			// ////
+			// insert num minor lines at position i: spread out every major line
+			// ////
+			bool insert_minor(size_t i, const value_type* data, size_t num,
+								size_t num_major, size_t& num_minor) {
+				size_t new_minor = num_minor + num;
+				if(!this->grow(num_major * new_minor, num_major * num_minor)) return false;
+				// repeat for each major line, last to first so that no line is overwritten before moving:
+				// move the elements after i
+				// move the elements before i
+				// copy new values
+				for(size_t line = num_major; line > 0; -- line) {
+					value_type* src = this->mat_ + (line - 1) * num_minor;
+					value_type* dst = this->mat_ + (line - 1) * new_minor;
+					memmove(dst + i + num, src + i, (num_minor - i) * sizeof(value_type));
+					memmove(dst, src, i * sizeof(value_type));
+					if(data == NULL) {
+						memset(dst + i, 0, num * sizeof(value_type));
+					} else {
+						for(size_t c = 0; c < num; ++ c) dst[i + c] = data[c * num_major + line - 1];
+					} // if-else
+				} // for
+				num_minor = new_minor;
+				return true;
+			} // insert_minor()
+
+			// ////
+			// insertion for non-strided layouts: rebuild into a new buffer
+			// ////
+			bool insert_relayout(bool rows, size_t i, const value_type* data, size_t num) {
+				size_t new_rows = num_rows_ + (rows ? num : 0);
+				size_t new_cols = num_cols_ + (rows ? 0 : num);
+				size_t new_ld = leading_for(new_rows, new_cols);
+				size_t new_size = layout_t::size(new_rows, new_cols, new_ld);
+				size_t new_capacity = (this->capacity_ > 0) ? this->capacity_ : 256;
+				while(new_capacity < new_size) new_capacity *= 2;
+				value_type* temp = this->allocate(new_capacity);
+				if(temp == NULL) return false;
+				bulk_zero(temp, new_size * sizeof(value_type));
+				for(size_t r = 0; r < new_rows; ++ r) {
+					for(size_t c = 0; c < new_cols; ++ c) {
+						size_t k = rows ? r : c;		// index along the inserted dimension
+						value_type* out = temp + layout_t::index(r, c, new_rows, new_cols, new_ld);
+						if(k < i) *out = (*this)(r, c);
+						else if(k >= i + num) *out = rows ? (*this)(r - num, c) : (*this)(r, c - num);
+						else if(data != NULL) *out = rows ? data[(r - i) * num_cols_ + c] :
+																data[(c - i) * num_rows_ + r];
+					} // for
+				} // for
+				this->replace_buffer(temp, new_capacity);
+				num_rows_ = new_rows;
+				num_cols_ = new_cols;
+				ld_ = new_ld;
+				return true;
+			} // insert_relayout()
+
+			size_t num_cols_;			// number of columns = row size
+			size_t num_rows_;			// number of rows = col size
+			size_t ld_;					// leading dimension, see leading_dim()
+			MatrixPadding padding_;		// how ld_ is chosen when the matrix is reshaped
 
 	}; // class Matrix2D
 
 	
-	template <typename value_type>
-	const typename Matrix2D<value_type>::index_type Matrix2D<value_type>::begin_index(0, 0);
-	template <typename value_type>
-	const typename Matrix2D<value_type>::index_type Matrix2D<value_type>::end_index(-1, -1);
+	template <typename value_type, typename layout_t>
+	const typename Matrix2D<value_type, layout_t>::index_type Matrix2D<value_type, layout_t>::begin_index(0, 0);
+	template <typename value_type, typename layout_t>
+	const typename Matrix2D<value_type, layout_t>::index_type Matrix2D<value_type, layout_t>::end_index(
+				Matrix2D<value_type, layout_t>::index_type::npos, Matrix2D<value_type, layout_t>::index_type::npos);
 
 	// ////
 	// begin and end index_type constants
@@ -564,39 +1379,86 @@ namespace stock {
 	// ////
 	// other functions involving above defined matrices
 	// ////
+	// ////
+	// swap two matrices without copying elements
+	// ////
+	template <typename value_type, typename layout_t>
+	inline void swap(Matrix2D<value_type, layout_t>& a, Matrix2D<value_type, layout_t>& b) {
+		a.swap(b);
+	} // swap()
+
+
 	// ////
 	// matrix addition: c = a + b
+	// all matrices have the same layout so the buffers are added directly,
+	// unless their leading dimensions differ
 	// ////
-	template <typename value_type>
-	static bool matrix_add(Matrix2D<value_type>& a, Matrix2D<value_type>& b, Matrix2D<value_type>& c) {
-		unsigned int nrows = a.num_rows();
-		unsigned int ncols = a.num_cols();
+	template <typename value_type, typename layout_t>
+	static bool matrix_add(const Matrix2D<value_type, layout_t>& a, const Matrix2D<value_type, layout_t>& b,
+							Matrix2D<value_type, layout_t>& c) {
+		size_t nrows = a.num_rows();
+		size_t ncols = a.num_cols();
 		if(nrows != b.num_rows() || nrows != c.num_rows() ||
 				ncols != b.num_cols() || ncols != c.num_cols()) {
 			std::cerr << "error: matrices should have equal dimensions" << std::endl;
 			return false;
 		} // if
 
-		value_type *a_mat, *b_mat, *c_mat;
-		a_mat = a.data(); b_mat = b.data(); c_mat = c.data();
-		#pragma omp parallel for
-		for(unsigned int i = 0; i < nrows * ncols; ++ i) c_mat[i] = a_mat[i] + b_mat[i];
+		const value_type *a_mat = a.data(), *b_mat = b.data();
+		value_type *c_mat = c.kernel_data();
+		if(a.leading_dim() != c.leading_dim() || b.leading_dim() != c.leading_dim()) {
+			#pragma omp parallel for schedule(static)
+			for(size_t i = 0; i < nrows; ++ i) {
+				for(size_t j = 0; j < ncols; ++ j) c_mat[c.index(i, j)] = a_mat[a.index(i, j)] + b_mat[b.index(i, j)];
+			} // for
+			return true;
+		} // if
+		size_t num = a.storage_size();
+		#pragma omp parallel for schedule(static)
+		for(size_t i = 0; i < num; ++ i) c_mat[i] = a_mat[i] + b_mat[i];
 		return true;
 	} // matrix_add()
 
 
-	template <typename value_type>
-	static bool matrix_min_max(const Matrix2D<value_type>& mat, value_type& min_val, value_type& max_val) {
-		unsigned int nrows = mat.num_rows();
-		unsigned int ncols = mat.num_cols();
-		min_val = max_val = mat[0];
-		for(unsigned int i = 0; i < nrows * ncols; ++ i) {
-			if(min_val > mat[i]) min_val = mat[i];
-			if(max_val < mat[i]) max_val = mat[i];
-		} // for
+	// ////
+	// matrix minimum and maximum, see matrix_statistics() in reductions.hpp for more
+	// ////
+	template <typename value_type, typename layout_t>
+	static bool matrix_min_max(const Matrix2D<value_type, layout_t>& mat, value_type& min_val, value_type& max_val) {
+		MatrixStatistics<value_type> stats;
+		if(!matrix_statistics(mat, stats)) return false;
+		min_val = stats.min_val;
+		max_val = stats.max_val;
 		return true;
 	} // matrix_min_max()
 
+
+	// ////
+	// matrix transpose: b = a^T
+	// b is resized when it is not of the transposed dimensions
+	// ////
+	template <typename value_type, typename layout_t>
+	static bool matrix_transpose(const Matrix2D<value_type, layout_t>& a, Matrix2D<value_type, layout_t>& b) {
+		size_t nrows = a.num_rows();
+		size_t ncols = a.num_cols();
+		if(&a == &b) return b.transpose();
+		if(!b.detach()) return false;
+		if(b.num_rows() != ncols || b.num_cols() != nrows) b.resize(ncols, nrows);
+		value_type* b_mat = b.kernel_data();
+		switch(layout_t::kind) {
+			case layout_row_major:
+				return matrix_transpose(nrows, ncols, a.data(), a.leading_dim(), b_mat, b.leading_dim());
+			case layout_column_major:
+				return matrix_transpose(ncols, nrows, a.data(), a.leading_dim(), b_mat, b.leading_dim());
+			default:
+				#pragma omp parallel for schedule(static)
+				for(size_t i = 0; i < ncols; ++ i) {
+					for(size_t j = 0; j < nrows; ++ j) b_mat[b.index(i, j)] = a(j, i);
+				} // for
+		} // switch
+		return true;
+	} // matrix_transpose()
+
 } // namespace stock
 
 #endif // __MATRIX_DEF_HPP__
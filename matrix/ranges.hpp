@@ -0,0 +1,205 @@
+/**
+ *  Project: The Stock Libraries
+ *
+ *  File: ranges.hpp
+ *  Created: Oct 18, 2026
+ *
+ *  Author: Abhinav Sarje <abhinav.sarje@gmail.com>
+ *
+ *  Copyright (c) 2012-2017 Abhinav Sarje
+ *  Distributed under the Boost Software License.
+ *  See accompanying LICENSE file.
+ */
+
+#ifndef __RANGES_HPP__
+#define __RANGES_HPP__
+
+#include <cstddef>
+#include <iterator>
+
+namespace stock {
+
+	/* standard random-access iterators and ranges over a single row or column of a Matrix2D.
+	 * a line which is contiguous in memory is a plain pointer range, so that std algorithms
+	 * and the auto-vectorizer see unit stride. lines with a constant stride use StridedIterator,
+	 * and lines of tiled layouts, which jump between tiles, use LayoutLineIterator.
+	 * use Matrix2D::row_range(i) and Matrix2D::column_range(j) to obtain the right kind. */
+
+	/* iterator over elements at a constant distance from each other */
+	template <typename data_t>
+	class StridedIterator {
+		public:
+			typedef std::random_access_iterator_tag iterator_category;
+			typedef data_t value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef data_t* pointer;
+			typedef data_t& reference;
+
+			StridedIterator(): ptr_(NULL), stride_(1) { }
+			StridedIterator(data_t* ptr, std::ptrdiff_t stride): ptr_(ptr), stride_(stride) { }
+
+			reference operator*() const { return *ptr_; }
+			pointer operator->() const { return ptr_; }
+			reference operator[](difference_type n) const { return ptr_[n * stride_]; }
+
+			StridedIterator& operator++() { ptr_ += stride_; return *this; }
+			StridedIterator& operator--() { ptr_ -= stride_; return *this; }
+			StridedIterator operator++(int) { StridedIterator temp(*this); ptr_ += stride_; return temp; }
+			StridedIterator operator--(int) { StridedIterator temp(*this); ptr_ -= stride_; return temp; }
+			StridedIterator& operator+=(difference_type n) { ptr_ += n * stride_; return *this; }
+			StridedIterator& operator-=(difference_type n) { ptr_ -= n * stride_; return *this; }
+			StridedIterator operator+(difference_type n) const { return StridedIterator(ptr_ + n * stride_, stride_); }
+			StridedIterator operator-(difference_type n) const { return StridedIterator(ptr_ - n * stride_, stride_); }
+			difference_type operator-(const StridedIterator& other) const { return (ptr_ - other.ptr_) / stride_; }
+
+			bool operator==(const StridedIterator& other) const { return ptr_ == other.ptr_; }
+			bool operator!=(const StridedIterator& other) const { return ptr_ != other.ptr_; }
+			bool operator<(const StridedIterator& other) const { return (*this - other) < 0; }
+			bool operator>(const StridedIterator& other) const { return (*this - other) > 0; }
+			bool operator<=(const StridedIterator& other) const { return (*this - other) <= 0; }
+			bool operator>=(const StridedIterator& other) const { return (*this - other) >= 0; }
+
+			std::ptrdiff_t stride() const { return stride_; }
+
+		private:
+			data_t* ptr_;				// current element
+			std::ptrdiff_t stride_;		// distance between consecutive elements
+
+	}; // class StridedIterator
+
+	template <typename data_t>
+	StridedIterator<data_t> operator+(std::ptrdiff_t n, const StridedIterator<data_t>& it) {
+		return it + n;
+	} // operator+()
+
+
+	/* iterator over a row (or a column) of any layout, mapping each position through
+	 * layout_t::index(). used for tiled layouts whose lines are not strided */
+	template <typename data_t, typename layout_t>
+	class LayoutLineIterator {
+		public:
+			typedef std::random_access_iterator_tag iterator_category;
+			typedef data_t value_type;
+			typedef std::ptrdiff_t difference_type;
+			typedef data_t* pointer;
+			typedef data_t& reference;
+
+			LayoutLineIterator(): data_(NULL), rows_(0), cols_(0), line_(0), pos_(0), is_row_(true) { }
+			LayoutLineIterator(data_t* data, size_t rows, size_t cols, size_t line, std::ptrdiff_t pos, bool is_row):
+				data_(data), rows_(rows), cols_(cols), line_(line), pos_(pos), is_row_(is_row) { }
+
+			reference operator*() const { return data_[offset(pos_)]; }
+			pointer operator->() const { return data_ + offset(pos_); }
+			reference operator[](difference_type n) const { return data_[offset(pos_ + n)]; }
+
+			LayoutLineIterator& operator++() { ++ pos_; return *this; }
+			LayoutLineIterator& operator--() { -- pos_; return *this; }
+			LayoutLineIterator operator++(int) { LayoutLineIterator temp(*this); ++ pos_; return temp; }
+			LayoutLineIterator operator--(int) { LayoutLineIterator temp(*this); -- pos_; return temp; }
+			LayoutLineIterator& operator+=(difference_type n) { pos_ += n; return *this; }
+			LayoutLineIterator& operator-=(difference_type n) { pos_ -= n; return *this; }
+			LayoutLineIterator operator+(difference_type n) const { LayoutLineIterator temp(*this); return temp += n; }
+			LayoutLineIterator operator-(difference_type n) const { LayoutLineIterator temp(*this); return temp -= n; }
+			difference_type operator-(const LayoutLineIterator& other) const { return pos_ - other.pos_; }
+
+			bool operator==(const LayoutLineIterator& other) const { return pos_ == other.pos_ && data_ == other.data_; }
+			bool operator!=(const LayoutLineIterator& other) const { return !(*this == other); }
+			bool operator<(const LayoutLineIterator& other) const { return pos_ < other.pos_; }
+			bool operator>(const LayoutLineIterator& other) const { return pos_ > other.pos_; }
+			bool operator<=(const LayoutLineIterator& other) const { return pos_ <= other.pos_; }
+			bool operator>=(const LayoutLineIterator& other) const { return pos_ >= other.pos_; }
+
+		private:
+			size_t offset(std::ptrdiff_t pos) const {
+				return is_row_ ? layout_t::index(line_, pos, rows_, cols_) : layout_t::index(pos, line_, rows_, cols_);
+			} // offset()
+
+			data_t* data_;				// matrix buffer
+			size_t rows_, cols_;		// matrix dimensions
+			size_t line_;				// row or column number
+			std::ptrdiff_t pos_;		// position along the line
+			bool is_row_;				// whether the line is a row
+
+	}; // class LayoutLineIterator
+
+	template <typename data_t, typename layout_t>
+	LayoutLineIterator<data_t, layout_t> operator+(std::ptrdiff_t n, const LayoutLineIterator<data_t, layout_t>& it) {
+		return it + n;
+	} // operator+()
+
+
+	/* a range [begin, end) with its size, usable in range-based for loops and std algorithms */
+	template <typename iterator_t>
+	class LineRange {
+		public:
+			typedef iterator_t iterator;
+			typedef typename std::iterator_traits<iterator_t>::value_type value_type;
+			typedef typename std::iterator_traits<iterator_t>::reference reference;
+
+			LineRange(): begin_(), end_(), size_(0) { }
+			LineRange(iterator_t begin, size_t size): begin_(begin), end_(begin + size), size_(size) { }
+
+			iterator begin() const { return begin_; }
+			iterator end() const { return end_; }
+			size_t size() const { return size_; }
+			bool empty() const { return size_ == 0; }
+			reference operator[](size_t i) const { return begin_[i]; }
+
+		private:
+			iterator_t begin_;
+			iterator_t end_;
+			size_t size_;
+
+	}; // class LineRange
+
+
+	/* kinds of line ranges for each layout */
+	template <typename data_t, typename layout_t>
+	struct LineRangeTraits { };
+
+	template <typename data_t>
+	struct LineRangeTraits<data_t, RowMajor> {
+		typedef LineRange<data_t*> row_range;
+		typedef LineRange<StridedIterator<data_t> > column_range;
+
+		static row_range row(data_t* data, size_t, size_t cols, size_t ld, size_t i) {
+			return row_range(data + i * ld, cols);
+		} // row()
+
+		static column_range column(data_t* data, size_t rows, size_t, size_t ld, size_t j) {
+			return column_range(StridedIterator<data_t>(data + j, ld), rows);
+		} // column()
+	}; // struct LineRangeTraits
+
+	template <typename data_t>
+	struct LineRangeTraits<data_t, ColumnMajor> {
+		typedef LineRange<StridedIterator<data_t> > row_range;
+		typedef LineRange<data_t*> column_range;
+
+		static row_range row(data_t* data, size_t, size_t cols, size_t ld, size_t i) {
+			return row_range(StridedIterator<data_t>(data + i, ld), cols);
+		} // row()
+
+		static column_range column(data_t* data, size_t rows, size_t, size_t ld, size_t j) {
+			return column_range(data + j * ld, rows);
+		} // column()
+	}; // struct LineRangeTraits
+
+	template <typename data_t, unsigned int TILE_ROWS, unsigned int TILE_COLS>
+	struct LineRangeTraits<data_t, Tiled<TILE_ROWS, TILE_COLS> > {
+		typedef LayoutLineIterator<data_t, Tiled<TILE_ROWS, TILE_COLS> > iterator;
+		typedef LineRange<iterator> row_range;
+		typedef LineRange<iterator> column_range;
+
+		static row_range row(data_t* data, size_t rows, size_t cols, size_t, size_t i) {
+			return row_range(iterator(data, rows, cols, i, 0, true), cols);
+		} // row()
+
+		static column_range column(data_t* data, size_t rows, size_t cols, size_t, size_t j) {
+			return column_range(iterator(data, rows, cols, j, 0, false), rows);
+		} // column()
+	}; // struct LineRangeTraits
+
+} // namespace stock
+
+#endif // __RANGES_HPP__
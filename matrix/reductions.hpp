@@ -0,0 +1,379 @@
+/**
+ *  Project: The Stock Libraries
+ *
+ *  File: reductions.hpp
+ *  Created: Oct 18, 2026
+ *
+ *  Author: Abhinav Sarje <abhinav.sarje@gmail.com>
+ *
+ *  Copyright (c) 2012-2017 Abhinav Sarje
+ *  Distributed under the Boost Software License.
+ *  See accompanying LICENSE file.
+ */
+
+#ifndef __REDUCTIONS_HPP__
+#define __REDUCTIONS_HPP__
+
+#include <cmath>
+#include <algorithm>
+#if defined(__AVX__) || defined(__AVX512F__)
+#include <immintrin.h>
+#endif
+
+namespace stock {
+
+	const size_t REDUCTION_BLOCK_SIZE_ = 2048;	// elements reduced at a time in registers
+
+	/* statistics of all the elements of a real valued matrix, computed in one pass */
+	template <typename value_type>
+	struct MatrixStatistics {
+		value_type min_val;
+		value_type max_val;
+		size_t min_row, min_col;		// position of the first minimum
+		size_t max_row, max_col;		// position of the first maximum
+		double sum;
+		double sum_sq;			// sum of squares
+		double norm_l1;			// sum of absolute values
+		double norm_l2;			// sqrt of sum of squares
+		double norm_linf;		// maximum absolute value
+		size_t count;			// number of elements
+
+		double mean() const { return (count > 0) ? sum / count : 0.0; }
+		double variance() const { return (count > 0) ? sum_sq / count - mean() * mean() : 0.0; }
+	}; // struct MatrixStatistics
+
+
+	/* statistics of a contiguous block of elements.
+	 * sums are accumulated in registers over the block and added to the doubles by the caller,
+	 * extremum positions are found later by rescanning only the block which holds them */
+
+	// ////
+	// scalar version, written with independent accumulators
+	// ////
+	template <typename value_type>
+	inline void reduce_block(const value_type* data, size_t n, value_type& min_val, value_type& max_val,
+								double& sum, double& sum_sq, double& sum_abs) {
+		value_type mn = data[0], mx = data[0];
+		double s = 0.0, sq = 0.0, sa = 0.0;
+		for(size_t i = 0; i < n; ++ i) {
+			value_type x = data[i];
+			mn = (x < mn) ? x : mn;
+			mx = (x > mx) ? x : mx;
+			s += x;
+			sq += (double) x * x;
+			sa += (x < 0) ? - (double) x : (double) x;
+		} // for
+		min_val = mn; max_val = mx;
+		sum = s; sum_sq = sq; sum_abs = sa;
+	} // reduce_block()
+
+
+#if defined(__AVX512F__)
+	// ////
+	// float, avx-512: 16 lanes
+	// ////
+	inline void reduce_block(const float* data, size_t n, float& min_val, float& max_val,
+								double& sum, double& sum_sq, double& sum_abs) {
+		size_t n16 = n & ~(size_t) 15;
+		if(n16 == 0) return reduce_block<float>(data, n, min_val, max_val, sum, sum_sq, sum_abs);
+		__m512 vmin = _mm512_loadu_ps(data), vmax = vmin;
+		__m512 vsum = _mm512_setzero_ps(), vsq = _mm512_setzero_ps(), vabs = _mm512_setzero_ps();
+		for(size_t i = 0; i < n16; i += 16) {
+			__m512 x = _mm512_loadu_ps(data + i);
+			vmin = _mm512_min_ps(vmin, x);
+			vmax = _mm512_max_ps(vmax, x);
+			vsum = _mm512_add_ps(vsum, x);
+			vsq = _mm512_fmadd_ps(x, x, vsq);
+			vabs = _mm512_add_ps(vabs, _mm512_abs_ps(x));
+		} // for
+		float mn = _mm512_reduce_min_ps(vmin), mx = _mm512_reduce_max_ps(vmax);
+		double s = _mm512_reduce_add_ps(vsum), sq = _mm512_reduce_add_ps(vsq), sa = _mm512_reduce_add_ps(vabs);
+		if(n16 < n) {
+			float tmn, tmx; double ts, tsq, tsa;
+			reduce_block<float>(data + n16, n - n16, tmn, tmx, ts, tsq, tsa);
+			mn = std::min(mn, tmn); mx = std::max(mx, tmx);
+			s += ts; sq += tsq; sa += tsa;
+		} // if
+		min_val = mn; max_val = mx;
+		sum = s; sum_sq = sq; sum_abs = sa;
+	} // reduce_block()
+
+	// ////
+	// double, avx-512: 8 lanes
+	// ////
+	inline void reduce_block(const double* data, size_t n, double& min_val, double& max_val,
+								double& sum, double& sum_sq, double& sum_abs) {
+		size_t n8 = n & ~(size_t) 7;
+		if(n8 == 0) return reduce_block<double>(data, n, min_val, max_val, sum, sum_sq, sum_abs);
+		__m512d vmin = _mm512_loadu_pd(data), vmax = vmin;
+		__m512d vsum = _mm512_setzero_pd(), vsq = _mm512_setzero_pd(), vabs = _mm512_setzero_pd();
+		for(size_t i = 0; i < n8; i += 8) {
+			__m512d x = _mm512_loadu_pd(data + i);
+			vmin = _mm512_min_pd(vmin, x);
+			vmax = _mm512_max_pd(vmax, x);
+			vsum = _mm512_add_pd(vsum, x);
+			vsq = _mm512_fmadd_pd(x, x, vsq);
+			vabs = _mm512_add_pd(vabs, _mm512_abs_pd(x));
+		} // for
+		double mn = _mm512_reduce_min_pd(vmin), mx = _mm512_reduce_max_pd(vmax);
+		double s = _mm512_reduce_add_pd(vsum), sq = _mm512_reduce_add_pd(vsq), sa = _mm512_reduce_add_pd(vabs);
+		if(n8 < n) {
+			double tmn, tmx, ts, tsq, tsa;
+			reduce_block<double>(data + n8, n - n8, tmn, tmx, ts, tsq, tsa);
+			mn = std::min(mn, tmn); mx = std::max(mx, tmx);
+			s += ts; sq += tsq; sa += tsa;
+		} // if
+		min_val = mn; max_val = mx;
+		sum = s; sum_sq = sq; sum_abs = sa;
+	} // reduce_block()
+
+#elif defined(__AVX__)
+	// ////
+	// horizontal reductions of avx registers
+	// ////
+	inline float hmin_ps(__m256 v) {
+		__m128 x = _mm_min_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+		x = _mm_min_ps(x, _mm_movehl_ps(x, x));
+		x = _mm_min_ss(x, _mm_shuffle_ps(x, x, 1));
+		return _mm_cvtss_f32(x);
+	} // hmin_ps()
+
+	inline float hmax_ps(__m256 v) {
+		__m128 x = _mm_max_ps(_mm256_castps256_ps128(v), _mm256_extractf128_ps(v, 1));
+		x = _mm_max_ps(x, _mm_movehl_ps(x, x));
+		x = _mm_max_ss(x, _mm_shuffle_ps(x, x, 1));
+		return _mm_cvtss_f32(x);
+	} // hmax_ps()
+
+	inline double hsum_ps(__m256 v) {
+		__m256d lo = _mm256_cvtps_pd(_mm256_castps256_ps128(v));
+		__m256d hi = _mm256_cvtps_pd(_mm256_extractf128_ps(v, 1));
+		__m256d s = _mm256_add_pd(lo, hi);
+		__m128d x = _mm_add_pd(_mm256_castpd256_pd128(s), _mm256_extractf128_pd(s, 1));
+		return _mm_cvtsd_f64(_mm_add_sd(x, _mm_unpackhi_pd(x, x)));
+	} // hsum_ps()
+
+	inline double hmin_pd(__m256d v) {
+		__m128d x = _mm_min_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+		return _mm_cvtsd_f64(_mm_min_sd(x, _mm_unpackhi_pd(x, x)));
+	} // hmin_pd()
+
+	inline double hmax_pd(__m256d v) {
+		__m128d x = _mm_max_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+		return _mm_cvtsd_f64(_mm_max_sd(x, _mm_unpackhi_pd(x, x)));
+	} // hmax_pd()
+
+	inline double hsum_pd(__m256d v) {
+		__m128d x = _mm_add_pd(_mm256_castpd256_pd128(v), _mm256_extractf128_pd(v, 1));
+		return _mm_cvtsd_f64(_mm_add_sd(x, _mm_unpackhi_pd(x, x)));
+	} // hsum_pd()
+
+	// ////
+	// float, avx/avx2: 8 lanes
+	// ////
+	inline void reduce_block(const float* data, size_t n, float& min_val, float& max_val,
+								double& sum, double& sum_sq, double& sum_abs) {
+		size_t n8 = n & ~(size_t) 7;
+		if(n8 == 0) return reduce_block<float>(data, n, min_val, max_val, sum, sum_sq, sum_abs);
+		const __m256 abs_mask = _mm256_castsi256_ps(_mm256_set1_epi32(0x7fffffff));
+		__m256 vmin = _mm256_loadu_ps(data), vmax = vmin;
+		__m256 vsum = _mm256_setzero_ps(), vsq = _mm256_setzero_ps(), vabs = _mm256_setzero_ps();
+		for(size_t i = 0; i < n8; i += 8) {
+			__m256 x = _mm256_loadu_ps(data + i);
+			vmin = _mm256_min_ps(vmin, x);
+			vmax = _mm256_max_ps(vmax, x);
+			vsum = _mm256_add_ps(vsum, x);
+			vsq = _mm256_add_ps(vsq, _mm256_mul_ps(x, x));
+			vabs = _mm256_add_ps(vabs, _mm256_and_ps(x, abs_mask));
+		} // for
+		float mn = hmin_ps(vmin), mx = hmax_ps(vmax);
+		double s = hsum_ps(vsum), sq = hsum_ps(vsq), sa = hsum_ps(vabs);
+		if(n8 < n) {
+			float tmn, tmx; double ts, tsq, tsa;
+			reduce_block<float>(data + n8, n - n8, tmn, tmx, ts, tsq, tsa);
+			mn = std::min(mn, tmn); mx = std::max(mx, tmx);
+			s += ts; sq += tsq; sa += tsa;
+		} // if
+		min_val = mn; max_val = mx;
+		sum = s; sum_sq = sq; sum_abs = sa;
+	} // reduce_block()
+
+	// ////
+	// double, avx/avx2: 4 lanes
+	// ////
+	inline void reduce_block(const double* data, size_t n, double& min_val, double& max_val,
+								double& sum, double& sum_sq, double& sum_abs) {
+		size_t n4 = n & ~(size_t) 3;
+		if(n4 == 0) return reduce_block<double>(data, n, min_val, max_val, sum, sum_sq, sum_abs);
+		const __m256d abs_mask = _mm256_castsi256_pd(_mm256_set1_epi64x(0x7fffffffffffffffLL));
+		__m256d vmin = _mm256_loadu_pd(data), vmax = vmin;
+		__m256d vsum = _mm256_setzero_pd(), vsq = _mm256_setzero_pd(), vabs = _mm256_setzero_pd();
+		for(size_t i = 0; i < n4; i += 4) {
+			__m256d x = _mm256_loadu_pd(data + i);
+			vmin = _mm256_min_pd(vmin, x);
+			vmax = _mm256_max_pd(vmax, x);
+			vsum = _mm256_add_pd(vsum, x);
+			vsq = _mm256_add_pd(vsq, _mm256_mul_pd(x, x));
+			vabs = _mm256_add_pd(vabs, _mm256_and_pd(x, abs_mask));
+		} // for
+		double mn = hmin_pd(vmin), mx = hmax_pd(vmax);
+		double s = hsum_pd(vsum), sq = hsum_pd(vsq), sa = hsum_pd(vabs);
+		if(n4 < n) {
+			double tmn, tmx, ts, tsq, tsa;
+			reduce_block<double>(data + n4, n - n4, tmn, tmx, ts, tsq, tsa);
+			mn = std::min(mn, tmn); mx = std::max(mx, tmx);
+			s += ts; sq += tsq; sa += tsa;
+		} // if
+		min_val = mn; max_val = mx;
+		sum = s; sum_sq = sq; sum_abs = sa;
+	} // reduce_block()
+#endif
+
+
+	/* per-thread partial result */
+	template <typename value_type>
+	struct ReductionPartial {
+		bool valid;
+		value_type min_val, max_val;
+		size_t min_begin, min_len;			// block holding the minimum
+		size_t max_begin, max_len;			// block holding the maximum
+		double sum, sum_sq, sum_abs;
+
+		ReductionPartial(): valid(false), min_val(0), max_val(0), min_begin(0), min_len(0),
+							max_begin(0), max_len(0), sum(0.0), sum_sq(0.0), sum_abs(0.0) { }
+
+		// ////
+		// add the block [begin, begin + len) of the buffer
+		// ////
+		void add(const value_type* buffer, size_t begin, size_t len) {
+			if(len == 0) return;
+			value_type mn, mx;
+			double s, sq, sa;
+			reduce_block(buffer + begin, len, mn, mx, s, sq, sa);
+			if(!valid || mn < min_val) { min_val = mn; min_begin = begin; min_len = len; }
+			if(!valid || mx > max_val) { max_val = mx; max_begin = begin; max_len = len; }
+			sum += s; sum_sq += sq; sum_abs += sa;
+			valid = true;
+		} // add()
+
+		// ////
+		// narrow down the extremum blocks to the first matching element
+		// ////
+		void locate(const value_type* buffer) {
+			for(size_t i = min_begin; i < min_begin + min_len; ++ i)
+				if(buffer[i] == min_val) { min_begin = i; min_len = 1; break; }
+			for(size_t i = max_begin; i < max_begin + max_len; ++ i)
+				if(buffer[i] == max_val) { max_begin = i; max_len = 1; break; }
+		} // locate()
+
+		// ////
+		// merge a located partial, ties go to the lower buffer position
+		// ////
+		void merge(const ReductionPartial& other) {
+			if(!other.valid) return;
+			if(!valid || other.min_val < min_val || (other.min_val == min_val && other.min_begin < min_begin)) {
+				min_val = other.min_val; min_begin = other.min_begin; min_len = other.min_len;
+			} // if
+			if(!valid || other.max_val > max_val || (other.max_val == max_val && other.max_begin < max_begin)) {
+				max_val = other.max_val; max_begin = other.max_begin; max_len = other.max_len;
+			} // if
+			sum += other.sum; sum_sq += other.sum_sq; sum_abs += other.sum_abs;
+			valid = true;
+		} // merge()
+	}; // struct ReductionPartial
+
+
+	// ////
+	// reduce this thread's share of a strided matrix (called in a parallel region). packed
+	// matrices are reduced in blocks, padded ones line by line, skipping the padding
+	// ////
+	template <typename value_type, typename layout_t>
+	void reduce_matrix(const Matrix2D<value_type, layout_t>& mat, ReductionPartial<value_type>& partial) {
+		const value_type* buffer = &mat[0];
+		const size_t B = REDUCTION_BLOCK_SIZE_;
+		size_t num = mat.num_rows() * mat.num_cols(), num_blocks = (num + B - 1) / B;
+		if(mat.storage_size() != num) {
+			bool row_major = (layout_t::kind == layout_row_major);
+			size_t lines = row_major ? mat.num_rows() : mat.num_cols();
+			size_t len = row_major ? mat.num_cols() : mat.num_rows();
+			#pragma omp for schedule(static)
+			for(size_t l = 0; l < lines; ++ l) partial.add(buffer, l * mat.leading_dim(), len);
+			return;
+		} // if
+		#pragma omp for schedule(static)
+		for(size_t b = 0; b < num_blocks; ++ b) partial.add(buffer, b * B, std::min(B, num - b * B));
+	} // reduce_matrix()
+
+	// ////
+	// tiled matrix: the contiguous pieces are the rows of each tile, padding is skipped
+	// ////
+	template <typename value_type, unsigned int TILE_ROWS, unsigned int TILE_COLS>
+	void reduce_matrix(const Matrix2D<value_type, Tiled<TILE_ROWS, TILE_COLS> >& mat,
+						ReductionPartial<value_type>& partial) {
+		typedef Tiled<TILE_ROWS, TILE_COLS> layout_t;
+		const value_type* buffer = &mat[0];
+		size_t nrows = mat.num_rows(), ncols = mat.num_cols();
+		#pragma omp for schedule(static)
+		for(size_t i = 0; i < nrows; ++ i) {
+			for(size_t j = 0; j < ncols; j += TILE_COLS)
+				partial.add(buffer, layout_t::index(i, j, nrows, ncols), std::min((size_t) TILE_COLS, ncols - j));
+		} // for
+	} // reduce_matrix()
+
+
+	// ////
+	// compute all statistics of a real valued matrix in one parallel pass
+	// ////
+	template <typename value_type, typename layout_t>
+	bool matrix_statistics(const Matrix2D<value_type, layout_t>& mat, MatrixStatistics<value_type>& stats) {
+		size_t nrows = mat.num_rows();
+		size_t ncols = mat.num_cols();
+		if(nrows == 0 || ncols == 0) {
+			std::cerr << "error: cannot compute statistics of an empty matrix" << std::endl;
+			return false;
+		} // if
+		const value_type* buffer = &mat[0];
+		ReductionPartial<value_type> result;
+		#pragma omp parallel
+		{
+			ReductionPartial<value_type> partial;
+			reduce_matrix(mat, partial);
+			partial.locate(buffer);
+			#pragma omp critical (matrix_statistics_merge)
+			result.merge(partial);
+		}
+		stats.min_val = result.min_val;
+		stats.max_val = result.max_val;
+		layout_t::position(result.min_begin, nrows, ncols, mat.leading_dim(), stats.min_row, stats.min_col);
+		layout_t::position(result.max_begin, nrows, ncols, mat.leading_dim(), stats.max_row, stats.max_col);
+		stats.count = nrows * ncols;
+		stats.sum = result.sum;
+		stats.sum_sq = result.sum_sq;
+		stats.norm_l1 = result.sum_abs;
+		stats.norm_l2 = std::sqrt(result.sum_sq);
+		stats.norm_linf = std::max(std::fabs((double) result.min_val), std::fabs((double) result.max_val));
+		return true;
+	} // matrix_statistics()
+
+
+	// ////
+	// a few single statistic shortcuts
+	// ////
+
+	template <typename value_type, typename layout_t>
+	double matrix_sum(const Matrix2D<value_type, layout_t>& mat) {
+		MatrixStatistics<value_type> stats;
+		if(!matrix_statistics(mat, stats)) return 0.0;
+		return stats.sum;
+	} // matrix_sum()
+
+	template <typename value_type, typename layout_t>
+	double matrix_norm_l2(const Matrix2D<value_type, layout_t>& mat) {
+		MatrixStatistics<value_type> stats;
+		if(!matrix_statistics(mat, stats)) return 0.0;
+		return stats.norm_l2;
+	} // matrix_norm_l2()
+
+} // namespace stock
+
+#endif // __REDUCTIONS_HPP__
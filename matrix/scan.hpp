@@ -0,0 +1,297 @@
+/**
+ *  Project: The Stock Libraries
+ *
+ *  File: scan.hpp
+ *  Created: Oct 18, 2026
+ *
+ *  Author: Abhinav Sarje <abhinav.sarje@gmail.com>
+ *
+ *  Copyright (c) 2012-2017 Abhinav Sarje
+ *  Distributed under the Boost Software License.
+ *  See accompanying LICENSE file.
+ */
+
+#ifndef __SCAN_HPP__
+#define __SCAN_HPP__
+
+#include <vector>
+#include <algorithm>
+#include <stdint.h>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace stock {
+
+	enum ScanAxis {
+		scan_rows,			/* prefix sums along each row */
+		scan_columns		/* prefix sums along each column */
+	};
+
+	enum ScanMode {
+		scan_inclusive,		/* element k is the sum of elements 0 to k */
+		scan_exclusive		/* element k is the sum of elements 0 to k - 1 */
+	};
+
+	const size_t SCAN_PARALLEL_ = 1 << 16;		// shorter single lines are scanned by one thread
+	const size_t SCAN_BLOCK_ = 512;				// lines scanned together when scanning across lines
+
+
+	/* type in which prefix sums of value_type are accumulated:
+	 * 64 bit for integers, double for float */
+	template <typename value_type> struct ScanTraits { typedef value_type accum_type; };
+	template <> struct ScanTraits<char> { typedef int64_t accum_type; };
+	template <> struct ScanTraits<signed char> { typedef int64_t accum_type; };
+	template <> struct ScanTraits<short> { typedef int64_t accum_type; };
+	template <> struct ScanTraits<int> { typedef int64_t accum_type; };
+	template <> struct ScanTraits<long> { typedef int64_t accum_type; };
+	template <> struct ScanTraits<unsigned char> { typedef uint64_t accum_type; };
+	template <> struct ScanTraits<unsigned short> { typedef uint64_t accum_type; };
+	template <> struct ScanTraits<unsigned int> { typedef uint64_t accum_type; };
+	template <> struct ScanTraits<unsigned long> { typedef uint64_t accum_type; };
+	template <> struct ScanTraits<float> { typedef double accum_type; };
+
+
+	// ////
+	// scan num_lines contiguous lines of len elements, src_stride apart in src and dst_stride apart in dst.
+	// with few lines, each long line is scanned by all threads in two passes:
+	// block totals first, then each block again starting from the sum of the blocks before it.
+	// src and dst may be the same buffer
+	// ////
+	template <typename src_t, typename dst_t>
+	void scan_contiguous(const src_t* src, dst_t* dst, size_t num_lines, size_t len,
+							size_t src_stride, size_t dst_stride, bool exclusive) {
+		typedef typename ScanTraits<dst_t>::accum_type accum_t;
+		int max_threads = 1;
+		#ifdef _OPENMP
+		max_threads = omp_get_max_threads();
+		#endif
+		if(num_lines >= (size_t) max_threads || len < SCAN_PARALLEL_) {
+			#pragma omp parallel for schedule(static) if(num_lines > 1)
+			for(size_t l = 0; l < num_lines; ++ l) {
+				const src_t* in = src + l * src_stride;
+				dst_t* out = dst + l * dst_stride;
+				accum_t acc = 0;
+				if(exclusive) {
+					for(size_t k = 0; k < len; ++ k) { accum_t x = in[k]; out[k] = (dst_t) acc; acc += x; }
+				} else {
+					for(size_t k = 0; k < len; ++ k) { acc += in[k]; out[k] = (dst_t) acc; }
+				} // if-else
+			} // for
+			return;
+		} // if
+		for(size_t l = 0; l < num_lines; ++ l) {
+			const src_t* in = src + l * src_stride;
+			dst_t* out = dst + l * dst_stride;
+			std::vector<accum_t> totals(max_threads + 1, accum_t(0));
+			#pragma omp parallel
+			{
+				size_t p = 0, parts = 1;
+				#ifdef _OPENMP
+				p = omp_get_thread_num();
+				parts = omp_get_num_threads();
+				#endif
+				size_t begin = len / parts * p + std::min(p, len % parts);
+				size_t end = begin + len / parts + ((p < len % parts) ? 1 : 0);
+				accum_t acc = 0;
+				for(size_t k = begin; k < end; ++ k) acc += in[k];
+				totals[p + 1] = acc;
+				#pragma omp barrier
+				acc = 0;
+				for(size_t q = 0; q <= p; ++ q) acc += totals[q];
+				if(exclusive) {
+					for(size_t k = begin; k < end; ++ k) { accum_t x = in[k]; out[k] = (dst_t) acc; acc += x; }
+				} else {
+					for(size_t k = begin; k < end; ++ k) { acc += in[k]; out[k] = (dst_t) acc; }
+				} // if-else
+			}
+		} // for
+	} // scan_contiguous()
+
+
+	// ////
+	// scan across num_lines contiguous lines of width elements, src_stride and dst_stride apart:
+	// element k of every line is summed over the lines. blocks of columns are carried
+	// down all the lines in parallel, the inner loops run along the lines
+	// ////
+	template <typename src_t, typename dst_t>
+	void scan_across(const src_t* src, dst_t* dst, size_t num_lines, size_t width,
+						size_t src_stride, size_t dst_stride, bool exclusive) {
+		typedef typename ScanTraits<dst_t>::accum_type accum_t;
+		const size_t B = SCAN_BLOCK_;
+		size_t num_blocks = (width + B - 1) / B;
+		#pragma omp parallel
+		{
+			std::vector<accum_t> acc(B);
+			#pragma omp for schedule(static)
+			for(size_t b = 0; b < num_blocks; ++ b) {
+				size_t c0 = b * B, n = std::min(B, width - c0);
+				std::fill(acc.begin(), acc.begin() + n, accum_t(0));
+				accum_t* a = &acc[0];
+				for(size_t l = 0; l < num_lines; ++ l) {
+					const src_t* in = src + l * src_stride + c0;
+					dst_t* out = dst + l * dst_stride + c0;
+					if(exclusive) {
+						for(size_t k = 0; k < n; ++ k) { accum_t x = in[k]; out[k] = (dst_t) a[k]; a[k] += x; }
+					} else {
+						for(size_t k = 0; k < n; ++ k) { a[k] += in[k]; out[k] = (dst_t) a[k]; }
+					} // if-else
+				} // for
+			} // for
+		}
+	} // scan_across()
+
+
+	// ////
+	// scan along one axis of buffers of the given layout, with leading dimensions ld_src
+	// and ld_dst. src and dst may be the same buffer
+	// ////
+	template <typename layout_t, typename src_t, typename dst_t>
+	void scan_axis(const src_t* src, size_t ld_src, dst_t* dst, size_t ld_dst, size_t nrows, size_t ncols,
+					ScanAxis axis, bool exclusive) {
+		if(nrows == 0 || ncols == 0) return;
+		long row_stride = 0, col_stride = 0, dst_row_stride = 0, dst_col_stride = 0;
+		if(layout_t::strides(nrows, ncols, ld_src, row_stride, col_stride)) {
+			layout_t::strides(nrows, ncols, ld_dst, dst_row_stride, dst_col_stride);
+			size_t along = (axis == scan_rows) ? col_stride : row_stride;		// between scanned elements
+			size_t across = (axis == scan_rows) ? row_stride : col_stride;		// between lines
+			size_t dst_along = (axis == scan_rows) ? dst_col_stride : dst_row_stride;
+			size_t dst_across = (axis == scan_rows) ? dst_row_stride : dst_col_stride;
+			size_t num_lines = (axis == scan_rows) ? nrows : ncols;
+			size_t len = (axis == scan_rows) ? ncols : nrows;
+			if(along == 1) scan_contiguous(src, dst, num_lines, len, across, dst_across, exclusive);
+			else scan_across(src, dst, len, num_lines, along, dst_along, exclusive);
+			return;
+		} // if
+		// other layouts: one line at a time through the layout index
+		typedef typename ScanTraits<dst_t>::accum_type accum_t;
+		size_t num_lines = (axis == scan_rows) ? nrows : ncols;
+		size_t len = (axis == scan_rows) ? ncols : nrows;
+		#pragma omp parallel for schedule(static)
+		for(size_t l = 0; l < num_lines; ++ l) {
+			accum_t acc = 0;
+			for(size_t k = 0; k < len; ++ k) {
+				size_t i = (axis == scan_rows) ? l : k, j = (axis == scan_rows) ? k : l;
+				accum_t x = src[layout_t::index(i, j, nrows, ncols, ld_src)];
+				size_t idx = layout_t::index(i, j, nrows, ncols, ld_dst);
+				if(exclusive) { dst[idx] = (dst_t) acc; acc += x; }
+				else { acc += x; dst[idx] = (dst_t) acc; }
+			} // for
+		} // for
+	} // scan_axis()
+
+
+	// ////
+	// prefix sums of in along each row or column into out, which is resized when its
+	// dimensions differ and may be in itself. out(i, j) of an inclusive row scan is the
+	// sum of in(i, 0 .. j). sums are accumulated in ScanTraits<out_t>::accum_type, so that
+	// integer input scanned into a Matrix2D<int64_t> does not overflow
+	// ////
+	template <typename in_t, typename out_t, typename layout_t>
+	bool matrix_scan(const Matrix2D<in_t, layout_t>& in, Matrix2D<out_t, layout_t>& out,
+						ScanAxis axis, ScanMode mode = scan_inclusive) {
+		size_t nrows = in.num_rows(), ncols = in.num_cols();
+		if(out.num_rows() != nrows || out.num_cols() != ncols) out.resize(nrows, ncols);
+		out_t* out_mat = out.kernel_data();		// detached before reading in, in case they share a buffer
+		scan_axis<layout_t>(in.data(), in.leading_dim(), out_mat, out.leading_dim(), nrows, ncols,
+							axis, mode == scan_exclusive);
+		return true;
+	} // matrix_scan()
+
+	// ////
+	// in-place prefix sums along each row or column
+	// ////
+	template <typename value_type, typename layout_t>
+	bool matrix_scan(Matrix2D<value_type, layout_t>& mat, ScanAxis axis, ScanMode mode = scan_inclusive) {
+		value_type* buffer = mat.kernel_data();
+		scan_axis<layout_t>(buffer, mat.leading_dim(), buffer, mat.leading_dim(), mat.num_rows(), mat.num_cols(),
+							axis, mode == scan_exclusive);
+		return true;
+	} // matrix_scan()
+
+	// ////
+	// 2D prefix sums: out(i, j) is the sum of the rectangle in(0 .. i, 0 .. j) when inclusive,
+	// in(0 .. i - 1, 0 .. j - 1) when exclusive. a row scan followed by a column scan
+	// ////
+	template <typename in_t, typename out_t, typename layout_t>
+	bool matrix_scan_2d(const Matrix2D<in_t, layout_t>& in, Matrix2D<out_t, layout_t>& out,
+						ScanMode mode = scan_inclusive) {
+		if(!matrix_scan(in, out, scan_rows, mode)) return false;
+		return matrix_scan(out, scan_columns, mode);
+	} // matrix_scan_2d()
+
+	template <typename value_type, typename layout_t>
+	bool matrix_scan_2d(Matrix2D<value_type, layout_t>& mat, ScanMode mode = scan_inclusive) {
+		if(!matrix_scan(mat, scan_rows, mode)) return false;
+		return matrix_scan(mat, scan_columns, mode);
+	} // matrix_scan_2d()
+
+
+	/* summed-area table of a matrix: the sum, or mean, of the elements of any rectangle
+	 * in constant time. the table has an extra first row and column of zeros, so that
+	 * table(i, j) is the sum of the elements above and left of (i, j) */
+	template <typename value_type, typename sum_t = typename ScanTraits<value_type>::accum_type>
+	class IntegralImage {
+		private:
+			Matrix2D<sum_t> table_;
+			size_t num_rows_;
+			size_t num_cols_;
+
+		public:
+			IntegralImage(): table_(1, 1), num_rows_(0), num_cols_(0) { }
+
+			template <typename layout_t>
+			IntegralImage(const Matrix2D<value_type, layout_t>& mat): table_(1, 1), num_rows_(0), num_cols_(0) {
+				build(mat);
+			} // IntegralImage()
+
+			~IntegralImage() { }
+
+			// ////
+			// build the table of mat, replacing the previous one
+			// ////
+			template <typename layout_t>
+			bool build(const Matrix2D<value_type, layout_t>& mat) {
+				num_rows_ = mat.num_rows();
+				num_cols_ = mat.num_cols();
+				size_t cols = num_cols_ + 1;
+				table_.resize(num_rows_ + 1, cols);
+				sum_t* table = table_.kernel_data();
+				size_t table_ld = table_.leading_dim(), ld = mat.leading_dim();
+				const value_type* buffer = mat.data();
+				#pragma omp parallel for schedule(static)
+				for(size_t i = 0; i < num_rows_; ++ i) {
+					sum_t* row = table + (i + 1) * table_ld + 1;
+					for(size_t j = 0; j < num_cols_; ++ j)
+						row[j] = (sum_t) buffer[layout_t::index(i, j, num_rows_, num_cols_, ld)];
+				} // for
+				return matrix_scan_2d(table_, scan_inclusive);
+			} // build()
+
+			// ////
+			// sum of the rows x cols rectangle starting at (row, col),
+			// clipped to the matrix
+			// ////
+			sum_t sum(size_t row, size_t col, size_t rows, size_t cols) const {
+				size_t r0 = std::min(row, num_rows_), c0 = std::min(col, num_cols_);
+				size_t r1 = std::min(r0 + rows, num_rows_), c1 = std::min(c0 + cols, num_cols_);
+				return table_(r1, c1) - table_(r0, c1) - table_(r1, c0) + table_(r0, c0);
+			} // sum()
+
+			// ////
+			// mean of the rectangle, over the elements inside the matrix
+			// ////
+			double mean(size_t row, size_t col, size_t rows, size_t cols) const {
+				size_t r0 = std::min(row, num_rows_), c0 = std::min(col, num_cols_);
+				size_t count = (std::min(r0 + rows, num_rows_) - r0) * (std::min(c0 + cols, num_cols_) - c0);
+				return (count > 0) ? (double) sum(row, col, rows, cols) / count : 0.0;
+			} // mean()
+
+			size_t num_rows() const { return num_rows_; }
+			size_t num_cols() const { return num_cols_; }
+			const Matrix2D<sum_t>& table() const { return table_; }
+	}; // class IntegralImage
+
+} // namespace stock
+
+#endif // __SCAN_HPP__
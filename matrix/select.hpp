@@ -0,0 +1,516 @@
+/**
+ *  Project: The Stock Libraries
+ *
+ *  File: select.hpp
+ *  Created: Oct 18, 2026
+ *
+ *  Author: Abhinav Sarje <abhinav.sarje@gmail.com>
+ *
+ *  Copyright (c) 2012-2017 Abhinav Sarje
+ *  Distributed under the Boost Software License.
+ *  See accompanying LICENSE file.
+ */
+
+#ifndef __SELECT_HPP__
+#define __SELECT_HPP__
+
+#include <vector>
+#include <cmath>
+#include <algorithm>
+#include <functional>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace stock {
+
+	/* order statistics of real valued matrices: sort, nth element, percentiles and top-k,
+	 * along each row or column (in parallel over the lines) or over the whole matrix.
+	 * percentiles interpolate linearly between the two closest ranks.
+	 * NaN elements are not supported */
+
+	enum SelectAxis {
+		select_rows,		/* each row separately */
+		select_columns		/* each column separately */
+	};
+
+	const size_t SELECT_SERIAL_ = 1 << 16;		// smaller sets are handled by one thread
+	const size_t SELECT_WAYS_ = 64;				// buckets per partitioning round
+	const size_t SELECT_SAMPLES_ = 8;			// samples per bucket for choosing splitters
+	const size_t SELECT_BINS_ = 4096;			// default histogram bins of approximate percentiles
+
+
+	// ////
+	// number of lines along the axis and their length
+	// ////
+	inline void select_lines_size(size_t nrows, size_t ncols, SelectAxis axis, size_t& num_lines, size_t& len) {
+		num_lines = (axis == select_rows) ? nrows : ncols;
+		len = (axis == select_rows) ? ncols : nrows;
+	} // select_lines_size()
+
+	// ////
+	// buffer index of element k of line l, in a buffer with leading dimension ld
+	// ////
+	template <typename layout_t>
+	inline size_t select_index(SelectAxis axis, size_t l, size_t k, size_t nrows, size_t ncols, size_t ld) {
+		return (axis == select_rows) ? layout_t::index(l, k, nrows, ncols, ld) : layout_t::index(k, l, nrows, ncols, ld);
+	} // select_index()
+
+	// ////
+	// call op(l, line, len) for every line, in parallel. lines which are contiguous in the
+	// buffer are passed in place when in_place is set, other lines are copied to a buffer
+	// of the thread and, when in_place is set, copied back after op reorders them
+	// ////
+	template <typename layout_t, typename value_type, typename op_t>
+	void select_lines(const value_type* buffer, size_t nrows, size_t ncols, size_t ld, SelectAxis axis,
+						bool in_place, const op_t& op) {
+		size_t num_lines = 0, len = 0;
+		select_lines_size(nrows, ncols, axis, num_lines, len);
+		if(num_lines == 0 || len == 0) return;
+		long row_stride = 0, col_stride = 0;
+		bool contiguous = layout_t::strides(nrows, ncols, ld, row_stride, col_stride) &&
+							((axis == select_rows) ? col_stride : row_stride) == 1;
+		#pragma omp parallel
+		{
+			std::vector<value_type> line(len);
+			#pragma omp for schedule(static)
+			for(size_t l = 0; l < num_lines; ++ l) {
+				if(in_place && contiguous) {
+					op(l, const_cast<value_type*>(buffer) + select_index<layout_t>(axis, l, 0, nrows, ncols, ld), len);
+					continue;
+				} // if
+				for(size_t k = 0; k < len; ++ k) line[k] = buffer[select_index<layout_t>(axis, l, k, nrows, ncols, ld)];
+				op(l, &line[0], len);
+				if(in_place) {
+					value_type* out = const_cast<value_type*>(buffer);
+					for(size_t k = 0; k < len; ++ k) out[select_index<layout_t>(axis, l, k, nrows, ncols, ld)] = line[k];
+				} // if
+			} // for
+		}
+	} // select_lines()
+
+
+	/* operations on one line */
+
+	template <typename value_type>
+	struct SelectSortOp {
+		void operator()(size_t, value_type* line, size_t len) const { std::sort(line, line + len); }
+	}; // struct SelectSortOp
+
+	template <typename value_type>
+	struct SelectNthOp {
+		size_t n_;
+		value_type* values_;
+		void operator()(size_t l, value_type* line, size_t len) const {
+			std::nth_element(line, line + n_, line + len);
+			values_[l] = line[n_];
+		} // operator()()
+	}; // struct SelectNthOp
+
+	// ////
+	// percentile of a line, which is partially reordered
+	// ////
+	template <typename value_type>
+	double select_percentile(value_type* line, size_t len, double percent) {
+		double h = std::min(std::max(percent, 0.0), 100.0) / 100.0 * (len - 1);
+		size_t k = (size_t) h;
+		double frac = h - k;
+		std::nth_element(line, line + k, line + len);
+		double value = (double) line[k];
+		if(frac > 0.0 && k + 1 < len) value += frac * ((double) *std::min_element(line + k + 1, line + len) - value);
+		return value;
+	} // select_percentile()
+
+	template <typename value_type>
+	struct SelectPercentileOp {
+		double percent_;
+		double* values_;
+		void operator()(size_t l, value_type* line, size_t len) const {
+			values_[l] = select_percentile(line, len, percent_);
+		} // operator()()
+	}; // struct SelectPercentileOp
+
+	template <typename value_type, typename out_layout_t>
+	struct SelectTopOp {
+		size_t k_;
+		value_type* out_;
+		size_t out_rows_, out_cols_, out_ld_;
+		void operator()(size_t l, value_type* line, size_t len) const {
+			std::partial_sort(line, line + k_, line + len, std::greater<value_type>());
+			for(size_t c = 0; c < k_; ++ c) out_[out_layout_t::index(l, c, out_rows_, out_cols_, out_ld_)] = line[c];
+		} // operator()()
+	}; // struct SelectTopOp
+
+
+	// ////
+	// sort each row or column in place, ascending
+	// ////
+	template <typename value_type, typename layout_t>
+	bool matrix_sort(Matrix2D<value_type, layout_t>& mat, SelectAxis axis) {
+		value_type* buffer = mat.kernel_data();
+		select_lines<layout_t>(buffer, mat.num_rows(), mat.num_cols(), mat.leading_dim(), axis, true,
+								SelectSortOp<value_type>());
+		return true;
+	} // matrix_sort()
+
+	// ////
+	// sorted copy of each row or column. out is resized when its dimensions differ
+	// ////
+	template <typename value_type, typename layout_t>
+	bool matrix_sort(const Matrix2D<value_type, layout_t>& in, Matrix2D<value_type, layout_t>& out,
+						SelectAxis axis) {
+		if(&in != &out) out = in;
+		return matrix_sort(out, axis);
+	} // matrix_sort()
+
+	// ////
+	// the n-th smallest element of each row or column. the lines are reordered in place as by
+	// std::nth_element: smaller elements before position n, larger ones after it
+	// ////
+	template <typename value_type, typename layout_t>
+	bool matrix_nth_element(Matrix2D<value_type, layout_t>& mat, SelectAxis axis, size_t n,
+							std::vector<value_type>& values) {
+		size_t num_lines = 0, len = 0;
+		select_lines_size(mat.num_rows(), mat.num_cols(), axis, num_lines, len);
+		if(n >= len) {
+			std::cerr << "error: selected rank is not less than the line length" << std::endl;
+			return false;
+		} // if
+		values.resize(num_lines);
+		SelectNthOp<value_type> op;
+		op.n_ = n;
+		op.values_ = (num_lines > 0) ? &values[0] : NULL;
+		value_type* buffer = mat.kernel_data();
+		select_lines<layout_t>(buffer, mat.num_rows(), mat.num_cols(), mat.leading_dim(), axis, true, op);
+		return true;
+	} // matrix_nth_element()
+
+	// ////
+	// the n-th smallest element of each row or column, the matrix is not changed
+	// ////
+	template <typename value_type, typename layout_t>
+	bool matrix_select(const Matrix2D<value_type, layout_t>& mat, SelectAxis axis, size_t n,
+						std::vector<value_type>& values) {
+		size_t num_lines = 0, len = 0;
+		select_lines_size(mat.num_rows(), mat.num_cols(), axis, num_lines, len);
+		if(n >= len) {
+			std::cerr << "error: selected rank is not less than the line length" << std::endl;
+			return false;
+		} // if
+		values.resize(num_lines);
+		SelectNthOp<value_type> op;
+		op.n_ = n;
+		op.values_ = (num_lines > 0) ? &values[0] : NULL;
+		select_lines<layout_t>(mat.data(), mat.num_rows(), mat.num_cols(), mat.leading_dim(), axis, false, op);
+		return true;
+	} // matrix_select()
+
+	// ////
+	// percentile (0 to 100) of each row or column, e.g. 50 for the median
+	// ////
+	template <typename value_type, typename layout_t>
+	bool matrix_percentile(const Matrix2D<value_type, layout_t>& mat, SelectAxis axis, double percent,
+							std::vector<double>& values) {
+		size_t num_lines = 0, len = 0;
+		select_lines_size(mat.num_rows(), mat.num_cols(), axis, num_lines, len);
+		if(len == 0) {
+			std::cerr << "error: cannot compute percentiles of empty lines" << std::endl;
+			return false;
+		} // if
+		values.resize(num_lines);
+		SelectPercentileOp<value_type> op;
+		op.percent_ = percent;
+		op.values_ = (num_lines > 0) ? &values[0] : NULL;
+		select_lines<layout_t>(mat.data(), mat.num_rows(), mat.num_cols(), mat.leading_dim(), axis, false, op);
+		return true;
+	} // matrix_percentile()
+
+	// ////
+	// the k largest elements of each row or column, in decreasing order: line l of the
+	// axis becomes row l of out, which is resized to the number of lines x k
+	// ////
+	template <typename value_type, typename layout_t, typename out_layout_t>
+	bool matrix_top_k(const Matrix2D<value_type, layout_t>& mat, SelectAxis axis, size_t k,
+						Matrix2D<value_type, out_layout_t>& out) {
+		size_t num_lines = 0, len = 0;
+		select_lines_size(mat.num_rows(), mat.num_cols(), axis, num_lines, len);
+		if(k == 0 || k > len) {
+			std::cerr << "error: k should be between 1 and the line length" << std::endl;
+			return false;
+		} // if
+		if(out.num_rows() != num_lines || out.num_cols() != k) out.resize(num_lines, k);
+		SelectTopOp<value_type, out_layout_t> op;
+		op.k_ = k;
+		op.out_ = out.kernel_data();
+		op.out_rows_ = num_lines;
+		op.out_cols_ = k;
+		op.out_ld_ = out.leading_dim();
+		select_lines<layout_t>(mat.data(), mat.num_rows(), mat.num_cols(), mat.leading_dim(), axis, false, op);
+		return true;
+	} // matrix_top_k()
+
+
+	// ////
+	// whole matrix operations
+	// ////
+
+	// ////
+	// copy the elements of a matrix in row-major order
+	// ////
+	template <typename value_type, typename layout_t>
+	void select_gather(const Matrix2D<value_type, layout_t>& mat, std::vector<value_type>& elements) {
+		size_t nrows = mat.num_rows(), ncols = mat.num_cols();
+		elements.resize(nrows * ncols);
+		if(elements.empty()) return;
+		const value_type* buffer = mat.data();
+		size_t ld = mat.leading_dim();
+		if(layout_t::kind == layout_row_major && ld == ncols) {
+			bulk_copy(&elements[0], buffer, elements.size() * sizeof(value_type));
+			return;
+		} // if
+		#pragma omp parallel for schedule(static)
+		for(size_t i = 0; i < nrows; ++ i)
+			for(size_t j = 0; j < ncols; ++ j) elements[i * ncols + j] = buffer[layout_t::index(i, j, nrows, ncols, ld)];
+	} // select_gather()
+
+	// ////
+	// bucket of x: the number of the SELECT_WAYS_ - 1 sorted splitters not greater than x.
+	// a branch-free binary search
+	// ////
+	template <typename value_type>
+	inline size_t select_bucket(const value_type* splitters, value_type x) {
+		size_t b = 0;
+		for(size_t step = SELECT_WAYS_ / 2; step > 0; step /= 2) b += (splitters[b + step - 1] <= x) ? step : 0;
+		return b;
+	} // select_bucket()
+
+	// ////
+	// the n-th smallest of num elements, found by repeated multi-way partitioning:
+	// splitters from a sample divide the elements into SELECT_WAYS_ buckets, the threads count
+	// the bucket sizes of their part, and only the bucket holding rank n is gathered for the
+	// next round. the elements are not changed
+	// ////
+	template <typename value_type>
+	value_type select_partition(const value_type* elements, size_t num, size_t n) {
+		std::vector<value_type> current, next;
+		const value_type* data = elements;
+		int max_threads = 1;
+		#ifdef _OPENMP
+		max_threads = omp_get_max_threads();
+		#endif
+		std::vector<unsigned char> buckets(num);
+		while(num > SELECT_SERIAL_) {
+			// splitters: every SELECT_SAMPLES_-th element of a sorted regular sample
+			std::vector<value_type> sample(SELECT_WAYS_ * SELECT_SAMPLES_);
+			size_t stride = num / sample.size();
+			for(size_t s = 0; s < sample.size(); ++ s) sample[s] = data[stride * s + (s * 7919) % stride];
+			std::sort(sample.begin(), sample.end());
+			std::vector<value_type> splitters(SELECT_WAYS_ - 1);
+			for(size_t b = 1; b < SELECT_WAYS_; ++ b) splitters[b - 1] = sample[b * SELECT_SAMPLES_];
+			const value_type* split = &splitters[0];
+			std::vector<size_t> counts((max_threads + 1) * SELECT_WAYS_, 0);
+			size_t bucket = 0, before = 0;
+			int parts = 1;
+			#pragma omp parallel
+			{
+				int p = 0;
+				#ifdef _OPENMP
+				p = omp_get_thread_num();
+				#pragma omp single
+				parts = omp_get_num_threads();
+				#endif
+				size_t* count = &counts[(p + 1) * SELECT_WAYS_];
+				#pragma omp for schedule(static)
+				for(size_t k = 0; k < num; ++ k) {
+					size_t b = select_bucket(split, data[k]);
+					buckets[k] = (unsigned char) b;
+					++ count[b];
+				} // for
+				#pragma omp single
+				{
+					// bucket totals and the bucket holding rank n
+					for(int q = 1; q <= parts; ++ q)
+						for(size_t b = 0; b < SELECT_WAYS_; ++ b) counts[b] += counts[q * SELECT_WAYS_ + b];
+					while(before + counts[bucket] <= n) before += counts[bucket ++];
+					// offsets of each thread within the gathered bucket
+					size_t offset = 0;
+					for(int q = 1; q <= parts; ++ q) {
+						size_t c = counts[q * SELECT_WAYS_ + bucket];
+						counts[q * SELECT_WAYS_ + bucket] = offset;
+						offset += c;
+					} // for
+					next.resize(counts[bucket]);
+				}
+				if(counts[bucket] < num) {
+					size_t out = count[bucket];
+					#pragma omp for schedule(static)
+					for(size_t k = 0; k < num; ++ k)
+						if(buckets[k] == bucket) next[out ++] = data[k];
+				} // if
+			}
+			if(counts[bucket] == num) break;		// no progress, e.g. all elements equal
+			n -= before;
+			num = counts[bucket];
+			current.swap(next);
+			data = &current[0];
+		} // while
+		if(data == elements) current.assign(elements, elements + num);
+		std::nth_element(current.begin(), current.begin() + n, current.begin() + num);
+		return current[n];
+	} // select_partition()
+
+	// ////
+	// the n-th smallest element of the matrix, the matrix is not changed
+	// ////
+	template <typename value_type, typename layout_t>
+	bool matrix_select(const Matrix2D<value_type, layout_t>& mat, size_t n, value_type& value) {
+		size_t num = mat.size();
+		if(n >= num) {
+			std::cerr << "error: selected rank is not less than the number of elements" << std::endl;
+			return false;
+		} // if
+		if(mat.storage_size() == num) {		// padding free, buffer order does not matter
+			value = select_partition(mat.data(), num, n);
+			return true;
+		} // if
+		std::vector<value_type> elements;
+		select_gather(mat, elements);
+		value = select_partition(&elements[0], num, n);
+		return true;
+	} // matrix_select()
+
+	// ////
+	// percentile (0 to 100) of all elements of the matrix
+	// ////
+	template <typename value_type, typename layout_t>
+	bool matrix_percentile(const Matrix2D<value_type, layout_t>& mat, double percent, double& value) {
+		size_t num = mat.size();
+		if(num == 0) {
+			std::cerr << "error: cannot compute percentiles of an empty matrix" << std::endl;
+			return false;
+		} // if
+		double h = std::min(std::max(percent, 0.0), 100.0) / 100.0 * (num - 1);
+		size_t k = (size_t) h;
+		value_type low, high;
+		if(!matrix_select(mat, k, low)) return false;
+		value = (double) low;
+		if(h > k && k + 1 < num) {
+			if(!matrix_select(mat, k + 1, high)) return false;
+			value += (h - k) * ((double) high - value);
+		} // if
+		return true;
+	} // matrix_percentile()
+
+	// ////
+	// sort num elements with a parallel merge sort: one sorted run per thread, then
+	// rounds of pairwise merges
+	// ////
+	template <typename value_type>
+	void select_sort(value_type* data, size_t num) {
+		size_t parts = 1;
+		#ifdef _OPENMP
+		parts = omp_get_max_threads();
+		#endif
+		if(num < SELECT_SERIAL_ || parts == 1) {
+			std::sort(data, data + num);
+			return;
+		} // if
+		std::vector<size_t> bounds(parts + 1);
+		for(size_t p = 0; p <= parts; ++ p) bounds[p] = num / parts * p + std::min(p, num % parts);
+		#pragma omp parallel for schedule(static)
+		for(size_t p = 0; p < parts; ++ p) std::sort(data + bounds[p], data + bounds[p + 1]);
+		std::vector<value_type> temp(num);
+		value_type *src = data, *dst = &temp[0];
+		for(size_t width = 1; width < parts; width *= 2) {
+			#pragma omp parallel for schedule(static)
+			for(size_t p = 0; p < parts; p += 2 * width) {
+				size_t lo = bounds[p], mid = bounds[std::min(p + width, parts)], hi = bounds[std::min(p + 2 * width, parts)];
+				std::merge(src + lo, src + mid, src + mid, src + hi, dst + lo);
+			} // for
+			std::swap(src, dst);
+		} // for
+		if(src != data) bulk_copy(data, src, num * sizeof(value_type));
+	} // select_sort()
+
+	// ////
+	// sort all elements of the matrix in place, ascending in row-major order of (i, j)
+	// ////
+	template <typename value_type, typename layout_t>
+	bool matrix_sort(Matrix2D<value_type, layout_t>& mat) {
+		size_t nrows = mat.num_rows(), ncols = mat.num_cols();
+		if(nrows == 0 || ncols == 0) return true;
+		value_type* buffer = mat.kernel_data();
+		size_t ld = mat.leading_dim();
+		if(layout_t::kind == layout_row_major && ld == ncols) {
+			select_sort(buffer, nrows * ncols);
+			return true;
+		} // if
+		std::vector<value_type> elements;
+		select_gather(mat, elements);
+		select_sort(&elements[0], elements.size());
+		#pragma omp parallel for schedule(static)
+		for(size_t i = 0; i < nrows; ++ i)
+			for(size_t j = 0; j < ncols; ++ j) buffer[layout_t::index(i, j, nrows, ncols, ld)] = elements[i * ncols + j];
+		return true;
+	} // matrix_sort()
+
+
+	// ////
+	// approximate percentiles of all elements from a histogram of bins bins over [lo, hi],
+	// built in a single parallel pass. elements outside the range count in the first or last
+	// bin. the error is at most about (hi - lo) / bins
+	// ////
+	template <typename value_type, typename layout_t>
+	bool matrix_percentiles_approx(const Matrix2D<value_type, layout_t>& mat, const std::vector<double>& percents,
+									std::vector<double>& values, double lo, double hi,
+									size_t bins = SELECT_BINS_) {
+		size_t nrows = mat.num_rows(), ncols = mat.num_cols(), num = nrows * ncols;
+		if(num == 0 || bins == 0 || !(hi >= lo)) {
+			std::cerr << "error: invalid matrix or histogram for approximate percentiles" << std::endl;
+			return false;
+		} // if
+		std::vector<size_t> hist(bins, 0);
+		double scale = (hi > lo) ? bins / (hi - lo) : 0.0;
+		const value_type* buffer = mat.data();
+		size_t ld = mat.leading_dim();
+		#pragma omp parallel
+		{
+			std::vector<size_t> local(bins, 0);
+			#pragma omp for schedule(static)
+			for(size_t i = 0; i < nrows; ++ i) {
+				for(size_t j = 0; j < ncols; ++ j) {
+					double x = ((double) buffer[layout_t::index(i, j, nrows, ncols, ld)] - lo) * scale;
+					size_t b = (x <= 0.0) ? 0 : std::min((size_t) x, bins - 1);
+					++ local[b];
+				} // for
+			} // for
+			#pragma omp critical (matrix_percentiles_merge)
+			for(size_t b = 0; b < bins; ++ b) hist[b] += local[b];
+		}
+		values.resize(percents.size());
+		double width = (hi - lo) / bins;
+		for(size_t p = 0; p < percents.size(); ++ p) {
+			double h = std::min(std::max(percents[p], 0.0), 100.0) / 100.0 * (num - 1);
+			size_t b = 0, before = 0;
+			while(b + 1 < bins && before + hist[b] <= (size_t) h) before += hist[b ++];
+			// assume the elements of the bin are evenly spread over it
+			double frac = (hist[b] > 0) ? (h - before + 0.5) / hist[b] : 0.5;
+			values[p] = lo + (b + std::min(frac, 1.0)) * width;
+		} // for
+		return true;
+	} // matrix_percentiles_approx()
+
+	// ////
+	// approximate percentiles over the range of the elements, found first by matrix_min_max()
+	// ////
+	template <typename value_type, typename layout_t>
+	bool matrix_percentiles_approx(const Matrix2D<value_type, layout_t>& mat, const std::vector<double>& percents,
+									std::vector<double>& values, size_t bins = SELECT_BINS_) {
+		value_type min_val, max_val;
+		if(!matrix_min_max(mat, min_val, max_val)) return false;
+		return matrix_percentiles_approx(mat, percents, values, (double) min_val, (double) max_val, bins);
+	} // matrix_percentiles_approx()
+
+} // namespace stock
+
+#endif // __SELECT_HPP__
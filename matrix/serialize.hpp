@@ -0,0 +1,658 @@
+/**
+ *  Project: The Stock Libraries
+ *
+ *  File: serialize.hpp
+ *  Created: Oct 18, 2026
+ *
+ *  Author: Abhinav Sarje <abhinav.sarje@gmail.com>
+ *
+ *  Copyright (c) 2012-2017 Abhinav Sarje
+ *  Distributed under the Boost Software License.
+ *  See accompanying LICENSE file.
+ */
+
+#ifndef __SERIALIZE_HPP__
+#define __SERIALIZE_HPP__
+
+#include <vector>
+#include <complex>
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+#include <stdint.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <pthread.h>
+#ifdef USE_ZLIB
+#include <zlib.h>
+#endif
+
+namespace stock {
+
+	/* chunked binary container for matrices (link with -lpthread, and -lz with USE_ZLIB).
+	 *
+	 * file layout:
+	 *   MatrixFileHeader				dims, element type, source layout, chunking, codec
+	 *   chunk 0 ... chunk n-1			blocks of rows_per_chunk rows, in row-major order,
+	 *									each optionally compressed
+	 *   MatrixFileChunk[n]				index: file offset, sizes and checksum of each chunk
+	 *
+	 * the index is written last, so rows can be streamed in without knowing their number,
+	 * and a reader can fetch any row range by reading only the header, the index and the
+	 * chunks which overlap the range. reader and writer overlap the disk I/O of one chunk
+	 * with the encoding or decoding of the next using two buffers and an I/O thread. */
+
+	const uint32_t MATRIX_FILE_VERSION_ = 1;
+	const uint32_t MATRIX_FILE_BYTE_ORDER_ = 0x01020304;
+	const unsigned int MATRIX_FILE_MAX_DIMS_ = 4;
+	const size_t MATRIX_FILE_CHUNK_BYTES_ = 4 << 20;		// default uncompressed chunk size
+
+	enum MatrixFileType {
+		dtype_unknown = 0,
+		dtype_char, dtype_uchar, dtype_short, dtype_ushort,
+		dtype_int, dtype_uint, dtype_long, dtype_ulong,
+		dtype_float, dtype_double, dtype_complex_float, dtype_complex_double
+	};
+
+	enum MatrixFileCompression {
+		compress_none = 0,
+		compress_zlib = 1			/* needs USE_ZLIB */
+	};
+
+	/* element type codes */
+	template <typename value_type> struct MatrixFileTypeOf { static const MatrixFileType code = dtype_unknown; };
+	template <> struct MatrixFileTypeOf<char> { static const MatrixFileType code = dtype_char; };
+	template <> struct MatrixFileTypeOf<unsigned char> { static const MatrixFileType code = dtype_uchar; };
+	template <> struct MatrixFileTypeOf<short> { static const MatrixFileType code = dtype_short; };
+	template <> struct MatrixFileTypeOf<unsigned short> { static const MatrixFileType code = dtype_ushort; };
+	template <> struct MatrixFileTypeOf<int> { static const MatrixFileType code = dtype_int; };
+	template <> struct MatrixFileTypeOf<unsigned int> { static const MatrixFileType code = dtype_uint; };
+	template <> struct MatrixFileTypeOf<long int> { static const MatrixFileType code = dtype_long; };
+	template <> struct MatrixFileTypeOf<unsigned long int> { static const MatrixFileType code = dtype_ulong; };
+	template <> struct MatrixFileTypeOf<float> { static const MatrixFileType code = dtype_float; };
+	template <> struct MatrixFileTypeOf<double> { static const MatrixFileType code = dtype_double; };
+	template <> struct MatrixFileTypeOf<std::complex<float> > { static const MatrixFileType code = dtype_complex_float; };
+	template <> struct MatrixFileTypeOf<std::complex<double> > { static const MatrixFileType code = dtype_complex_double; };
+
+	/* tile dimensions recorded for tiled layouts */
+	template <typename layout_t> struct MatrixFileTiles { static const uint32_t rows = 0, cols = 0; };
+	template <unsigned int TILE_ROWS, unsigned int TILE_COLS>
+	struct MatrixFileTiles<Tiled<TILE_ROWS, TILE_COLS> > { static const uint32_t rows = TILE_ROWS, cols = TILE_COLS; };
+
+
+	struct MatrixFileHeader {
+		char magic[8];				// "STOCKMAT"
+		uint32_t version;
+		uint32_t byte_order;		// MATRIX_FILE_BYTE_ORDER_ as written by the writer
+		uint32_t header_bytes;		// sizeof(MatrixFileHeader)
+		uint32_t dtype;				// MatrixFileType
+		uint32_t elem_size;			// bytes per element
+		uint32_t layout;			// MatrixLayoutKind of the matrix which was saved
+		uint32_t tile_rows, tile_cols;
+		uint32_t num_dims;
+		uint32_t reserved;
+		uint64_t dims[MATRIX_FILE_MAX_DIMS_];	// dims[0] is the number of rows
+		uint64_t rows_per_chunk;
+		uint64_t num_chunks;
+		uint64_t index_offset;		// file offset of the chunk index
+		uint32_t compression;		// MatrixFileCompression
+		uint32_t checksum;			// whether chunks carry a checksum
+	}; // struct MatrixFileHeader
+
+	struct MatrixFileChunk {
+		uint64_t offset;			// file offset of the chunk
+		uint64_t bytes;				// bytes stored in the file
+		uint64_t raw_bytes;			// bytes after decompression
+		uint32_t checksum;			// crc-32 of the stored bytes
+		uint32_t reserved;
+	}; // struct MatrixFileChunk
+
+	struct MatrixFileOptions {
+		size_t rows_per_chunk;					// 0 => about MATRIX_FILE_CHUNK_BYTES_ per chunk
+		MatrixFileCompression compression;
+		int level;								// compression level
+		bool checksum;
+
+		MatrixFileOptions(): rows_per_chunk(0), compression(compress_none), level(1), checksum(true) { }
+	}; // struct MatrixFileOptions
+
+
+	// ////
+	// crc-32 (ieee polynomial), table driven
+	// ////
+	struct MatrixFileCrcTable {
+		uint32_t table[256];
+
+		MatrixFileCrcTable() {
+			for(uint32_t i = 0; i < 256; ++ i) {
+				uint32_t c = i;
+				for(int k = 0; k < 8; ++ k) c = (c & 1) ? (0xedb88320u ^ (c >> 1)) : (c >> 1);
+				table[i] = c;
+			} // for
+		} // MatrixFileCrcTable()
+	}; // struct MatrixFileCrcTable
+
+	inline uint32_t matrix_file_crc32(const void* data, size_t bytes, uint32_t crc = 0) {
+		// built once by the static initializer, which is thread safe when several threads
+		// serialize concurrently
+		static const MatrixFileCrcTable crc_table;
+		const uint32_t* table = crc_table.table;
+		const unsigned char* p = (const unsigned char*) data;
+		crc = ~crc;
+		for(size_t i = 0; i < bytes; ++ i) crc = table[(crc ^ p[i]) & 0xff] ^ (crc >> 8);
+		return ~crc;
+	} // matrix_file_crc32()
+
+
+	/* a background thread performing one positioned read or write at a time.
+	 * submit() hands a buffer to the thread, wait() blocks until it is done with it */
+	class AsyncFileIO {
+		private:
+			pthread_t thread_;
+			pthread_mutex_t mutex_;
+			pthread_cond_t cond_;
+			bool started_;
+			bool pending_;			// a request is queued or running
+			bool quit_;
+			bool status_;			// result of the last request
+			bool write_;
+			int fd_;
+			char* buffer_;
+			size_t bytes_;
+			off_t offset_;
+
+			AsyncFileIO(const AsyncFileIO&);
+			AsyncFileIO& operator=(const AsyncFileIO&);
+
+			static void* run(void* arg) {
+				AsyncFileIO* io = (AsyncFileIO*) arg;
+				pthread_mutex_lock(&io->mutex_);
+				while(true) {
+					while(!io->pending_ && !io->quit_) pthread_cond_wait(&io->cond_, &io->mutex_);
+					if(!io->pending_ && io->quit_) break;
+					pthread_mutex_unlock(&io->mutex_);
+					bool status = io->transfer();
+					pthread_mutex_lock(&io->mutex_);
+					io->status_ = status;
+					io->pending_ = false;
+					pthread_cond_broadcast(&io->cond_);
+				} // while
+				pthread_mutex_unlock(&io->mutex_);
+				return NULL;
+			} // run()
+
+			bool transfer() {
+				size_t done = 0;
+				while(done < bytes_) {
+					ssize_t n = write_ ? pwrite(fd_, buffer_ + done, bytes_ - done, offset_ + done) :
+											pread(fd_, buffer_ + done, bytes_ - done, offset_ + done);
+					if(n <= 0) return false;
+					done += n;
+				} // while
+				return true;
+			} // transfer()
+
+		public:
+			AsyncFileIO(): started_(false), pending_(false), quit_(false), status_(true),
+					write_(false), fd_(-1), buffer_(NULL), bytes_(0), offset_(0) {
+				pthread_mutex_init(&mutex_, NULL);
+				pthread_cond_init(&cond_, NULL);
+				started_ = (pthread_create(&thread_, NULL, run, this) == 0);
+			} // AsyncFileIO()
+
+			~AsyncFileIO() {
+				if(started_) {
+					pthread_mutex_lock(&mutex_);
+					quit_ = true;
+					pthread_cond_broadcast(&cond_);
+					pthread_mutex_unlock(&mutex_);
+					pthread_join(thread_, NULL);
+				} // if
+				pthread_cond_destroy(&cond_);
+				pthread_mutex_destroy(&mutex_);
+			} // ~AsyncFileIO()
+
+			// ////
+			// queue a transfer, after the previous one is done. runs synchronously without a thread
+			// ////
+			bool submit(bool write, int fd, void* buffer, size_t bytes, off_t offset) {
+				bool status = wait();
+				write_ = write; fd_ = fd; buffer_ = (char*) buffer; bytes_ = bytes; offset_ = offset;
+				if(!started_) return transfer() && status;
+				pthread_mutex_lock(&mutex_);
+				pending_ = true;
+				pthread_cond_broadcast(&cond_);
+				pthread_mutex_unlock(&mutex_);
+				return status;
+			} // submit()
+
+			// ////
+			// wait for the current transfer, returns whether it succeeded
+			// ////
+			bool wait() {
+				if(!started_) return true;
+				pthread_mutex_lock(&mutex_);
+				while(pending_) pthread_cond_wait(&cond_, &mutex_);
+				bool status = status_;
+				status_ = true;
+				pthread_mutex_unlock(&mutex_);
+				return status;
+			} // wait()
+	}; // class AsyncFileIO
+
+
+	/* streaming writer: rows are appended in row-major order and written out a chunk at a time */
+	class MatrixFileWriter {
+		private:
+			int fd_;
+			MatrixFileHeader header_;
+			MatrixFileOptions options_;
+			size_t row_bytes_;
+			size_t chunk_bytes_;			// uncompressed bytes of a full chunk
+			std::vector<char> raw_[2];		// chunk being filled, and the one being written
+			std::vector<char> packed_[2];	// compressed chunks
+			int current_;					// buffer being filled
+			size_t fill_;					// bytes in the current buffer
+			uint64_t num_rows_;
+			uint64_t offset_;				// where the next chunk goes
+			std::vector<MatrixFileChunk> index_;
+			AsyncFileIO io_;
+			bool status_;
+
+			MatrixFileWriter(const MatrixFileWriter&);
+			MatrixFileWriter& operator=(const MatrixFileWriter&);
+
+			// ////
+			// encode the current chunk and hand it to the I/O thread
+			// ////
+			bool flush_chunk() {
+				if(fill_ == 0) return true;
+				char* data = &raw_[current_][0];
+				size_t bytes = fill_;
+			#ifdef USE_ZLIB
+				if(options_.compression == compress_zlib) {
+					uLongf packed = compressBound(fill_);
+					packed_[current_].resize(packed);
+					if(compress2((Bytef*) &packed_[current_][0], &packed, (const Bytef*) data, fill_,
+									options_.level) != Z_OK) {
+						std::cerr << "error: failed to compress matrix chunk" << std::endl;
+						return false;
+					} // if
+					data = &packed_[current_][0];
+					bytes = packed;
+				} // if
+			#endif
+				MatrixFileChunk chunk;
+				chunk.offset = offset_;
+				chunk.bytes = bytes;
+				chunk.raw_bytes = fill_;
+				chunk.checksum = options_.checksum ? matrix_file_crc32(data, bytes) : 0;
+				chunk.reserved = 0;
+				index_.push_back(chunk);
+				if(!io_.submit(true, fd_, data, bytes, offset_)) {
+					std::cerr << "error: failed to write matrix chunk" << std::endl;
+					return false;
+				} // if
+				offset_ += bytes;
+				current_ = 1 - current_;
+				fill_ = 0;
+				return true;
+			} // flush_chunk()
+
+		public:
+			MatrixFileWriter(): fd_(-1), row_bytes_(0), chunk_bytes_(0), current_(0), fill_(0),
+					num_rows_(0), offset_(0), status_(false) {
+				memset(&header_, 0, sizeof(header_));
+			} // MatrixFileWriter()
+
+			~MatrixFileWriter() { close(); }
+
+			// ////
+			// start a file for rows of dims[1] x ... elements of type value_type.
+			// dims[0], the number of rows, is counted as rows are written
+			// ////
+			template <typename value_type>
+			bool open(const char* path, const std::vector<size_t>& dims, MatrixLayoutKind layout,
+						const MatrixFileOptions& options = MatrixFileOptions(),
+						uint32_t tile_rows = 0, uint32_t tile_cols = 0) {
+				close();
+				if(dims.size() < 1 || dims.size() > MATRIX_FILE_MAX_DIMS_) {
+					std::cerr << "error: unsupported number of dimensions for matrix file" << std::endl;
+					return false;
+				} // if
+				options_ = options;
+			#ifndef USE_ZLIB
+				if(options_.compression != compress_none) {
+					std::cerr << "warning: compression not available, writing uncompressed" << std::endl;
+					options_.compression = compress_none;
+				} // if
+			#endif
+				fd_ = ::open(path, O_WRONLY | O_CREAT | O_TRUNC, 0644);
+				if(fd_ < 0) {
+					std::cerr << "error: failed to open file " << path << " for writing" << std::endl;
+					return false;
+				} // if
+				memset(&header_, 0, sizeof(header_));
+				memcpy(header_.magic, "STOCKMAT", 8);
+				header_.version = MATRIX_FILE_VERSION_;
+				header_.byte_order = MATRIX_FILE_BYTE_ORDER_;
+				header_.header_bytes = sizeof(MatrixFileHeader);
+				header_.dtype = MatrixFileTypeOf<value_type>::code;
+				header_.elem_size = sizeof(value_type);
+				header_.layout = layout;
+				header_.tile_rows = tile_rows;
+				header_.tile_cols = tile_cols;
+				header_.num_dims = dims.size();
+				row_bytes_ = sizeof(value_type);
+				for(size_t d = 0; d < dims.size(); ++ d) {
+					header_.dims[d] = dims[d];
+					if(d > 0) row_bytes_ *= dims[d];
+				} // for
+				size_t rows_per_chunk = options_.rows_per_chunk;
+				if(rows_per_chunk == 0) rows_per_chunk = MATRIX_FILE_CHUNK_BYTES_ / (row_bytes_ > 0 ? row_bytes_ : 1);
+				if(rows_per_chunk == 0) rows_per_chunk = 1;
+				header_.rows_per_chunk = rows_per_chunk;
+				header_.compression = options_.compression;
+				header_.checksum = options_.checksum ? 1 : 0;
+				chunk_bytes_ = rows_per_chunk * row_bytes_;
+				raw_[0].resize(chunk_bytes_ > 0 ? chunk_bytes_ : 1);
+				raw_[1].resize(chunk_bytes_ > 0 ? chunk_bytes_ : 1);
+				current_ = 0;
+				fill_ = 0;
+				num_rows_ = 0;
+				offset_ = sizeof(MatrixFileHeader);
+				index_.clear();
+				status_ = true;
+				return true;
+			} // open()
+
+			// ////
+			// append num rows given in row-major order
+			// ////
+			bool write_rows(const void* rows, size_t num) {
+				if(fd_ < 0 || !status_) return false;
+				const char* src = (const char*) rows;
+				size_t bytes = num * row_bytes_;
+				while(bytes > 0) {
+					size_t n = std::min(bytes, chunk_bytes_ - fill_);
+					memcpy(&raw_[current_][fill_], src, n);
+					fill_ += n; src += n; bytes -= n;
+					if(fill_ == chunk_bytes_ && !flush_chunk()) return status_ = false;
+				} // while
+				num_rows_ += num;
+				return true;
+			} // write_rows()
+
+			// ////
+			// direct access to the chunk being filled, to pack rows without a staging copy.
+			// reserve_rows() returns space for up to num rows, commit_rows() appends them
+			// ////
+			void* reserve_rows(size_t& num) {
+				if(fd_ < 0 || !status_) { num = 0; return NULL; }
+				size_t avail = (chunk_bytes_ - fill_) / (row_bytes_ > 0 ? row_bytes_ : 1);
+				if(num > avail) num = avail;
+				return &raw_[current_][fill_];
+			} // reserve_rows()
+
+			bool commit_rows(size_t num) {
+				fill_ += num * row_bytes_;
+				num_rows_ += num;
+				if(fill_ == chunk_bytes_ && !flush_chunk()) return status_ = false;
+				return status_;
+			} // commit_rows()
+
+			// ////
+			// flush the last chunk, write the index and the final header
+			// ////
+			bool close() {
+				if(fd_ < 0) return false;
+				bool status = status_ && flush_chunk();
+				status = io_.wait() && status;
+				header_.dims[0] = num_rows_;
+				header_.num_chunks = index_.size();
+				header_.index_offset = offset_;
+				size_t index_bytes = index_.size() * sizeof(MatrixFileChunk);
+				if(index_bytes > 0 && pwrite(fd_, &index_[0], index_bytes, offset_) != (ssize_t) index_bytes)
+					status = false;
+				if(pwrite(fd_, &header_, sizeof(header_), 0) != (ssize_t) sizeof(header_)) status = false;
+				if(::close(fd_) != 0) status = false;
+				fd_ = -1;
+				if(!status) std::cerr << "error: failed to write matrix file" << std::endl;
+				return status;
+			} // close()
+
+			size_t rows_per_chunk() const { return header_.rows_per_chunk; }
+	}; // class MatrixFileWriter
+
+
+	/* random-access reader: header and index are read on open,
+	 * rows are read by chunk on demand */
+	class MatrixFileReader {
+		private:
+			int fd_;
+			MatrixFileHeader header_;
+			std::vector<MatrixFileChunk> index_;
+			size_t row_bytes_;
+			std::vector<char> stored_[2];	// chunk being read, and the one being decoded
+			std::vector<char> raw_;			// decompressed chunk
+			AsyncFileIO io_;
+
+			MatrixFileReader(const MatrixFileReader&);
+			MatrixFileReader& operator=(const MatrixFileReader&);
+
+			// ////
+			// check and decode a chunk which has been read into buffer
+			// ////
+			const char* decode(size_t k, char* buffer) {
+				const MatrixFileChunk& chunk = index_[k];
+				if(header_.checksum && matrix_file_crc32(buffer, chunk.bytes) != chunk.checksum) {
+					std::cerr << "error: checksum mismatch in matrix file chunk " << k << std::endl;
+					return NULL;
+				} // if
+				if(header_.compression == compress_none) return buffer;
+			#ifdef USE_ZLIB
+				if(header_.compression == compress_zlib) {
+					raw_.resize(chunk.raw_bytes > 0 ? chunk.raw_bytes : 1);
+					uLongf raw = chunk.raw_bytes;
+					if(uncompress((Bytef*) &raw_[0], &raw, (const Bytef*) buffer, chunk.bytes) != Z_OK ||
+							raw != chunk.raw_bytes) {
+						std::cerr << "error: failed to decompress matrix file chunk " << k << std::endl;
+						return NULL;
+					} // if
+					return &raw_[0];
+				} // if
+			#endif
+				std::cerr << "error: unsupported compression in matrix file" << std::endl;
+				return NULL;
+			} // decode()
+
+		public:
+			MatrixFileReader(): fd_(-1), row_bytes_(0) { memset(&header_, 0, sizeof(header_)); }
+			~MatrixFileReader() { close(); }
+
+			bool open(const char* path) {
+				close();
+				fd_ = ::open(path, O_RDONLY);
+				if(fd_ < 0) {
+					std::cerr << "error: failed to open file " << path << " for reading" << std::endl;
+					return false;
+				} // if
+				if(pread(fd_, &header_, sizeof(header_), 0) != (ssize_t) sizeof(header_) ||
+						memcmp(header_.magic, "STOCKMAT", 8) != 0) {
+					std::cerr << "error: " << path << " is not a matrix file" << std::endl;
+					close();
+					return false;
+				} // if
+				if(header_.byte_order != MATRIX_FILE_BYTE_ORDER_ || header_.version > MATRIX_FILE_VERSION_ ||
+						header_.num_dims < 1 || header_.num_dims > MATRIX_FILE_MAX_DIMS_) {
+					std::cerr << "error: unsupported version or byte order of matrix file " << path << std::endl;
+					close();
+					return false;
+				} // if
+				row_bytes_ = header_.elem_size;
+				for(uint32_t d = 1; d < header_.num_dims; ++ d) row_bytes_ *= header_.dims[d];
+				// the header and index are not covered by the checksums: check that they are consistent
+				// before any chunk is read through them
+				if(header_.elem_size == 0 || header_.rows_per_chunk == 0 ||
+						header_.num_chunks != header_.dims[0] / header_.rows_per_chunk +
+											(header_.dims[0] % header_.rows_per_chunk != 0)) {
+					std::cerr << "error: inconsistent header in matrix file " << path << std::endl;
+					close();
+					return false;
+				} // if
+				index_.resize(header_.num_chunks);
+				size_t index_bytes = header_.num_chunks * sizeof(MatrixFileChunk);
+				if(index_bytes > 0 &&
+						pread(fd_, &index_[0], index_bytes, header_.index_offset) != (ssize_t) index_bytes) {
+					std::cerr << "error: failed to read index of matrix file " << path << std::endl;
+					close();
+					return false;
+				} // if
+				for(size_t k = 0; k < index_.size(); ++ k) {
+					// every chunk holds rows_per_chunk rows, except a shorter last one
+					size_t rows = std::min((size_t) header_.rows_per_chunk,
+											(size_t) (header_.dims[0] - k * header_.rows_per_chunk));
+					if(index_[k].raw_bytes != rows * row_bytes_ ||
+							(header_.compression == compress_none && index_[k].bytes != index_[k].raw_bytes)) {
+						std::cerr << "error: inconsistent index of matrix file " << path << std::endl;
+						close();
+						return false;
+					} // if
+				} // for
+				return true;
+			} // open()
+
+			void close() {
+				io_.wait();
+				if(fd_ >= 0) ::close(fd_);
+				fd_ = -1;
+				index_.clear();
+			} // close()
+
+			const MatrixFileHeader& header() const { return header_; }
+			size_t num_rows() const { return header_.dims[0]; }
+			size_t num_cols() const { return (header_.num_dims > 1) ? header_.dims[1] : 1; }
+			size_t row_bytes() const { return row_bytes_; }
+			MatrixFileType dtype() const { return (MatrixFileType) header_.dtype; }
+			MatrixLayoutKind layout() const { return (MatrixLayoutKind) header_.layout; }
+
+			// ////
+			// read rows [begin, end) into out, in row-major order.
+			// the next chunk is read in the background while the current one is decoded
+			// ////
+			bool read_rows(size_t begin, size_t end, void* out) {
+				if(fd_ < 0) return false;
+				if(begin > end || end > num_rows()) {
+					std::cerr << "error: row range out of bounds of matrix file" << std::endl;
+					return false;
+				} // if
+				if(begin == end) return true;
+				size_t rpc = header_.rows_per_chunk;
+				size_t first = begin / rpc, last = (end - 1) / rpc;
+				size_t max_bytes = 1;
+				for(size_t k = first; k <= last; ++ k) max_bytes = std::max(max_bytes, (size_t) index_[k].bytes);
+				stored_[0].resize(max_bytes);
+				stored_[1].resize(max_bytes);
+				bool status = io_.submit(false, fd_, &stored_[0][0], index_[first].bytes, index_[first].offset);
+				char* dst = (char*) out;
+				for(size_t k = first; k <= last && status; ++ k) {
+					status = io_.wait();
+					char* buffer = &stored_[(k - first) % 2][0];
+					if(k < last) {
+						const MatrixFileChunk& next = index_[k + 1];
+						status = io_.submit(false, fd_, &stored_[(k + 1 - first) % 2][0], next.bytes, next.offset) && status;
+					} // if
+					const char* raw = status ? decode(k, buffer) : NULL;
+					if(raw == NULL) {
+						status = false;
+						break;
+					} // if
+					size_t row0 = std::max(begin, k * rpc), row1 = std::min(end, (k + 1) * rpc);
+					size_t bytes = (row1 - row0) * row_bytes_;
+					memcpy(dst, raw + (row0 - k * rpc) * row_bytes_, bytes);
+					dst += bytes;
+				} // for
+				status = io_.wait() && status;
+				if(!status) std::cerr << "error: failed to read rows from matrix file" << std::endl;
+				return status;
+			} // read_rows()
+	}; // class MatrixFileReader
+
+
+	// ////
+	// save a matrix. rows are packed into the chunk buffers directly from the layout
+	// ////
+	template <typename value_type, typename layout_t>
+	bool matrix_save(const char* path, const Matrix2D<value_type, layout_t>& mat,
+						const MatrixFileOptions& options = MatrixFileOptions()) {
+		std::vector<size_t> dims;
+		dims.push_back(mat.num_rows());
+		dims.push_back(mat.num_cols());
+		MatrixFileWriter writer;
+		if(!writer.open<value_type>(path, dims, layout_t::kind, options,
+					MatrixFileTiles<layout_t>::rows, MatrixFileTiles<layout_t>::cols)) return false;
+		size_t rows = mat.num_rows(), cols = mat.num_cols();
+		size_t i = 0;
+		while(i < rows) {
+			size_t num = rows - i;
+			value_type* out = (value_type*) writer.reserve_rows(num);
+			if(out == NULL || num == 0) break;
+			if(layout_t::kind == layout_row_major && mat.leading_dim() == cols) {
+				memcpy(out, &mat(i, 0), num * cols * sizeof(value_type));
+			} else if(layout_t::kind == layout_row_major) {		// padded rows
+				#pragma omp parallel for schedule(static)
+				for(size_t r = 0; r < num; ++ r) memcpy(out + r * cols, &mat(i + r, 0), cols * sizeof(value_type));
+			} else {
+				#pragma omp parallel for schedule(static)
+				for(size_t r = 0; r < num; ++ r) {
+					for(size_t c = 0; c < cols; ++ c) out[r * cols + c] = mat(i + r, c);
+				} // for
+			} // if-else
+			if(!writer.commit_rows(num)) break;
+			i += num;
+		} // while
+		return writer.close() && i == rows;
+	} // matrix_save()
+
+
+	// ////
+	// load rows [begin, end) of a saved matrix into mat, which is resized to hold them
+	// ////
+	template <typename value_type, typename layout_t>
+	bool matrix_load_rows(const char* path, size_t begin, size_t end, Matrix2D<value_type, layout_t>& mat) {
+		MatrixFileReader reader;
+		if(!reader.open(path)) return false;
+		if(reader.dtype() != MatrixFileTypeOf<value_type>::code ||
+				reader.header().elem_size != sizeof(value_type) || reader.header().num_dims != 2) {
+			std::cerr << "error: element type or dimensions of matrix file do not match the matrix" << std::endl;
+			return false;
+		} // if
+		if(end > reader.num_rows() || begin > end) {
+			std::cerr << "error: row range out of bounds of matrix file" << std::endl;
+			return false;
+		} // if
+		size_t rows = end - begin, cols = reader.num_cols();
+		if(mat.num_rows() != rows || mat.num_cols() != cols || mat.kernel_data() == NULL) mat.resize(rows, cols);
+		if(layout_t::kind == layout_row_major && mat.leading_dim() == cols)
+			return reader.read_rows(begin, end, mat.kernel_data());
+		std::vector<value_type> temp(rows * cols);
+		if(rows > 0 && !reader.read_rows(begin, end, &temp[0])) return false;
+		return rows == 0 || mat.populate(&temp[0]);
+	} // matrix_load_rows()
+
+
+	// ////
+	// load a whole saved matrix into mat
+	// ////
+	template <typename value_type, typename layout_t>
+	bool matrix_load(const char* path, Matrix2D<value_type, layout_t>& mat) {
+		MatrixFileReader reader;
+		if(!reader.open(path)) return false;
+		size_t rows = reader.num_rows();
+		reader.close();
+		return matrix_load_rows(path, 0, rows, mat);
+	} // matrix_load()
+
+} // namespace stock
+
+#endif // __SERIALIZE_HPP__
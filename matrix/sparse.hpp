@@ -0,0 +1,1048 @@
+/**
+ *  Project: The Stock Libraries
+ *
+ *  File: sparse.hpp
+ *  Created: Oct 18, 2026
+ *
+ *  Author: Abhinav Sarje <abhinav.sarje@gmail.com>
+ *
+ *  Copyright (c) 2012-2017 Abhinav Sarje
+ *  Distributed under the Boost Software License.
+ *  See accompanying LICENSE file.
+ */
+
+#ifndef __SPARSE_HPP__
+#define __SPARSE_HPP__
+
+#include <new>
+#include <vector>
+#include <complex>
+#include <iostream>
+#include <algorithm>
+#include <utility>
+#include <cstddef>
+#ifdef _OPENMP
+#include <omp.h>
+#endif
+
+namespace stock {
+
+	/* compressed sparse matrices. CSRMatrix stores the nonzeros row by row, CSCMatrix column by
+	 * column. both keep, for each outer line (row or column), the start of the line in the arrays
+	 * of inner indices and values; inner indices are sorted within each line.
+	 * index_t is the type of the stored inner indices, e.g. unsigned int halves the index
+	 * traffic of products when the dimensions fit in 32 bits.
+	 * work is split among threads by the number of stored elements, not the number of lines,
+	 * so that a few dense lines do not serialize a product. */
+
+	template <typename value_type, typename index_t = size_t> class CompressedMatrix;
+	template <typename value_type, typename index_t = size_t> class CSRMatrix;
+	template <typename value_type, typename index_t = size_t> class CSCMatrix;
+	template <typename value_type, typename index_t = size_t> class SparseBuilder;
+
+
+	// ////
+	// magnitude compared against the threshold when compressing a dense matrix
+	// ////
+	template <typename value_type>
+	inline double sparse_magnitude(value_type val) {
+		return (val < value_type(0)) ? - (double) val : (double) val;
+	} // sparse_magnitude()
+
+	template <typename real_t>
+	inline double sparse_magnitude(const std::complex<real_t>& val) {
+		return std::abs(val);
+	} // sparse_magnitude()
+
+
+	// ////
+	// number of threads in the current parallel region and the id of this one
+	// ////
+	inline void sparse_thread(size_t& num_threads, size_t& thread) {
+		num_threads = 1; thread = 0;
+		#ifdef _OPENMP
+		num_threads = omp_get_num_threads();
+		thread = omp_get_thread_num();
+		#endif
+	} // sparse_thread()
+
+	inline size_t sparse_max_threads() {
+		#ifdef _OPENMP
+		return omp_get_max_threads();
+		#else
+		return 1;
+		#endif
+	} // sparse_max_threads()
+
+
+	// ////
+	// first line of part p when lines [0, num) with starts ptr are split into parts of equal
+	// work, counting one unit per stored element and per line
+	// ////
+	inline size_t sparse_split(const size_t* ptr, size_t num, size_t p, size_t parts) {
+		if(p == 0) return 0;
+		if(p >= parts) return num;
+		size_t total = ptr[num] + num;
+		size_t target = total / parts * p + (total % parts) * p / parts;
+		size_t lo = 0, hi = num;
+		while(lo < hi) {
+			size_t mid = lo + (hi - lo) / 2;
+			if(ptr[mid] + mid < target) lo = mid + 1;
+			else hi = mid;
+		} // while
+		return lo;
+	} // sparse_split()
+
+
+	// ////
+	// convert counts per line, stored in ptr[0, num), into line starts, with ptr[num] the total
+	// ////
+	inline void sparse_scan(std::vector<size_t>& ptr, size_t num) {
+		size_t sum = 0;
+		for(size_t i = 0; i < num; ++ i) {
+			size_t count = ptr[i];
+			ptr[i] = sum;
+			sum += count;
+		} // for
+		ptr[num] = sum;
+	} // sparse_scan()
+
+
+	/* orders (inner index, value) pairs of a line by index */
+	template <typename value_type, typename index_t>
+	struct SparseEntryLess {
+		bool operator()(const std::pair<index_t, value_type>& a, const std::pair<index_t, value_type>& b) const {
+			return a.first < b.first;
+		} // operator()()
+	}; // struct SparseEntryLess
+
+
+	/* iterator over the outer lines of a compressed matrix, the rows of a CSRMatrix or the
+	 * columns of a CSCMatrix. it moves between lines like RowIterator, and operator[](k) gives
+	 * the k-th stored element of the current line, whose inner index is index(k) */
+	template <typename value_type, typename index_t>
+	class SparseLineIterator {
+		private:
+			typedef CompressedMatrix<value_type, index_t> matrix_t;
+			matrix_t* parent_mat_;				// is iterator of this object
+			size_t line_;						// current line, num_outer_ at the end
+
+		public:
+			SparseLineIterator(): parent_mat_(NULL), line_(0) { }
+			SparseLineIterator(size_t line, matrix_t* mat): parent_mat_(mat), line_(line) {
+				if(line_ > parent_mat_->num_outer_) line_ = parent_mat_->num_outer_;
+			} // SparseLineIterator()
+
+			/* increment to next line */
+			void operator++() {
+				if(line_ < parent_mat_->num_outer_) ++ line_;
+			} // operator++()
+
+			/* decrement to previous line */
+			void operator--() {
+				if(line_ > 0) -- line_;
+			} // operator--()
+
+			/* return the k-th stored element of the current line */
+			value_type& operator[](size_t k) {
+				return parent_mat_->val_[parent_mat_->ptr_[line_] + k];
+			} // operator[]()
+
+			/* inner index (column of a row, row of a column) of the k-th stored element */
+			size_t index(size_t k) const {
+				return parent_mat_->idx_[parent_mat_->ptr_[line_] + k];
+			} // index()
+
+			/* element at inner index j of the current line, zero when it is not stored */
+			value_type value(size_t j) const {
+				return parent_mat_->find(line_, j);
+			} // value()
+
+			/* comparison operators */
+
+			bool operator==(SparseLineIterator other) const {
+				return (other.line_ == line_ && other.parent_mat_ == parent_mat_);
+			} // operator==()
+
+			bool operator!=(SparseLineIterator other) const {
+				return !(other.line_ == line_ && other.parent_mat_ == parent_mat_);
+			} // operator!=()
+
+			/* the stored elements of the line are contiguous */
+			value_type* values() { return &parent_mat_->val_[0] + parent_mat_->ptr_[line_]; }
+			const index_t* indices() const { return &parent_mat_->idx_[0] + parent_mat_->ptr_[line_]; }
+
+			size_t line() const { return line_; }
+			size_t size() const { return parent_mat_->ptr_[line_ + 1] - parent_mat_->ptr_[line_]; }
+
+	}; // class SparseLineIterator
+
+
+	/* storage and kernels shared by CSRMatrix and CSCMatrix, in terms of outer lines and
+	 * inner indices */
+	template <typename value_type, typename index_t>
+	class CompressedMatrix {
+		protected:
+			size_t num_outer_;					// number of lines
+			size_t num_inner_;					// length of each line
+			std::vector<size_t> ptr_;			// start of each line in idx_ and val_, num_outer_ + 1 entries
+			std::vector<index_t> idx_;			// inner index of each stored element
+			std::vector<value_type> val_;		// stored elements
+
+			friend class SparseLineIterator<value_type, index_t>;
+			friend class SparseBuilder<value_type, index_t>;
+
+			CompressedMatrix(size_t outer, size_t inner):
+				num_outer_(outer), num_inner_(inner), ptr_(outer + 1, 0) { }
+
+
+			// ////
+			// empty matrix of the given dimensions
+			// ////
+			void reset(size_t outer, size_t inner) {
+				num_outer_ = outer;
+				num_inner_ = inner;
+				ptr_.assign(outer + 1, 0);
+				idx_.clear();
+				val_.clear();
+			} // reset()
+
+
+			// ////
+			// element (line, j), zero when it is not stored
+			// ////
+			value_type find(size_t line, size_t j) const {
+				if(line >= num_outer_ || j >= num_inner_) return value_type(0);
+				typename std::vector<index_t>::const_iterator begin = idx_.begin() + ptr_[line];
+				typename std::vector<index_t>::const_iterator end = idx_.begin() + ptr_[line + 1];
+				typename std::vector<index_t>::const_iterator pos = std::lower_bound(begin, end, (index_t) j);
+				if(pos == end || *pos != (index_t) j) return value_type(0);
+				return val_[pos - idx_.begin()];
+			} // find()
+
+
+			// ////
+			// store the elements of a dense matrix with magnitude above threshold. by_rows makes
+			// the rows the outer lines. the matrix is read along its contiguous direction, and
+			// transposed afterwards when that is not the outer direction
+			// ////
+			template <typename layout_t>
+			bool compress(const Matrix2D<value_type, layout_t>& mat, double threshold, bool by_rows) {
+				bool rows_contiguous = (layout_t::kind != layout_column_major);
+				if(by_rows != rows_contiguous) {
+					CompressedMatrix temp(0, 0);
+					if(!temp.compress(mat, threshold, rows_contiguous)) return false;
+					temp.transpose_into(*this);
+					return true;
+				} // if
+				size_t outer = by_rows ? mat.num_rows() : mat.num_cols();
+				size_t inner = by_rows ? mat.num_cols() : mat.num_rows();
+				reset(outer, inner);
+				#pragma omp parallel for schedule(static)
+				for(size_t o = 0; o < outer; ++ o) {
+					size_t count = 0;
+					for(size_t i = 0; i < inner; ++ i) {
+						const value_type& val = by_rows ? mat(o, i) : mat(i, o);
+						if(sparse_magnitude(val) > threshold) ++ count;
+					} // for
+					ptr_[o] = count;
+				} // for
+				sparse_scan(ptr_, outer);
+				idx_.resize(ptr_[outer]);
+				val_.resize(ptr_[outer]);
+				#pragma omp parallel for schedule(static)
+				for(size_t o = 0; o < outer; ++ o) {
+					size_t k = ptr_[o];
+					for(size_t i = 0; i < inner; ++ i) {
+						const value_type& val = by_rows ? mat(o, i) : mat(i, o);
+						if(sparse_magnitude(val) > threshold) {
+							idx_[k] = (index_t) i;
+							val_[k] = val;
+							++ k;
+						} // if
+					} // for
+				} // for
+				return true;
+			} // compress()
+
+
+			// ////
+			// write all elements into a dense matrix, by_rows when the outer lines are rows
+			// ////
+			template <typename layout_t>
+			bool expand(Matrix2D<value_type, layout_t>& mat, bool by_rows) const {
+				size_t rows = by_rows ? num_outer_ : num_inner_;
+				size_t cols = by_rows ? num_inner_ : num_outer_;
+				if(mat.num_rows() != rows || mat.num_cols() != cols || mat.kernel_data() == NULL) mat.resize(rows, cols);
+				else mat.fill(value_type(0));
+				const size_t* ptr = &ptr_[0];
+				const size_t outer = num_outer_;
+				#pragma omp parallel
+				{
+					size_t parts, p;
+					sparse_thread(parts, p);
+					size_t begin = sparse_split(ptr, outer, p, parts), end = sparse_split(ptr, outer, p + 1, parts);
+					for(size_t o = begin; o < end; ++ o) {
+						for(size_t k = ptr[o]; k < ptr[o + 1]; ++ k) {
+							if(by_rows) mat(o, idx_[k]) = val_[k];
+							else mat(idx_[k], o) = val_[k];
+						} // for
+					} // for
+				}
+				return true;
+			} // expand()
+
+
+			// ////
+			// store the transpose into out, whose outer lines are then the inner lines of this.
+			// lines are split into parts which count their elements per output line separately,
+			// so the elements are placed without atomics and stay sorted. the number of parts is
+			// limited so that the counters do not take much more memory than the elements
+			// ////
+			void transpose_into(CompressedMatrix& out) const {
+				const size_t outer = num_outer_, inner = num_inner_, nnz = ptr_[outer];
+				out.reset(inner, outer);
+				out.idx_.resize(nnz);
+				out.val_.resize(nnz);
+				if(nnz == 0) return;
+				size_t parts = std::min(sparse_max_threads(), 1 + nnz / (inner + 1));
+				std::vector<size_t> count(parts * inner, 0);
+				const size_t* ptr = &ptr_[0];
+				#pragma omp parallel for schedule(static)
+				for(size_t p = 0; p < parts; ++ p) {
+					size_t* cnt = &count[p * inner];
+					size_t end = ptr[sparse_split(ptr, outer, p + 1, parts)];
+					for(size_t k = ptr[sparse_split(ptr, outer, p, parts)]; k < end; ++ k) ++ cnt[idx_[k]];
+				} // for
+				// offset of each part within each output line
+				#pragma omp parallel for schedule(static)
+				for(size_t i = 0; i < inner; ++ i) {
+					size_t sum = 0;
+					for(size_t p = 0; p < parts; ++ p) {
+						size_t c = count[p * inner + i];
+						count[p * inner + i] = sum;
+						sum += c;
+					} // for
+					out.ptr_[i] = sum;
+				} // for
+				sparse_scan(out.ptr_, inner);
+				#pragma omp parallel for schedule(static)
+				for(size_t p = 0; p < parts; ++ p) {
+					size_t* cnt = &count[p * inner];
+					size_t begin = sparse_split(ptr, outer, p, parts), end = sparse_split(ptr, outer, p + 1, parts);
+					for(size_t o = begin; o < end; ++ o) {
+						for(size_t k = ptr[o]; k < ptr[o + 1]; ++ k) {
+							size_t i = idx_[k];
+							size_t pos = out.ptr_[i] + cnt[i] ++;
+							out.idx_[pos] = (index_t) o;
+							out.val_[pos] = val_[k];
+						} // for
+					} // for
+				} // for
+			} // transpose_into()
+
+
+			// ////
+			// y = alpha * A * x + beta * y, where y runs along the outer lines. each line is a dot
+			// product, and lines are independent
+			// ////
+			void gather(const value_type* x, ptrdiff_t incx, value_type* y, ptrdiff_t incy,
+						value_type alpha, value_type beta) const {
+				const size_t outer = num_outer_;
+				const size_t* ptr = &ptr_[0];
+				const index_t* idx = idx_.empty() ? NULL : &idx_[0];
+				const value_type* val = val_.empty() ? NULL : &val_[0];
+				#pragma omp parallel
+				{
+					size_t parts, p;
+					sparse_thread(parts, p);
+					size_t begin = sparse_split(ptr, outer, p, parts), end = sparse_split(ptr, outer, p + 1, parts);
+					for(size_t o = begin; o < end; ++ o) {
+						value_type sum0 = value_type(0), sum1 = value_type(0);
+						size_t k = ptr[o], last = ptr[o + 1];
+						if(incx == 1) {
+							for(; k + 1 < last; k += 2) {
+								sum0 += val[k] * x[idx[k]];
+								sum1 += val[k + 1] * x[idx[k + 1]];
+							} // for
+							if(k < last) sum0 += val[k] * x[idx[k]];
+						} else {
+							for(; k < last; ++ k) sum0 += val[k] * x[idx[k] * incx];
+						} // if-else
+						value_type& yo = y[o * incy];
+						if(beta == value_type(0)) yo = alpha * (sum0 + sum1);
+						else yo = alpha * (sum0 + sum1) + beta * yo;
+					} // for
+				}
+			} // gather()
+
+
+			// ////
+			// y = alpha * A^T * x + beta * y, where y runs along the inner lines. each thread
+			// accumulates its lines into a private copy of y, and the copies are summed at the end
+			// ////
+			void scatter(const value_type* x, ptrdiff_t incx, value_type* y, ptrdiff_t incy,
+						value_type alpha, value_type beta) const {
+				const size_t outer = num_outer_, inner = num_inner_;
+				const size_t* ptr = &ptr_[0];
+				const index_t* idx = idx_.empty() ? NULL : &idx_[0];
+				const value_type* val = val_.empty() ? NULL : &val_[0];
+				size_t max_threads = sparse_max_threads();
+				if(max_threads == 1) {
+					for(size_t i = 0; i < inner; ++ i)
+						y[i * incy] = (beta == value_type(0)) ? value_type(0) : beta * y[i * incy];
+					for(size_t o = 0; o < outer; ++ o) {
+						value_type xo = alpha * x[o * incx];
+						for(size_t k = ptr[o]; k < ptr[o + 1]; ++ k) y[idx[k] * incy] += val[k] * xo;
+					} // for
+					return;
+				} // if
+				value_type* partial = new (std::nothrow) value_type[max_threads * inner];
+				if(partial == NULL) {
+					std::cerr << "error: failed to allocate memory for sparse product" << std::endl;
+					return;
+				} // if
+				#pragma omp parallel num_threads(max_threads)
+				{
+					size_t parts, p;
+					sparse_thread(parts, p);
+					value_type* part = partial + p * inner;
+					for(size_t i = 0; i < inner; ++ i) part[i] = value_type(0);
+					size_t begin = sparse_split(ptr, outer, p, parts), end = sparse_split(ptr, outer, p + 1, parts);
+					for(size_t o = begin; o < end; ++ o) {
+						value_type xo = alpha * x[o * incx];
+						for(size_t k = ptr[o]; k < ptr[o + 1]; ++ k) part[idx[k]] += val[k] * xo;
+					} // for
+					#pragma omp barrier
+					#pragma omp for schedule(static)
+					for(size_t i = 0; i < inner; ++ i) {
+						value_type sum = partial[i];
+						for(size_t q = 1; q < parts; ++ q) sum += partial[q * inner + i];
+						value_type& yi = y[i * incy];
+						yi = (beta == value_type(0)) ? sum : sum + beta * yi;
+					} // for
+				}
+				delete[] partial;
+			} // scatter()
+
+
+			// ////
+			// Y = alpha * A * X + beta * Y for dense X and Y with the given strides, Y along the
+			// outer lines. rows of Y are updated with whole rows of X
+			// ////
+			void gather_dense(size_t n, const value_type* x, ptrdiff_t rs_x, ptrdiff_t cs_x,
+								value_type* y, ptrdiff_t rs_y, ptrdiff_t cs_y,
+								value_type alpha, value_type beta) const {
+				const size_t outer = num_outer_;
+				const size_t* ptr = &ptr_[0];
+				const index_t* idx = idx_.empty() ? NULL : &idx_[0];
+				const value_type* val = val_.empty() ? NULL : &val_[0];
+				const bool unit = (cs_x == 1 && cs_y == 1);
+				#pragma omp parallel
+				{
+					size_t parts, p;
+					sparse_thread(parts, p);
+					size_t begin = sparse_split(ptr, outer, p, parts), end = sparse_split(ptr, outer, p + 1, parts);
+					for(size_t o = begin; o < end; ++ o) {
+						value_type* yo = y + o * rs_y;
+						for(size_t c = 0; c < n; ++ c)
+							yo[c * cs_y] = (beta == value_type(0)) ? value_type(0) : beta * yo[c * cs_y];
+						for(size_t k = ptr[o]; k < ptr[o + 1]; ++ k) {
+							value_type a = alpha * val[k];
+							const value_type* xk = x + idx[k] * rs_x;
+							if(unit) for(size_t c = 0; c < n; ++ c) yo[c] += a * xk[c];
+							else for(size_t c = 0; c < n; ++ c) yo[c * cs_y] += a * xk[c * cs_x];
+						} // for
+					} // for
+				}
+			} // gather_dense()
+
+
+			// ////
+			// Y = alpha * A^T * X + beta * Y for dense X and Y, Y along the inner lines. threads
+			// own disjoint blocks of columns of Y. with fewer columns than threads each column
+			// is a separate scatter
+			// ////
+			void scatter_dense(size_t n, const value_type* x, ptrdiff_t rs_x, ptrdiff_t cs_x,
+								value_type* y, ptrdiff_t rs_y, ptrdiff_t cs_y,
+								value_type alpha, value_type beta) const {
+				if(n < sparse_max_threads()) {
+					for(size_t c = 0; c < n; ++ c) scatter(x + c * cs_x, rs_x, y + c * cs_y, rs_y, alpha, beta);
+					return;
+				} // if
+				const size_t outer = num_outer_, inner = num_inner_;
+				const size_t* ptr = &ptr_[0];
+				const index_t* idx = idx_.empty() ? NULL : &idx_[0];
+				const value_type* val = val_.empty() ? NULL : &val_[0];
+				const bool unit = (cs_x == 1 && cs_y == 1);
+				#pragma omp parallel
+				{
+					size_t parts, p;
+					sparse_thread(parts, p);
+					size_t c0 = n * p / parts, c1 = n * (p + 1) / parts;
+					for(size_t i = 0; i < inner; ++ i) {
+						value_type* yi = y + i * rs_y;
+						for(size_t c = c0; c < c1; ++ c)
+							yi[c * cs_y] = (beta == value_type(0)) ? value_type(0) : beta * yi[c * cs_y];
+					} // for
+					for(size_t o = 0; o < outer; ++ o) {
+						const value_type* xo = x + o * rs_x;
+						for(size_t k = ptr[o]; k < ptr[o + 1]; ++ k) {
+							value_type a = alpha * val[k];
+							value_type* yk = y + idx[k] * rs_y;
+							if(unit) for(size_t c = c0; c < c1; ++ c) yk[c] += a * xo[c];
+							else for(size_t c = c0; c < c1; ++ c) yk[c * cs_y] += a * xo[c * cs_x];
+						} // for
+					} // for
+				}
+			} // scatter_dense()
+
+
+			// ////
+			// Y = alpha * A * X + beta * Y with dense X and Y, using gather when the rows of
+			// the product are the outer lines. tiled operands go through a row-major copy
+			// ////
+			template <typename layout_x, typename layout_y>
+			bool multiply_dense(const Matrix2D<value_type, layout_x>& X, Matrix2D<value_type, layout_y>& Y,
+								value_type alpha, value_type beta, bool use_gather) const {
+				size_t m = use_gather ? num_outer_ : num_inner_;
+				size_t k = use_gather ? num_inner_ : num_outer_;
+				size_t n = X.num_cols();
+				if(X.num_rows() != k) {
+					std::cerr << "error: inner dimensions of matrices to multiply do not match" << std::endl;
+					return false;
+				} // if
+				if(Y.num_rows() != m || Y.num_cols() != n) {
+					if(beta != value_type(0)) {
+						std::cerr << "error: dimensions of the product do not match the result matrix" << std::endl;
+						return false;
+					} // if
+					Y.resize(m, n);
+				} // if
+				if(m == 0 || n == 0) return true;
+				ptrdiff_t rs_x, cs_x, rs_y, cs_y;
+				if(!gemm_operand(X, false, rs_x, cs_x)) {
+					Matrix2D<value_type, RowMajor> temp(X.num_rows(), X.num_cols());
+					for(size_t i = 0; i < X.num_rows(); ++ i)
+						for(size_t j = 0; j < X.num_cols(); ++ j) temp(i, j) = X(i, j);
+					return multiply_dense(temp, Y, alpha, beta, use_gather);
+				} // if
+				const value_type* x = (k > 0) ? &X[0] : NULL;
+				value_type* y = Y.kernel_data();
+				if(!gemm_operand(Y, false, rs_y, cs_y) || y == x) {
+					// tiled or aliased result: compute into a separate row-major matrix
+					Matrix2D<value_type, RowMajor> temp(m, n);
+					if(beta != value_type(0)) {
+						for(size_t i = 0; i < m; ++ i)
+							for(size_t j = 0; j < n; ++ j) temp(i, j) = Y(i, j);
+					} // if
+					if(use_gather) gather_dense(n, x, rs_x, cs_x, temp.kernel_data(), (ptrdiff_t) n, 1, alpha, beta);
+					else scatter_dense(n, x, rs_x, cs_x, temp.kernel_data(), (ptrdiff_t) n, 1, alpha, beta);
+					for(size_t i = 0; i < m; ++ i)
+						for(size_t j = 0; j < n; ++ j) Y(i, j) = temp(i, j);
+					return true;
+				} // if
+				if(use_gather) gather_dense(n, x, rs_x, cs_x, y, rs_y, cs_y, alpha, beta);
+				else scatter_dense(n, x, rs_x, cs_x, y, rs_y, cs_y, alpha, beta);
+				return true;
+			} // multiply_dense()
+
+
+			// ////
+			// y = alpha * A * x + beta * y for std::vector operands, y is resized if needed
+			// ////
+			bool multiply_vector(const std::vector<value_type>& x, std::vector<value_type>& y,
+									value_type alpha, value_type beta, bool use_gather) const {
+				size_t m = use_gather ? num_outer_ : num_inner_;
+				size_t k = use_gather ? num_inner_ : num_outer_;
+				if(x.size() != k) {
+					std::cerr << "error: vector size does not match the sparse matrix" << std::endl;
+					return false;
+				} // if
+				if(y.size() != m) {
+					if(beta != value_type(0)) {
+						std::cerr << "error: result vector size does not match the sparse matrix" << std::endl;
+						return false;
+					} // if
+					y.resize(m);
+				} // if
+				if(m == 0) return true;
+				const value_type* xp = (k > 0) ? &x[0] : NULL;
+				if(use_gather) gather(xp, 1, &y[0], 1, alpha, beta);
+				else scatter(xp, 1, &y[0], 1, alpha, beta);
+				return true;
+			} // multiply_vector()
+
+
+		public:
+			typedef SparseLineIterator<value_type, index_t> line_iterator;
+
+			// ////
+			// take over compressed arrays: ptr with outer + 1 line starts, and idx and val with
+			// ptr[outer] entries each, inner indices sorted within each line. the vectors are
+			// swapped in, leaving the previous contents of this matrix in them
+			// ////
+			bool assign(size_t outer, size_t inner, std::vector<size_t>& ptr,
+						std::vector<index_t>& idx, std::vector<value_type>& val) {
+				if(ptr.size() != outer + 1 || ptr[0] != 0 || idx.size() != ptr[outer] || val.size() != ptr[outer]) {
+					std::cerr << "error: inconsistent compressed sparse arrays" << std::endl;
+					return false;
+				} // if
+				num_outer_ = outer;
+				num_inner_ = inner;
+				ptr_.swap(ptr);
+				idx_.swap(idx);
+				val_.swap(val);
+				return true;
+			} // assign()
+
+			// ////
+			// exchange contents with another matrix
+			// ////
+			void swap(CompressedMatrix& mat) {
+				std::swap(num_outer_, mat.num_outer_);
+				std::swap(num_inner_, mat.num_inner_);
+				ptr_.swap(mat.ptr_);
+				idx_.swap(mat.idx_);
+				val_.swap(mat.val_);
+			} // swap()
+
+			// remove all stored elements, keeping the dimensions
+			void clear() { reset(num_outer_, num_inner_); }
+
+			size_t nnz() const { return ptr_[num_outer_]; }
+			double density() const {
+				return (num_outer_ * num_inner_ > 0) ? (double) nnz() / ((double) num_outer_ * num_inner_) : 0.0;
+			} // density()
+			// bytes used by the compressed arrays
+			size_t memory_size() const {
+				return ptr_.size() * sizeof(size_t) + idx_.size() * sizeof(index_t) + val_.size() * sizeof(value_type);
+			} // memory_size()
+
+			const size_t* outer_starts() const { return &ptr_[0]; }
+			const index_t* inner_indices() const { return idx_.empty() ? NULL : &idx_[0]; }
+			value_type* values() { return val_.empty() ? NULL : &val_[0]; }
+			const value_type* values() const { return val_.empty() ? NULL : &val_[0]; }
+
+	}; // class CompressedMatrix
+
+
+	/* compressed sparse row matrix */
+	template <typename value_type, typename index_t>
+	class CSRMatrix : public CompressedMatrix<value_type, index_t> {
+		private:
+			typedef CompressedMatrix<value_type, index_t> base_t;
+
+		public:
+			typedef typename base_t::line_iterator row_iterator;
+
+			CSRMatrix(): base_t(0, 0) { }
+			CSRMatrix(size_t rows, size_t cols): base_t(rows, cols) { }
+
+			// ////
+			// constructor: store the elements of mat whose magnitude is above threshold
+			// ////
+			template <typename layout_t>
+			CSRMatrix(const Matrix2D<value_type, layout_t>& mat, double threshold = 0.0): base_t(0, 0) {
+				this->compress(mat, threshold, true);
+			} // CSRMatrix()
+
+			template <typename layout_t>
+			bool from_dense(const Matrix2D<value_type, layout_t>& mat, double threshold = 0.0) {
+				return this->compress(mat, threshold, true);
+			} // from_dense()
+
+			// ////
+			// write into a dense matrix, which is resized if needed
+			// ////
+			template <typename layout_t>
+			bool to_dense(Matrix2D<value_type, layout_t>& mat) const {
+				return this->expand(mat, true);
+			} // to_dense()
+
+			// ////
+			// the same matrix in compressed sparse column form
+			// ////
+			void to_csc(CSCMatrix<value_type, index_t>& mat) const {
+				this->transpose_into(mat);
+			} // to_csc()
+
+			// ////
+			// store the transpose of this matrix in mat
+			// ////
+			void transpose(CSRMatrix& mat) const {
+				this->transpose_into(mat);
+			} // transpose()
+
+			size_t num_rows() const { return this->num_outer_; }
+			size_t num_cols() const { return this->num_inner_; }
+
+			// element (i, j), zero when it is not stored
+			value_type operator()(size_t i, size_t j) const { return this->find(i, j); }
+
+			// ////
+			// y = alpha * A * x + beta * y. x has num_cols() and y num_rows() elements
+			// ////
+			bool multiply(const value_type* x, value_type* y,
+							value_type alpha = value_type(1), value_type beta = value_type(0)) const {
+				if(this->num_outer_ > 0) this->gather(x, 1, y, 1, alpha, beta);
+				return true;
+			} // multiply()
+
+			bool multiply(const std::vector<value_type>& x, std::vector<value_type>& y,
+							value_type alpha = value_type(1), value_type beta = value_type(0)) const {
+				return this->multiply_vector(x, y, alpha, beta, true);
+			} // multiply()
+
+			// ////
+			// Y = alpha * A * X + beta * Y for dense X and Y
+			// ////
+			template <typename layout_x, typename layout_y>
+			bool multiply(const Matrix2D<value_type, layout_x>& X, Matrix2D<value_type, layout_y>& Y,
+							value_type alpha = value_type(1), value_type beta = value_type(0)) const {
+				return this->multiply_dense(X, Y, alpha, beta, true);
+			} // multiply()
+
+			// ////
+			// y = alpha * A^T * x + beta * y. x has num_rows() and y num_cols() elements
+			// ////
+			bool multiply_transpose(const value_type* x, value_type* y,
+									value_type alpha = value_type(1), value_type beta = value_type(0)) const {
+				if(this->num_inner_ > 0) this->scatter(x, 1, y, 1, alpha, beta);
+				return true;
+			} // multiply_transpose()
+
+			bool multiply_transpose(const std::vector<value_type>& x, std::vector<value_type>& y,
+									value_type alpha = value_type(1), value_type beta = value_type(0)) const {
+				return this->multiply_vector(x, y, alpha, beta, false);
+			} // multiply_transpose()
+
+			template <typename layout_x, typename layout_y>
+			bool multiply_transpose(const Matrix2D<value_type, layout_x>& X, Matrix2D<value_type, layout_y>& Y,
+									value_type alpha = value_type(1), value_type beta = value_type(0)) const {
+				return this->multiply_dense(X, Y, alpha, beta, false);
+			} // multiply_transpose()
+
+			// ////
+			// iterators over the rows
+			// ////
+			row_iterator row(size_t i) {
+				if(i >= this->num_outer_ && this->num_outer_ > 0) i = this->num_outer_ - 1;
+				return row_iterator(i, this);
+			} // row()
+
+			row_iterator begin_row() { return row_iterator(0, this); }
+			row_iterator end_row() { return row_iterator(this->num_outer_, this); }
+
+	}; // class CSRMatrix
+
+
+	/* compressed sparse column matrix */
+	template <typename value_type, typename index_t>
+	class CSCMatrix : public CompressedMatrix<value_type, index_t> {
+		private:
+			typedef CompressedMatrix<value_type, index_t> base_t;
+
+		public:
+			typedef typename base_t::line_iterator col_iterator;
+
+			CSCMatrix(): base_t(0, 0) { }
+			CSCMatrix(size_t rows, size_t cols): base_t(cols, rows) { }
+
+			// ////
+			// constructor: store the elements of mat whose magnitude is above threshold
+			// ////
+			template <typename layout_t>
+			CSCMatrix(const Matrix2D<value_type, layout_t>& mat, double threshold = 0.0): base_t(0, 0) {
+				this->compress(mat, threshold, false);
+			} // CSCMatrix()
+
+			template <typename layout_t>
+			bool from_dense(const Matrix2D<value_type, layout_t>& mat, double threshold = 0.0) {
+				return this->compress(mat, threshold, false);
+			} // from_dense()
+
+			// ////
+			// write into a dense matrix, which is resized if needed
+			// ////
+			template <typename layout_t>
+			bool to_dense(Matrix2D<value_type, layout_t>& mat) const {
+				return this->expand(mat, false);
+			} // to_dense()
+
+			// ////
+			// the same matrix in compressed sparse row form
+			// ////
+			void to_csr(CSRMatrix<value_type, index_t>& mat) const {
+				this->transpose_into(mat);
+			} // to_csr()
+
+			// ////
+			// store the transpose of this matrix in mat
+			// ////
+			void transpose(CSCMatrix& mat) const {
+				this->transpose_into(mat);
+			} // transpose()
+
+			size_t num_rows() const { return this->num_inner_; }
+			size_t num_cols() const { return this->num_outer_; }
+
+			// element (i, j), zero when it is not stored
+			value_type operator()(size_t i, size_t j) const { return this->find(j, i); }
+
+			// ////
+			// y = alpha * A * x + beta * y. x has num_cols() and y num_rows() elements
+			// ////
+			bool multiply(const value_type* x, value_type* y,
+							value_type alpha = value_type(1), value_type beta = value_type(0)) const {
+				if(this->num_inner_ > 0) this->scatter(x, 1, y, 1, alpha, beta);
+				return true;
+			} // multiply()
+
+			bool multiply(const std::vector<value_type>& x, std::vector<value_type>& y,
+							value_type alpha = value_type(1), value_type beta = value_type(0)) const {
+				return this->multiply_vector(x, y, alpha, beta, false);
+			} // multiply()
+
+			// ////
+			// Y = alpha * A * X + beta * Y for dense X and Y
+			// ////
+			template <typename layout_x, typename layout_y>
+			bool multiply(const Matrix2D<value_type, layout_x>& X, Matrix2D<value_type, layout_y>& Y,
+							value_type alpha = value_type(1), value_type beta = value_type(0)) const {
+				return this->multiply_dense(X, Y, alpha, beta, false);
+			} // multiply()
+
+			// ////
+			// y = alpha * A^T * x + beta * y. x has num_rows() and y num_cols() elements
+			// ////
+			bool multiply_transpose(const value_type* x, value_type* y,
+									value_type alpha = value_type(1), value_type beta = value_type(0)) const {
+				if(this->num_outer_ > 0) this->gather(x, 1, y, 1, alpha, beta);
+				return true;
+			} // multiply_transpose()
+
+			bool multiply_transpose(const std::vector<value_type>& x, std::vector<value_type>& y,
+									value_type alpha = value_type(1), value_type beta = value_type(0)) const {
+				return this->multiply_vector(x, y, alpha, beta, true);
+			} // multiply_transpose()
+
+			template <typename layout_x, typename layout_y>
+			bool multiply_transpose(const Matrix2D<value_type, layout_x>& X, Matrix2D<value_type, layout_y>& Y,
+									value_type alpha = value_type(1), value_type beta = value_type(0)) const {
+				return this->multiply_dense(X, Y, alpha, beta, true);
+			} // multiply_transpose()
+
+			// ////
+			// iterators over the columns
+			// ////
+			col_iterator column(size_t j) {
+				if(j >= this->num_outer_ && this->num_outer_ > 0) j = this->num_outer_ - 1;
+				return col_iterator(j, this);
+			} // column()
+
+			col_iterator begin_col() { return col_iterator(0, this); }
+			col_iterator end_col() { return col_iterator(this->num_outer_, this); }
+
+	}; // class CSCMatrix
+
+
+	/* coordinate (triplet) list for assembling a sparse matrix. elements may be added in any
+	 * order and the same position may be added several times; duplicates are summed when the
+	 * compressed matrix is built. builders filled by separate threads can be joined with append() */
+	template <typename value_type, typename index_t>
+	class SparseBuilder {
+		private:
+			size_t num_rows_, num_cols_;
+			std::vector<index_t> rows_;			// row of each element
+			std::vector<index_t> cols_;			// column of each element
+			std::vector<value_type> vals_;		// elements
+
+			// ////
+			// bucket the elements by outer line, keeping their order, then sort each line by
+			// inner index and sum duplicates. lines are split among threads by work
+			// ////
+			void assemble(const std::vector<index_t>& outer_of, const std::vector<index_t>& inner_of,
+							size_t outer, size_t inner, CompressedMatrix<value_type, index_t>& out) const {
+				typedef std::pair<index_t, value_type> entry_t;
+				const size_t num = vals_.size();
+				out.reset(outer, inner);
+				if(num == 0) return;
+
+				// count and place the elements of each contiguous chunk separately, as in transpose
+				size_t parts = std::min(sparse_max_threads(), 1 + num / (outer + 1));
+				std::vector<size_t> count(parts * outer, 0);
+				#pragma omp parallel for schedule(static)
+				for(size_t p = 0; p < parts; ++ p) {
+					size_t* cnt = &count[p * outer];
+					for(size_t k = num * p / parts; k < num * (p + 1) / parts; ++ k) ++ cnt[outer_of[k]];
+				} // for
+				std::vector<size_t> start(outer + 1, 0);
+				#pragma omp parallel for schedule(static)
+				for(size_t o = 0; o < outer; ++ o) {
+					size_t sum = 0;
+					for(size_t p = 0; p < parts; ++ p) {
+						size_t c = count[p * outer + o];
+						count[p * outer + o] = sum;
+						sum += c;
+					} // for
+					start[o] = sum;
+				} // for
+				sparse_scan(start, outer);
+				std::vector<entry_t> entries(num);
+				#pragma omp parallel for schedule(static)
+				for(size_t p = 0; p < parts; ++ p) {
+					size_t* cnt = &count[p * outer];
+					for(size_t k = num * p / parts; k < num * (p + 1) / parts; ++ k) {
+						size_t o = outer_of[k];
+						entries[start[o] + cnt[o] ++] = entry_t(inner_of[k], vals_[k]);
+					} // for
+				} // for
+
+				// sort each line and merge its duplicates in place
+				const size_t* sp = &start[0];
+				#pragma omp parallel
+				{
+					size_t nthreads, t;
+					sparse_thread(nthreads, t);
+					size_t begin = sparse_split(sp, outer, t, nthreads), end = sparse_split(sp, outer, t + 1, nthreads);
+					for(size_t o = begin; o < end; ++ o) {
+						entry_t* first = &entries[0] + sp[o];
+						entry_t* last = &entries[0] + sp[o + 1];
+						if(first == last) {
+							out.ptr_[o] = 0;
+							continue;
+						} // if
+						bool sorted = true;
+						for(entry_t* e = first + 1; e < last && sorted; ++ e) sorted = !(e->first < (e - 1)->first);
+						if(!sorted) std::stable_sort(first, last, SparseEntryLess<value_type, index_t>());
+						entry_t* dst = first;
+						for(entry_t* e = first + 1; e < last; ++ e) {
+							if(e->first == dst->first) dst->second += e->second;
+							else *(++ dst) = *e;
+						} // for
+						out.ptr_[o] = dst - first + 1;
+					} // for
+				}
+				sparse_scan(out.ptr_, outer);
+				out.idx_.resize(out.ptr_[outer]);
+				out.val_.resize(out.ptr_[outer]);
+				const size_t* op = &out.ptr_[0];
+				#pragma omp parallel
+				{
+					size_t nthreads, t;
+					sparse_thread(nthreads, t);
+					size_t begin = sparse_split(op, outer, t, nthreads), end = sparse_split(op, outer, t + 1, nthreads);
+					for(size_t o = begin; o < end; ++ o) {
+						const entry_t* src = &entries[0] + sp[o];
+						for(size_t k = op[o]; k < op[o + 1]; ++ k, ++ src) {
+							out.idx_[k] = src->first;
+							out.val_[k] = src->second;
+						} // for
+					} // for
+				}
+			} // assemble()
+
+		public:
+			SparseBuilder(size_t rows, size_t cols): num_rows_(rows), num_cols_(cols) { }
+
+			void reserve(size_t num) {
+				rows_.reserve(num);
+				cols_.reserve(num);
+				vals_.reserve(num);
+			} // reserve()
+
+			// ////
+			// add val at (i, j)
+			// ////
+			bool add(size_t i, size_t j, value_type val) {
+				if(i >= num_rows_ || j >= num_cols_) {
+					std::cerr << "error: sparse element (" << i << ", " << j << ") is outside the matrix" << std::endl;
+					return false;
+				} // if
+				rows_.push_back((index_t) i);
+				cols_.push_back((index_t) j);
+				vals_.push_back(val);
+				return true;
+			} // add()
+
+			// ////
+			// add all elements of another builder of the same dimensions
+			// ////
+			bool append(const SparseBuilder& other) {
+				if(other.num_rows_ != num_rows_ || other.num_cols_ != num_cols_) {
+					std::cerr << "error: mismatching dimensions of sparse builders" << std::endl;
+					return false;
+				} // if
+				rows_.insert(rows_.end(), other.rows_.begin(), other.rows_.end());
+				cols_.insert(cols_.end(), other.cols_.begin(), other.cols_.end());
+				vals_.insert(vals_.end(), other.vals_.begin(), other.vals_.end());
+				return true;
+			} // append()
+
+			void clear() {
+				rows_.clear();
+				cols_.clear();
+				vals_.clear();
+			} // clear()
+
+			size_t size() const { return vals_.size(); }
+			size_t num_rows() const { return num_rows_; }
+			size_t num_cols() const { return num_cols_; }
+
+			// ////
+			// build the compressed matrix, summing duplicate elements
+			// ////
+			bool build(CSRMatrix<value_type, index_t>& mat) const {
+				assemble(rows_, cols_, num_rows_, num_cols_, mat);
+				return true;
+			} // build()
+
+			bool build(CSCMatrix<value_type, index_t>& mat) const {
+				assemble(cols_, rows_, num_cols_, num_rows_, mat);
+				return true;
+			} // build()
+
+	}; // class SparseBuilder
+
+
+	// ////
+	// Y = alpha * op(A) * X + beta * Y for a sparse A and dense X and Y, where op(A) is A, or
+	// A^T when transpose_a is set. with beta == 0, Y is resized as needed
+	// ////
+	template <typename value_type, typename index_t, typename layout_x, typename layout_y,
+				typename alpha_t, typename beta_t>
+	bool matrix_multiply(const CSRMatrix<value_type, index_t>& A, const Matrix2D<value_type, layout_x>& X,
+							Matrix2D<value_type, layout_y>& Y, alpha_t alpha, beta_t beta,
+							bool transpose_a = false) {
+		if(transpose_a) return A.multiply_transpose(X, Y, value_type(alpha), value_type(beta));
+		return A.multiply(X, Y, value_type(alpha), value_type(beta));
+	} // matrix_multiply()
+
+	template <typename value_type, typename index_t, typename layout_x, typename layout_y,
+				typename alpha_t, typename beta_t>
+	bool matrix_multiply(const CSCMatrix<value_type, index_t>& A, const Matrix2D<value_type, layout_x>& X,
+							Matrix2D<value_type, layout_y>& Y, alpha_t alpha, beta_t beta,
+							bool transpose_a = false) {
+		if(transpose_a) return A.multiply_transpose(X, Y, value_type(alpha), value_type(beta));
+		return A.multiply(X, Y, value_type(alpha), value_type(beta));
+	} // matrix_multiply()
+
+	// ////
+	// Y = A * X
+	// ////
+	template <typename value_type, typename index_t, typename layout_x, typename layout_y>
+	bool matrix_multiply(const CSRMatrix<value_type, index_t>& A, const Matrix2D<value_type, layout_x>& X,
+							Matrix2D<value_type, layout_y>& Y) {
+		return A.multiply(X, Y);
+	} // matrix_multiply()
+
+	template <typename value_type, typename index_t, typename layout_x, typename layout_y>
+	bool matrix_multiply(const CSCMatrix<value_type, index_t>& A, const Matrix2D<value_type, layout_x>& X,
+							Matrix2D<value_type, layout_y>& Y) {
+		return A.multiply(X, Y);
+	} // matrix_multiply()
+
+} // namespace stock
+
+#endif // __SPARSE_HPP__
@@ -0,0 +1,332 @@
+/**
+ *  Project: The Stock Libraries
+ *
+ *  File: stencil.hpp
+ *  Created: Oct 18, 2026
+ *
+ *  Author: Abhinav Sarje <abhinav.sarje@gmail.com>
+ *
+ *  Copyright (c) 2012-2017 Abhinav Sarje
+ *  Distributed under the Boost Software License.
+ *  See accompanying LICENSE file.
+ */
+
+#ifndef __STENCIL_HPP__
+#define __STENCIL_HPP__
+
+#include <vector>
+#include <cstring>
+#include <algorithm>
+#ifdef __SSE2__
+#include <immintrin.h>
+#endif
+
+namespace stock {
+
+	/* 2D stencils (filters) over Matrix2D: out(i, j) = sum over (a, b) of
+	 * kernel(a, b) * in(i + a - center_row, j + b - center_col), with the center at
+	 * (rows / 2, cols / 2) of the kernel. the kernel is applied as given (correlation),
+	 * a convolution takes the kernel flipped in both dimensions.
+	 * the matrix is processed in tiles, in parallel. each tile is first gathered with its halo
+	 * into a contiguous buffer, where elements outside the matrix are already resolved by the
+	 * boundary mode, so that the inner loops are branch-free row updates */
+
+	enum StencilBoundary {
+		boundary_clamp,		/* outside elements repeat the nearest edge element */
+		boundary_wrap,		/* the matrix is periodic */
+		boundary_zero		/* outside elements are zero */
+	};
+
+	const size_t STENCIL_TILE_ROWS_ = 64;		// output rows per tile
+	const size_t STENCIL_TILE_COLS_ = 256;		// output columns per tile
+
+
+	// ////
+	// y[k] += w * x[k] for n elements, the inner loop of all stencils
+	// ////
+	template <typename value_type>
+	inline void stencil_axpy(value_type* y, const value_type* x, value_type w, size_t n) {
+		for(size_t k = 0; k < n; ++ k) y[k] += w * x[k];
+	} // stencil_axpy()
+
+#if defined(__AVX512F__)
+	inline void stencil_axpy(float* y, const float* x, float w, size_t n) {
+		__m512 vw = _mm512_set1_ps(w);
+		size_t k = 0;
+		for(; k + 16 <= n; k += 16)
+			_mm512_storeu_ps(y + k, _mm512_fmadd_ps(vw, _mm512_loadu_ps(x + k), _mm512_loadu_ps(y + k)));
+		for(; k < n; ++ k) y[k] += w * x[k];
+	} // stencil_axpy()
+
+	inline void stencil_axpy(double* y, const double* x, double w, size_t n) {
+		__m512d vw = _mm512_set1_pd(w);
+		size_t k = 0;
+		for(; k + 8 <= n; k += 8)
+			_mm512_storeu_pd(y + k, _mm512_fmadd_pd(vw, _mm512_loadu_pd(x + k), _mm512_loadu_pd(y + k)));
+		for(; k < n; ++ k) y[k] += w * x[k];
+	} // stencil_axpy()
+
+#elif defined(__AVX__)
+	inline void stencil_axpy(float* y, const float* x, float w, size_t n) {
+		__m256 vw = _mm256_set1_ps(w);
+		size_t k = 0;
+		for(; k + 8 <= n; k += 8) {
+		#ifdef __FMA__
+			__m256 v = _mm256_fmadd_ps(vw, _mm256_loadu_ps(x + k), _mm256_loadu_ps(y + k));
+		#else
+			__m256 v = _mm256_add_ps(_mm256_mul_ps(vw, _mm256_loadu_ps(x + k)), _mm256_loadu_ps(y + k));
+		#endif
+			_mm256_storeu_ps(y + k, v);
+		} // for
+		for(; k < n; ++ k) y[k] += w * x[k];
+	} // stencil_axpy()
+
+	inline void stencil_axpy(double* y, const double* x, double w, size_t n) {
+		__m256d vw = _mm256_set1_pd(w);
+		size_t k = 0;
+		for(; k + 4 <= n; k += 4) {
+		#ifdef __FMA__
+			__m256d v = _mm256_fmadd_pd(vw, _mm256_loadu_pd(x + k), _mm256_loadu_pd(y + k));
+		#else
+			__m256d v = _mm256_add_pd(_mm256_mul_pd(vw, _mm256_loadu_pd(x + k)), _mm256_loadu_pd(y + k));
+		#endif
+			_mm256_storeu_pd(y + k, v);
+		} // for
+		for(; k < n; ++ k) y[k] += w * x[k];
+	} // stencil_axpy()
+
+#elif defined(__SSE2__)
+	inline void stencil_axpy(float* y, const float* x, float w, size_t n) {
+		__m128 vw = _mm_set1_ps(w);
+		size_t k = 0;
+		for(; k + 4 <= n; k += 4)
+			_mm_storeu_ps(y + k, _mm_add_ps(_mm_mul_ps(vw, _mm_loadu_ps(x + k)), _mm_loadu_ps(y + k)));
+		for(; k < n; ++ k) y[k] += w * x[k];
+	} // stencil_axpy()
+
+	inline void stencil_axpy(double* y, const double* x, double w, size_t n) {
+		__m128d vw = _mm_set1_pd(w);
+		size_t k = 0;
+		for(; k + 2 <= n; k += 2)
+			_mm_storeu_pd(y + k, _mm_add_pd(_mm_mul_pd(vw, _mm_loadu_pd(x + k)), _mm_loadu_pd(y + k)));
+		for(; k < n; ++ k) y[k] += w * x[k];
+	} // stencil_axpy()
+#endif
+
+
+	// ////
+	// index k along a dimension of size n, resolved by the boundary mode.
+	// false when the element is outside and zero
+	// ////
+	inline bool stencil_index(long k, long n, StencilBoundary boundary, long& idx) {
+		if(k >= 0 && k < n) { idx = k; return true; }
+		switch(boundary) {
+			case boundary_clamp: idx = (k < 0) ? 0 : n - 1; return true;
+			case boundary_wrap: idx = ((k % n) + n) % n; return true;
+			default: return false;
+		} // switch
+	} // stencil_index()
+
+
+	// ////
+	// gather the rows x cols region of in starting at (i0, j0), which may extend outside
+	// the matrix, into the row-major buffer pad. in has leading dimension ld
+	// ////
+	template <typename value_type, typename layout_t>
+	void stencil_gather(const value_type* in, long nrows, long ncols, size_t ld, long i0, long j0,
+						size_t rows, size_t cols, StencilBoundary boundary, value_type* pad) {
+		long c_begin = std::max(0L, - j0), c_end = std::min((long) cols, ncols - j0);	// inside columns
+		for(size_t r = 0; r < rows; ++ r) {
+			value_type* dst = pad + r * cols;
+			long si = 0;
+			if(!stencil_index(i0 + (long) r, nrows, boundary, si)) {
+				std::fill(dst, dst + cols, value_type(0));
+				continue;
+			} // if
+			if(layout_t::kind == layout_row_major) {
+				memcpy(dst + c_begin, in + layout_t::index(si, j0 + c_begin, nrows, ncols, ld),
+						(c_end - c_begin) * sizeof(value_type));
+			} else {
+				for(long c = c_begin; c < c_end; ++ c) dst[c] = in[layout_t::index(si, j0 + c, nrows, ncols, ld)];
+			} // if-else
+			for(long c = 0; c < (long) cols; ++ c) {
+				if(c == c_begin) c = c_end;
+				if(c >= (long) cols) break;
+				long sj = 0;
+				dst[c] = stencil_index(j0 + c, ncols, boundary, sj) ?
+							in[layout_t::index(si, sj, nrows, ncols, ld)] : value_type(0);
+			} // for
+		} // for
+	} // stencil_gather()
+
+
+	/* tile operation of a general kernel */
+	template <typename value_type>
+	struct StencilGeneral {
+		size_t rows_, cols_;					// kernel size
+		size_t center_row_, center_col_;
+		std::vector<value_type> weights_;		// row-major
+
+		size_t scratch_size(size_t, size_t) const { return 0; }
+
+		// ////
+		// acc (tile_rows x tile_cols) = kernel applied to pad (tile_rows + rows_ - 1 rows of pad_cols)
+		// ////
+		void apply(const value_type* pad, size_t pad_cols, size_t tile_rows, size_t tile_cols,
+					value_type* acc, value_type*) const {
+			for(size_t r = 0; r < tile_rows; ++ r) {
+				value_type* acc_row = acc + r * tile_cols;
+				std::fill(acc_row, acc_row + tile_cols, value_type(0));
+				for(size_t a = 0; a < rows_; ++ a) {
+					const value_type* pad_row = pad + (r + a) * pad_cols;
+					for(size_t b = 0; b < cols_; ++ b) {
+						value_type w = weights_[a * cols_ + b];
+						if(w == value_type(0)) continue;
+						stencil_axpy(acc_row, pad_row + b, w, tile_cols);
+					} // for
+				} // for
+			} // for
+		} // apply()
+	}; // struct StencilGeneral
+
+
+	/* tile operation of a separable kernel, col_weights x row_weights:
+	 * a pass along the rows into scratch, then a pass along the columns */
+	template <typename value_type>
+	struct StencilSeparable {
+		size_t rows_, cols_;
+		size_t center_row_, center_col_;
+		std::vector<value_type> row_weights_;		// cols_ weights applied along each row
+		std::vector<value_type> col_weights_;		// rows_ weights applied along each column
+
+		size_t scratch_size(size_t tile_rows, size_t tile_cols) const {
+			return (tile_rows + rows_ - 1) * tile_cols;
+		} // scratch_size()
+
+		void apply(const value_type* pad, size_t pad_cols, size_t tile_rows, size_t tile_cols,
+					value_type* acc, value_type* scratch) const {
+			size_t pad_rows = tile_rows + rows_ - 1;
+			for(size_t r = 0; r < pad_rows; ++ r) {
+				value_type* tmp_row = scratch + r * tile_cols;
+				std::fill(tmp_row, tmp_row + tile_cols, value_type(0));
+				for(size_t b = 0; b < cols_; ++ b)
+					stencil_axpy(tmp_row, pad + r * pad_cols + b, row_weights_[b], tile_cols);
+			} // for
+			for(size_t r = 0; r < tile_rows; ++ r) {
+				value_type* acc_row = acc + r * tile_cols;
+				std::fill(acc_row, acc_row + tile_cols, value_type(0));
+				for(size_t a = 0; a < rows_; ++ a)
+					stencil_axpy(acc_row, scratch + (r + a) * tile_cols, col_weights_[a], tile_cols);
+			} // for
+		} // apply()
+	}; // struct StencilSeparable
+
+
+	// ////
+	// apply a tile operation over the whole matrix, in parallel over tiles. in and out
+	// have leading dimensions ld_in and ld_out
+	// ////
+	template <typename value_type, typename layout_t, typename op_t>
+	void stencil_tiles(const value_type* in, size_t ld_in, value_type* out, size_t ld_out,
+						size_t nrows, size_t ncols, const op_t& op, StencilBoundary boundary) {
+		const size_t TR = STENCIL_TILE_ROWS_, TC = STENCIL_TILE_COLS_;
+		size_t tiles_r = (nrows + TR - 1) / TR, tiles_c = (ncols + TC - 1) / TC;
+		size_t num_tiles = tiles_r * tiles_c;
+		size_t pad_cols = TC + op.cols_ - 1;
+		#pragma omp parallel
+		{
+			std::vector<value_type> pad((TR + op.rows_ - 1) * pad_cols), acc(TR * TC);
+			std::vector<value_type> scratch(op.scratch_size(TR, TC) + 1);
+			#pragma omp for schedule(static)
+			for(size_t t = 0; t < num_tiles; ++ t) {
+				size_t i0 = (t / tiles_c) * TR, j0 = (t % tiles_c) * TC;
+				size_t rows = std::min(TR, nrows - i0), cols = std::min(TC, ncols - j0);
+				size_t tile_pad_cols = cols + op.cols_ - 1;
+				stencil_gather<value_type, layout_t>(in, nrows, ncols, ld_in, (long) i0 - (long) op.center_row_,
+														(long) j0 - (long) op.center_col_,
+														rows + op.rows_ - 1, tile_pad_cols, boundary, &pad[0]);
+				op.apply(&pad[0], tile_pad_cols, rows, cols, &acc[0], &scratch[0]);
+				for(size_t r = 0; r < rows; ++ r) {
+					const value_type* acc_row = &acc[r * cols];
+					if(layout_t::kind == layout_row_major) {
+						memcpy(out + layout_t::index(i0 + r, j0, nrows, ncols, ld_out), acc_row, cols * sizeof(value_type));
+					} else {
+						for(size_t c = 0; c < cols; ++ c)
+							out[layout_t::index(i0 + r, j0 + c, nrows, ncols, ld_out)] = acc_row[c];
+					} // if-else
+				} // for
+			} // for
+		}
+	} // stencil_tiles()
+
+
+	// ////
+	// run a tile operation from in to out. out is resized when its dimensions differ,
+	// and may be in itself
+	// ////
+	template <typename value_type, typename layout_t, typename op_t>
+	bool stencil_run(const Matrix2D<value_type, layout_t>& in, Matrix2D<value_type, layout_t>& out,
+						const op_t& op, StencilBoundary boundary) {
+		size_t nrows = in.num_rows(), ncols = in.num_cols();
+		if(op.rows_ == 0 || op.cols_ == 0) {
+			std::cerr << "error: empty stencil kernel" << std::endl;
+			return false;
+		} // if
+		if(nrows == 0 || ncols == 0) return true;
+		if(&in == &out) {
+			Matrix2D<value_type, layout_t> temp(nrows, ncols);
+			temp.set_leading_dim(out.leading_dim());
+			stencil_tiles<value_type, layout_t>(in.data(), in.leading_dim(), temp.kernel_data(), temp.leading_dim(),
+													nrows, ncols, op, boundary);
+			bulk_copy(out.kernel_data(), temp.kernel_data(), out.storage_size() * sizeof(value_type));
+			return true;
+		} // if
+		if(out.num_rows() != nrows || out.num_cols() != ncols) out.resize(nrows, ncols);
+		stencil_tiles<value_type, layout_t>(in.data(), in.leading_dim(), out.kernel_data(), out.leading_dim(),
+												nrows, ncols, op, boundary);
+		return true;
+	} // stencil_run()
+
+
+	// ////
+	// apply a general kernel, given as a matrix of weights of any layout
+	// ////
+	template <typename value_type, typename layout_t, typename kernel_layout_t>
+	bool matrix_stencil(const Matrix2D<value_type, layout_t>& in,
+						const Matrix2D<value_type, kernel_layout_t>& kernel,
+						Matrix2D<value_type, layout_t>& out, StencilBoundary boundary = boundary_clamp) {
+		StencilGeneral<value_type> op;
+		op.rows_ = kernel.num_rows();
+		op.cols_ = kernel.num_cols();
+		op.center_row_ = op.rows_ / 2;
+		op.center_col_ = op.cols_ / 2;
+		op.weights_.resize(op.rows_ * op.cols_);
+		for(size_t a = 0; a < op.rows_; ++ a)
+			for(size_t b = 0; b < op.cols_; ++ b) op.weights_[a * op.cols_ + b] = kernel(a, b);
+		return stencil_run(in, out, op, boundary);
+	} // matrix_stencil()
+
+	// ////
+	// apply a separable kernel, kernel(a, b) = col_weights[a] * row_weights[b]:
+	// row_weights are applied along each row, then col_weights along each column.
+	// costs rows + cols instead of rows * cols operations per element
+	// ////
+	template <typename value_type, typename layout_t>
+	bool matrix_stencil_separable(const Matrix2D<value_type, layout_t>& in,
+									const std::vector<value_type>& row_weights,
+									const std::vector<value_type>& col_weights,
+									Matrix2D<value_type, layout_t>& out,
+									StencilBoundary boundary = boundary_clamp) {
+		StencilSeparable<value_type> op;
+		op.rows_ = col_weights.size();
+		op.cols_ = row_weights.size();
+		op.center_row_ = op.rows_ / 2;
+		op.center_col_ = op.cols_ / 2;
+		op.row_weights_ = row_weights;
+		op.col_weights_ = col_weights;
+		return stencil_run(in, out, op, boundary);
+	} // matrix_stencil_separable()
+
+} // namespace stock
+
+#endif // __STENCIL_HPP__
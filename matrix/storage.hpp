@@ -0,0 +1,293 @@
+/**
+ *  Project: The Stock Libraries
+ *
+ *  File: storage.hpp
+ *  Created: Oct 18, 2026
+ *
+ *  Author: Abhinav Sarje <abhinav.sarje@gmail.com>
+ *
+ *  Copyright (c) 2012-2017 Abhinav Sarje
+ *  Distributed under the Boost Software License.
+ *  See accompanying LICENSE file.
+ */
+
+#ifndef __STORAGE_HPP__
+#define __STORAGE_HPP__
+
+#include <new>
+#include <iostream>
+#include <cstring>
+#include <cstdlib>
+#include <unistd.h>
+#include <sys/mman.h>
+
+#include "bulk.hpp"
+
+namespace stock {
+
+	/* storage policy used by Matrix to obtain and release its buffer */
+	class MatrixStorage {		// an abstract class
+		public:
+			virtual ~MatrixStorage() { }
+
+			virtual void* allocate(size_t bytes) = 0;				// NULL on failure
+			virtual void deallocate(void* ptr, size_t bytes) = 0;
+			virtual void initialize(void* ptr, size_t num, size_t elem_size) = 0;	// zero num elements
+	}; // class MatrixStorage
+
+
+	/* plain heap storage, zeroed with the bulk primitives */
+	class HeapStorage : public MatrixStorage {
+		public:
+			HeapStorage() { }
+			~HeapStorage() { }
+
+			void* allocate(size_t bytes) {
+				return ::operator new(bytes, std::nothrow);
+			} // allocate()
+
+			void deallocate(void* ptr, size_t) {
+				::operator delete(ptr);
+			} // deallocate()
+
+			void initialize(void* ptr, size_t num, size_t elem_size) {
+				bulk_zero(ptr, num * elem_size);
+			} // initialize()
+	}; // class HeapStorage
+
+
+	// ////
+	// the shared heap storage
+	// ////
+	inline MatrixStorage* heap_matrix_storage() {
+		static HeapStorage storage;
+		return &storage;
+	} // heap_matrix_storage()
+
+
+	/* aligned storage with optional transparent huge pages and parallel first-touch.
+	 * first-touch zeroes the used elements in one contiguous chunk per thread, split as a
+	 * static omp schedule over the elements does (fill(), matrix_add()), so each page lands
+	 * on the NUMA node of the thread which later works on it. huge page buffers are aligned
+	 * to, and sized in, whole huge pages, since the kernel only backs aligned ranges. */
+	class AlignedStorage : public MatrixStorage {
+		private:
+			size_t alignment_;		// in bytes, power of 2, 0 => page size
+			bool huge_pages_;		// advise the kernel to back the buffer with huge pages
+			bool first_touch_;		// initialize in parallel
+			volatile int huge_pages_failed_;	// madvise was refused, reported once
+
+		public:
+			static const size_t CACHE_LINE_ALIGNMENT = 64;
+			static const size_t PAGE_ALIGNMENT = 0;
+			static const size_t HUGE_PAGE_BYTES = (size_t) 2 << 20;
+
+			AlignedStorage(size_t alignment = CACHE_LINE_ALIGNMENT, bool huge_pages = false,
+							bool first_touch = true):
+				alignment_(alignment), huge_pages_(huge_pages), first_touch_(first_touch),
+				huge_pages_failed_(0) { }
+			~AlignedStorage() { }
+
+			size_t alignment() const {
+				size_t align = (alignment_ == PAGE_ALIGNMENT) ? (size_t) sysconf(_SC_PAGESIZE) : alignment_;
+				if(huge_pages_ && align < HUGE_PAGE_BYTES) align = HUGE_PAGE_BYTES;
+				return align;
+			} // alignment()
+
+			void* allocate(size_t bytes) {
+				size_t align = alignment();
+				if(align < sizeof(void*)) align = sizeof(void*);
+				if(huge_pages_) bytes = (bytes + HUGE_PAGE_BYTES - 1) / HUGE_PAGE_BYTES * HUGE_PAGE_BYTES;
+				void* ptr = NULL;
+				if(posix_memalign(&ptr, align, bytes) != 0) return NULL;
+				#ifdef MADV_HUGEPAGE
+				if(huge_pages_ && bytes > 0 && madvise(ptr, bytes, MADV_HUGEPAGE) != 0 &&
+						__sync_bool_compare_and_swap(&huge_pages_failed_, 0, 1))
+					std::cerr << "warning: huge pages not available, using normal pages" << std::endl;
+				#endif
+				return ptr;
+			} // allocate()
+
+			void deallocate(void* ptr, size_t) {
+				free(ptr);
+			} // deallocate()
+
+			void initialize(void* ptr, size_t num, size_t elem_size) {
+				if(!first_touch_ || num * elem_size < BULK_PARALLEL_BYTES_) {
+					memset(ptr, 0, num * elem_size);
+					return;
+				} // if
+				#pragma omp parallel
+				{
+					size_t begin, end;
+					bulk_thread_range(ptr, num, elem_size, begin, end);
+					memset((char*) ptr + begin * elem_size, 0, (end - begin) * elem_size);
+				}
+			} // initialize()
+
+			bool huge_pages_failed() const { return huge_pages_failed_ != 0; }
+	}; // class AlignedStorage
+
+
+	static const size_t POOL_MIN_BYTES_ = 64;			// smallest size class
+	static const unsigned int POOL_NUM_CLASSES_ = 64;	// one size class per power of two
+
+
+	/* size-class pool for matrices which are created and destroyed repeatedly, such as
+	 * temporaries in iterative solvers. requests are rounded up to a power of two, and
+	 * released buffers are kept on a free list of their size class to be handed out again
+	 * without going back to the upstream storage (and without new page faults).
+	 * at most max_cached_bytes are kept, beyond that buffers are returned upstream.
+	 * the free lists are locked per size class, so a buffer may be released by a thread
+	 * other than the one which allocated it. every buffer must be released before the
+	 * pool is destroyed */
+	class PoolStorage : public MatrixStorage {
+		private:
+			struct FreeList {
+				void* head_;			// next pointer is kept in the first word of each buffer
+				volatile int lock_;
+				FreeList(): head_(NULL), lock_(0) { }
+			}; // struct FreeList
+
+			MatrixStorage* upstream_;	// source of new buffers (not owned)
+			size_t max_cached_bytes_;
+			size_t cached_bytes_;		// bytes currently on the free lists
+			size_t hits_;				// allocations served from the free lists
+			size_t misses_;				// allocations passed upstream
+			FreeList lists_[POOL_NUM_CLASSES_];
+
+			// disable copying, buffers belong to the pool
+			PoolStorage(const PoolStorage&);
+			PoolStorage& operator=(const PoolStorage&);
+
+			static unsigned int size_class(size_t bytes, size_t& class_bytes) {
+				unsigned int c = 0;
+				class_bytes = POOL_MIN_BYTES_;
+				while(class_bytes < bytes && c + 1 < POOL_NUM_CLASSES_) { class_bytes <<= 1; ++ c; }
+				return c;
+			} // size_class()
+
+			void lock(FreeList& list) {
+				while(__sync_lock_test_and_set(&list.lock_, 1)) while(list.lock_) { }
+			} // lock()
+
+			void unlock(FreeList& list) {
+				__sync_lock_release(&list.lock_);
+			} // unlock()
+
+		public:
+			PoolStorage(MatrixStorage* upstream = NULL, size_t max_cached_bytes = (size_t) 1 << 30):
+					upstream_(upstream), max_cached_bytes_(max_cached_bytes),
+					cached_bytes_(0), hits_(0), misses_(0) {
+				if(upstream_ == NULL) upstream_ = heap_matrix_storage();
+			} // PoolStorage()
+
+			~PoolStorage() { trim(); }
+
+			void* allocate(size_t bytes) {
+				size_t class_bytes = 0;
+				FreeList& list = lists_[size_class(bytes, class_bytes)];
+				lock(list);
+				void* ptr = list.head_;
+				if(ptr != NULL) list.head_ = *(void**) ptr;
+				unlock(list);
+				if(ptr != NULL) {
+					__sync_sub_and_fetch(&cached_bytes_, class_bytes);
+					__sync_add_and_fetch(&hits_, 1);
+					return ptr;
+				} // if
+				__sync_add_and_fetch(&misses_, 1);
+				return upstream_->allocate(class_bytes);
+			} // allocate()
+
+			void deallocate(void* ptr, size_t bytes) {
+				if(ptr == NULL) return;
+				size_t class_bytes = 0;
+				FreeList& list = lists_[size_class(bytes, class_bytes)];
+				if(__sync_add_and_fetch(&cached_bytes_, class_bytes) > max_cached_bytes_) {
+					__sync_sub_and_fetch(&cached_bytes_, class_bytes);
+					upstream_->deallocate(ptr, class_bytes);
+					return;
+				} // if
+				lock(list);
+				*(void**) ptr = list.head_;
+				list.head_ = ptr;
+				unlock(list);
+			} // deallocate()
+
+			void initialize(void* ptr, size_t num, size_t elem_size) {
+				upstream_->initialize(ptr, num, elem_size);
+			} // initialize()
+
+			// ////
+			// return all cached buffers to the upstream storage
+			// ////
+			void trim() {
+				size_t class_bytes = POOL_MIN_BYTES_;
+				for(unsigned int c = 0; c < POOL_NUM_CLASSES_; ++ c, class_bytes <<= 1) {
+					lock(lists_[c]);
+					void* ptr = lists_[c].head_;
+					lists_[c].head_ = NULL;
+					unlock(lists_[c]);
+					while(ptr != NULL) {
+						void* next = *(void**) ptr;
+						upstream_->deallocate(ptr, class_bytes);
+						__sync_sub_and_fetch(&cached_bytes_, class_bytes);
+						ptr = next;
+					} // while
+				} // for
+			} // trim()
+
+			size_t cached_bytes() const { return cached_bytes_; }
+			size_t hits() const { return hits_; }
+			size_t misses() const { return misses_; }
+	}; // class PoolStorage
+
+
+	// ////
+	// storage override of the calling thread, NULL when none is set (see ScopedMatrixStorage)
+	// ////
+	inline MatrixStorage*& scoped_matrix_storage() {
+	#if __cplusplus >= 201103L
+		static thread_local MatrixStorage* storage = NULL;
+	#else
+		static __thread MatrixStorage* storage = NULL;
+	#endif
+		return storage;
+	} // scoped_matrix_storage()
+
+
+	// ////
+	// storage used by matrices unless another is set: the scoped storage of the
+	// calling thread if any, the heap otherwise
+	// ////
+	inline MatrixStorage* default_matrix_storage() {
+		MatrixStorage* scoped = scoped_matrix_storage();
+		return (scoped != NULL) ? scoped : heap_matrix_storage();
+	} // default_matrix_storage()
+
+
+	/* makes storage the default for matrices created by the calling thread while the
+	 * object is alive, e.g. a PoolStorage around a solver loop. threads of a parallel
+	 * region do not inherit it, each sets its own. matrices created in the scope keep
+	 * using the storage afterwards, so they must not outlive it */
+	class ScopedMatrixStorage {
+		private:
+			MatrixStorage* previous_;
+
+			ScopedMatrixStorage(const ScopedMatrixStorage&);
+			ScopedMatrixStorage& operator=(const ScopedMatrixStorage&);
+
+		public:
+			explicit ScopedMatrixStorage(MatrixStorage* storage): previous_(scoped_matrix_storage()) {
+				scoped_matrix_storage() = storage;
+			} // ScopedMatrixStorage()
+
+			~ScopedMatrixStorage() {
+				scoped_matrix_storage() = previous_;
+			} // ~ScopedMatrixStorage()
+	}; // class ScopedMatrixStorage
+
+} // namespace stock
+
+#endif // __STORAGE_HPP__
@@ -0,0 +1,451 @@
+/**
+ *  Project: The Stock Libraries
+ *
+ *  File: matrix_tests.cpp
+ *  Created: Oct 18, 2026
+ *
+ *  Author: Abhinav Sarje <abhinav.sarje@gmail.com>
+ *
+ *  Copyright (c) 2012-2017 Abhinav Sarje
+ *  Distributed under the Boost Software License.
+ *  See accompanying LICENSE file.
+ */
+
+/* regression tests of Matrix2D. each test prints the checks which fail, the program
+ * returns the number of failed tests. best run under the address sanitizer.
+ *
+ * build:	g++ -std=c++11 -g -fsanitize=address,undefined -fopenmp -I../.. matrix_tests.cpp -o matrix_tests -lpthread
+ * usage:	matrix_tests
+ */
+
+#include <cstdio>
+#include <cstddef>
+#include <cmath>
+#include <complex>
+#include <vector>
+#include <functional>
+#include <utility>
+#include <fcntl.h>
+#include <unistd.h>
+
+#include "../matrix.hpp"
+
+using namespace stock;
+
+
+int test_failures_ = 0;		// failed checks of the current test
+
+#define TEST_CHECK(cond) \
+	do { \
+		if(!(cond)) { \
+			std::printf("  failed: %s (%s:%d)\n", #cond, __FILE__, __LINE__); \
+			++ test_failures_; \
+		} \
+	} while(0)
+
+
+#if __cplusplus >= 201103L
+// ////
+// a moved-from matrix is an empty 0 x 0 matrix which can be used again
+// ////
+template <typename layout_t>
+void test_moved_from_layout() {
+	Matrix2D<double, layout_t> a(4, 5);
+	a.fill(1.0);
+	Matrix2D<double, layout_t> b(std::move(a));
+	TEST_CHECK(a.num_rows() == 0 && a.num_cols() == 0 && a.data() == NULL);
+	TEST_CHECK(b.num_rows() == 4 && b.num_cols() == 5 && b(3, 4) == 1.0);
+	TEST_CHECK(a.incr_rows(2) && a.num_rows() == 2 && a.num_cols() == 0);
+
+	Matrix2D<double, layout_t> c(2, 3);
+	c = std::move(b);
+	TEST_CHECK(b.num_rows() == 0 && b.num_cols() == 0 && b.data() == NULL);
+	TEST_CHECK(c.num_rows() == 4 && c(3, 4) == 1.0);
+	std::vector<double> col(1, 3.0), row(1, 2.0);
+	TEST_CHECK(b.insert_cols(0, &col[0], 1) && b.num_rows() == 0 && b.num_cols() == 1);
+	TEST_CHECK(b.insert_rows(0, &row[0], 1) && b.num_rows() == 1 && b(0, 0) == 2.0);
+
+	Matrix2D<double, layout_t> d(std::move(c));
+	TEST_CHECK(c.resize(3, 5) && c.fill(2.0) && c(2, 4) == 2.0);
+	TEST_CHECK(d(3, 4) == 1.0);
+} // test_moved_from_layout()
+
+void test_moved_from() {
+	test_moved_from_layout<RowMajor>();
+	test_moved_from_layout<ColumnMajor>();
+	test_moved_from_layout<Tiled<2> >();
+} // test_moved_from()
+#endif
+
+
+// ////
+// the result of a product may be one of its operands, also when it has to be resized
+// ////
+template <typename layout_t>
+void test_multiply_aliased_layout() {
+	Matrix2D<double, layout_t> A(2, 3), B(3, 3), P(2, 3), Q(3, 3);
+	for(size_t i = 0; i < 3; ++ i)
+		for(size_t j = 0; j < 3; ++ j) {
+			if(i < 2) A(i, j) = (double) (i + 2 * j + 1);
+			B(i, j) = (double) (3 * i + j) - 4.0;
+		} // for
+	TEST_CHECK(matrix_multiply(A, B, P));
+	TEST_CHECK(matrix_multiply(B, B, Q));
+
+	Matrix2D<double, layout_t> R(B);
+	TEST_CHECK(matrix_multiply(A, R, R));
+	TEST_CHECK(R.num_rows() == 2 && R.num_cols() == 3);
+	Matrix2D<double, layout_t> S(B);
+	TEST_CHECK(matrix_multiply(S, S, S));
+	Matrix2D<double, layout_t> T(A);
+	TEST_CHECK(matrix_multiply(T, B, T, 1.0, 1.0));
+	for(size_t i = 0; i < 3; ++ i)
+		for(size_t j = 0; j < 3; ++ j) {
+			if(i < 2) TEST_CHECK(R(i, j) == P(i, j) && T(i, j) == P(i, j) + A(i, j));
+			TEST_CHECK(S(i, j) == Q(i, j));
+		} // for
+} // test_multiply_aliased_layout()
+
+void test_multiply_aliased() {
+	test_multiply_aliased_layout<RowMajor>();
+	test_multiply_aliased_layout<ColumnMajor>();
+	test_multiply_aliased_layout<Tiled<2> >();
+} // test_multiply_aliased()
+
+
+// ////
+// copies of a copy-on-write matrix never see writes made through pointers into it
+// ////
+void test_copy_on_write() {
+	Matrix2D<double> a(3, 3);
+	a.set_copy_on_write(true);
+	a.fill(1.0);
+	double* p = a.data();
+	Matrix2D<double> b(a);
+	p[0] = 5.0;
+	TEST_CHECK(!b.is_shared());
+	TEST_CHECK(a(0, 0) == 5.0 && b(0, 0) == 1.0);
+
+	Matrix2D<double> c(3, 3);
+	c.set_copy_on_write(true);
+	const Matrix2D<double>& cr = c;
+	Matrix2D<double> d(cr);
+	TEST_CHECK(c.is_shared() && cr(1, 1) == 0.0);
+	d(2, 2) = 7.0;
+	TEST_CHECK(cr(2, 2) == 0.0 && d(2, 2) == 7.0 && !c.is_shared());
+
+	// results of the library kernels are still shared with later copies
+	Matrix2D<double> sum(3, 3), mapped(3, 3), product(3, 3);
+	sum.set_copy_on_write(true);
+	mapped.set_copy_on_write(true);
+	product.set_copy_on_write(true);
+	TEST_CHECK(matrix_add(a, b, sum) && matrix_map(sum, mapped, std::negate<double>()) &&
+				matrix_multiply(a, b, product));
+	Matrix2D<double> sum_copy(sum), mapped_copy(mapped), product_copy(product);
+	TEST_CHECK(sum.use_count() == 2 && mapped.use_count() == 2 && product.use_count() == 2);
+	TEST_CHECK(sum_copy(0, 0) == 6.0 && mapped_copy(0, 0) == -6.0 && product_copy(0, 0) == 7.0);
+} // test_copy_on_write()
+
+
+// ////
+// a saved column-major matrix loads back whole and by row ranges, and a file with an
+// inconsistent header is rejected
+// ////
+void test_save_load() {
+	const char* path = "matrix_tests.mat";
+	Matrix2D<double, ColumnMajor> a(10, 7);
+	for(size_t i = 0; i < 10; ++ i)
+		for(size_t j = 0; j < 7; ++ j) a(i, j) = (double) (i * 7 + j);
+	MatrixFileOptions options;
+	options.rows_per_chunk = 3;
+	TEST_CHECK(matrix_save(path, a, options));
+
+	Matrix2D<double, ColumnMajor> b(1, 1);
+	TEST_CHECK(matrix_load(path, b));
+	TEST_CHECK(b.num_rows() == 10 && b.num_cols() == 7);
+	Matrix2D<double> c(1, 1);
+	TEST_CHECK(matrix_load_rows(path, 2, 8, c));
+	TEST_CHECK(c.num_rows() == 6 && c.num_cols() == 7);
+	for(size_t i = 0; i < 10; ++ i)
+		for(size_t j = 0; j < 7; ++ j) {
+			TEST_CHECK(b(i, j) == a(i, j));
+			if(i >= 2 && i < 8) TEST_CHECK(c(i - 2, j) == a(i, j));
+		} // for
+
+	// no chunk size, and fewer chunks than rows need
+	uint64_t value = 0;
+	int fd = open(path, O_WRONLY);
+	TEST_CHECK(fd >= 0 && pwrite(fd, &value, sizeof(value), offsetof(MatrixFileHeader, rows_per_chunk)) ==
+												(ssize_t) sizeof(value));
+	close(fd);
+	TEST_CHECK(!matrix_load(path, b));
+	TEST_CHECK(matrix_save(path, a, options));
+	value = 2;
+	fd = open(path, O_WRONLY);
+	TEST_CHECK(fd >= 0 && pwrite(fd, &value, sizeof(value), offsetof(MatrixFileHeader, num_chunks)) ==
+												(ssize_t) sizeof(value));
+	close(fd);
+	TEST_CHECK(!matrix_load_rows(path, 8, 10, c));
+	unlink(path);
+} // test_save_load()
+
+
+// ////
+// a column-major matrix converts to csr and csc and back, products match dense loops, and a
+// builder sums duplicate elements and sorts each line
+// ////
+void test_sparse() {
+	const size_t m = 7, n = 5;
+	Matrix2D<double, ColumnMajor> a(m, n);
+	for(size_t i = 0; i < m; ++ i)
+		for(size_t j = 0; j < n; ++ j)
+			if((i + 2 * j) % 3 == 0) a(i, j) = (double) (i * n + j + 1);
+	CSRMatrix<double> csr(a);
+	CSCMatrix<double> csc(a);
+	Matrix2D<double> b(1, 1);
+	Matrix2D<double, ColumnMajor> c(1, 1);
+	TEST_CHECK(csr.to_dense(b) && csc.to_dense(c) && csr.nnz() == csc.nnz());
+	TEST_CHECK(b.num_rows() == m && b.num_cols() == n && c.num_rows() == m && c.num_cols() == n);
+	for(size_t i = 0; i < m; ++ i)
+		for(size_t j = 0; j < n; ++ j)
+			TEST_CHECK(b(i, j) == a(i, j) && c(i, j) == a(i, j) && csr(i, j) == a(i, j) && csc(i, j) == a(i, j));
+
+	std::vector<double> x(n), xt(m), y, yt, z, zt;
+	for(size_t j = 0; j < n; ++ j) x[j] = (double) j - 2.0;
+	for(size_t i = 0; i < m; ++ i) xt[i] = (double) (i % 4) + 1.0;
+	TEST_CHECK(csr.multiply(x, y) && csc.multiply(x, z));
+	TEST_CHECK(csr.multiply_transpose(xt, yt) && csc.multiply_transpose(xt, zt));
+	TEST_CHECK(y.size() == m && z.size() == m && yt.size() == n && zt.size() == n);
+	for(size_t i = 0; i < m && y.size() == m && z.size() == m; ++ i) {
+		double ref = 0.0;
+		for(size_t j = 0; j < n; ++ j) ref += a(i, j) * x[j];
+		TEST_CHECK(y[i] == ref && z[i] == ref);
+	} // for
+	for(size_t j = 0; j < n && yt.size() == n && zt.size() == n; ++ j) {
+		double ref = 0.0;
+		for(size_t i = 0; i < m; ++ i) ref += a(i, j) * xt[i];
+		TEST_CHECK(yt[j] == ref && zt[j] == ref);
+	} // for
+
+	const size_t k = 3;
+	Matrix2D<double, ColumnMajor> X(n, k), XT(m, k);
+	for(size_t i = 0; i < m; ++ i)
+		for(size_t l = 0; l < k; ++ l) {
+			if(i < n) X(i, l) = (double) (i + l) - 1.0;
+			XT(i, l) = (double) (i * l % 5);
+		} // for
+	Matrix2D<double> Y(1, 1), YT(1, 1);
+	Matrix2D<double, ColumnMajor> Z(1, 1), ZT(1, 1);
+	TEST_CHECK(csr.multiply(X, Y) && csc.multiply(X, Z));
+	TEST_CHECK(csr.multiply_transpose(XT, YT) && csc.multiply_transpose(XT, ZT));
+	TEST_CHECK(Y.num_rows() == m && Y.num_cols() == k && Z.num_rows() == m && Z.num_cols() == k);
+	TEST_CHECK(YT.num_rows() == n && YT.num_cols() == k && ZT.num_rows() == n && ZT.num_cols() == k);
+	for(size_t l = 0; l < k; ++ l) {
+		for(size_t i = 0; i < m && Y.num_rows() == m && Z.num_rows() == m; ++ i) {
+			double ref = 0.0;
+			for(size_t j = 0; j < n; ++ j) ref += a(i, j) * X(j, l);
+			TEST_CHECK(Y(i, l) == ref && Z(i, l) == ref);
+		} // for
+		for(size_t j = 0; j < n && YT.num_rows() == n && ZT.num_rows() == n; ++ j) {
+			double ref = 0.0;
+			for(size_t i = 0; i < m; ++ i) ref += a(i, j) * XT(i, l);
+			TEST_CHECK(YT(j, l) == ref && ZT(j, l) == ref);
+		} // for
+	} // for
+
+	// elements added out of order, with repeats
+	SparseBuilder<double> builder(4, 6);
+	const size_t bi[] = { 2, 0, 2, 3, 0, 2, 0, 3 };
+	const size_t bj[] = { 5, 4, 1, 0, 4, 5, 1, 0 };
+	const double bv[] = { 1.0, 2.0, 3.0, 4.0, 5.0, 6.0, 7.0, 8.0 };
+	for(size_t e = 0; e < 8; ++ e) TEST_CHECK(builder.add(bi[e], bj[e], bv[e]));
+	TEST_CHECK(!builder.add(4, 0, 1.0));
+	CSRMatrix<double> bcsr;
+	CSCMatrix<double> bcsc;
+	TEST_CHECK(builder.build(bcsr) && builder.build(bcsc));
+	TEST_CHECK(bcsr.nnz() == 5 && bcsc.nnz() == 5);
+	TEST_CHECK(bcsr(0, 1) == 7.0 && bcsr(0, 4) == 7.0 && bcsr(2, 1) == 3.0 && bcsr(2, 5) == 7.0 && bcsr(3, 0) == 12.0);
+	TEST_CHECK(bcsc(0, 1) == 7.0 && bcsc(0, 4) == 7.0 && bcsc(2, 1) == 3.0 && bcsc(2, 5) == 7.0 && bcsc(3, 0) == 12.0);
+	TEST_CHECK(bcsr(1, 1) == 0.0 && bcsc(1, 1) == 0.0);
+	const size_t* rp = bcsr.outer_starts();
+	const size_t* cp = bcsc.outer_starts();
+	for(size_t i = 0; i < 4; ++ i)
+		for(size_t e = rp[i] + 1; e < rp[i + 1]; ++ e) TEST_CHECK(bcsr.inner_indices()[e - 1] < bcsr.inner_indices()[e]);
+	for(size_t j = 0; j < 6; ++ j)
+		for(size_t e = cp[j] + 1; e < cp[j + 1]; ++ e) TEST_CHECK(bcsc.inner_indices()[e - 1] < bcsc.inner_indices()[e]);
+} // test_sparse()
+
+
+// ////
+// deterministic elements in [-0.5, 0.5), real and complex
+// ////
+void test_random(double& value, unsigned long& seed) {
+	seed = (seed * 1103515245UL + 12345UL) % 2147483648UL;
+	value = (double) seed / 2147483648.0 - 0.5;
+} // test_random()
+
+void test_random(std::complex<double>& value, unsigned long& seed) {
+	double re = 0.0, im = 0.0;
+	test_random(re, seed);
+	test_random(im, seed);
+	value = std::complex<double>(re, im);
+} // test_random()
+
+double test_conj(double value) { return value; }
+std::complex<double> test_conj(const std::complex<double>& value) { return std::conj(value); }
+
+
+// ////
+// factorizations of sizes on both sides of the panel width and the substitution base:
+// the residual of matrix_solve is small, L L^H == A for matrix_cholesky, and singular
+// matrices are rejected
+// ////
+template <typename value_type, typename layout_t>
+void test_solve_layout(size_t n) {
+	const size_t nrhs = 10;
+	unsigned long seed = n;
+	Matrix2D<value_type, layout_t> a(n, n), b(n, nrhs);
+	for(size_t i = 0; i < n; ++ i) {
+		for(size_t j = 0; j < n; ++ j) test_random(a(i, j), seed);
+		for(size_t k = 0; k < nrhs; ++ k) test_random(b(i, k), seed);
+	} // for
+	Matrix2D<value_type, layout_t> x(b);
+	TEST_CHECK(matrix_solve(a, x));
+	double err = 0.0, norm = 0.0;
+	for(size_t i = 0; i < n; ++ i)
+		for(size_t k = 0; k < nrhs; ++ k) {
+			value_type r = - b(i, k);
+			for(size_t j = 0; j < n; ++ j) r += a(i, j) * x(j, k);
+			err = std::max(err, std::abs(r));
+			norm = std::max(norm, std::abs(x(i, k)));
+		} // for
+	TEST_CHECK(err <= 1e-12 * (double) n * (1.0 + norm));
+} // test_solve_layout()
+
+template <typename value_type, typename layout_t>
+void test_cholesky_layout(size_t n) {
+	unsigned long seed = 3 * n;
+	Matrix2D<value_type, layout_t> m(n, n), a(n, n);
+	for(size_t i = 0; i < n; ++ i)
+		for(size_t j = 0; j < n; ++ j) test_random(m(i, j), seed);
+	for(size_t i = 0; i < n; ++ i)
+		for(size_t j = 0; j < n; ++ j) {
+			value_type s = (i == j) ? value_type((double) n) : value_type(0);
+			for(size_t k = 0; k < n; ++ k) s += m(i, k) * test_conj(m(j, k));
+			a(i, j) = s;
+		} // for
+	Matrix2D<value_type, layout_t> l(a);
+	TEST_CHECK(matrix_cholesky(l));
+	double err = 0.0;
+	bool upper_zero = true;
+	for(size_t i = 0; i < n; ++ i)
+		for(size_t j = 0; j < n; ++ j) {
+			value_type s = value_type(0);
+			for(size_t k = 0; k <= std::min(i, j); ++ k) s += l(i, k) * test_conj(l(j, k));
+			err = std::max(err, std::abs(s - a(i, j)));
+			if(j > i && l(i, j) != value_type(0)) upper_zero = false;
+		} // for
+	TEST_CHECK(upper_zero && err <= 1e-12 * (double) (n * n));
+} // test_cholesky_layout()
+
+template <typename layout_t>
+void test_factor_layout() {
+	const size_t sizes[] = { 5, FACTOR_TRSM_BASE_ + 6, FACTOR_BLOCK_ + 2 };
+	for(size_t s = 0; s < sizeof(sizes) / sizeof(sizes[0]); ++ s) {
+		test_solve_layout<double, layout_t>(sizes[s]);
+		test_cholesky_layout<double, layout_t>(sizes[s]);
+		test_cholesky_layout<std::complex<double>, layout_t>(sizes[s]);
+	} // for
+
+	// the second row is twice the first, and the third column the sum of the others
+	Matrix2D<double, layout_t> a(3, 3), b(3, 1);
+	double values[] = { 1.0, 2.0, 3.0, 2.0, 4.0, 6.0, 1.0, 0.0, 1.0 };
+	a.populate(values);
+	b.fill(1.0);
+	TEST_CHECK(!matrix_solve(a, b));
+	a(0, 0) = -1.0;
+	TEST_CHECK(!matrix_cholesky(a));
+} // test_factor_layout()
+
+void test_factor() {
+	test_factor_layout<RowMajor>();
+	test_factor_layout<ColumnMajor>();
+	test_factor_layout<Tiled<2> >();
+} // test_factor()
+
+
+// ////
+// the padding of padded lines and of tiles stays zero through fill, map, zip_map and
+// expression assignment, also when they detach a shared buffer
+// ////
+template <typename layout_t>
+bool test_padding_zero(const Matrix2D<double, layout_t>& mat) {
+	const double* buffer = mat.data();
+	std::vector<bool> element(mat.storage_size(), false);
+	for(size_t i = 0; i < mat.num_rows(); ++ i)
+		for(size_t j = 0; j < mat.num_cols(); ++ j) element[mat.index(i, j)] = true;
+	for(size_t k = 0; k < mat.storage_size(); ++ k)
+		if(!element[k] && buffer[k] != 0.0) return false;
+	return true;
+} // test_padding_zero()
+
+template <typename layout_t>
+void test_padding_layout(size_t ld) {
+	Matrix2D<double, layout_t> a(5, 3), b(5, 3), c(5, 3);
+	if(ld > 0) {
+		a.set_leading_dim(ld);
+		b.set_leading_dim(ld);
+		c.set_leading_dim(ld);
+	} // if
+	TEST_CHECK(a.storage_size() > a.size());
+	a.set_copy_on_write(true);
+	TEST_CHECK(a.fill(2.0) && test_padding_zero(a));
+	Matrix2D<double, layout_t> shared(a);
+	TEST_CHECK(a.fill(3.0) && test_padding_zero(a) && test_padding_zero(shared));
+	TEST_CHECK(matrix_map(a, std::negate<double>()) && test_padding_zero(a) && a(4, 2) == -3.0);
+	TEST_CHECK(matrix_map(a, b, std::negate<double>()) && test_padding_zero(b) && b(4, 2) == 3.0);
+	TEST_CHECK(matrix_zip_map(a, b, c, std::minus<double>()) && test_padding_zero(c) && c(4, 2) == -6.0);
+	c = a / b;
+	TEST_CHECK(test_padding_zero(c) && c(4, 2) == -1.0);
+	c = b + 1.0;
+	TEST_CHECK(test_padding_zero(c) && c(4, 2) == 4.0);
+} // test_padding_layout()
+
+void test_padding() {
+	test_padding_layout<RowMajor>(5);
+	test_padding_layout<ColumnMajor>(8);
+	test_padding_layout<Tiled<2> >(0);
+} // test_padding()
+
+
+typedef void (*test_function)();
+
+struct TestCase {
+	const char* name;
+	test_function run;
+}; // struct TestCase
+
+
+int main() {
+	const TestCase tests[] = {
+	#if __cplusplus >= 201103L
+		{ "moved_from", test_moved_from },
+	#endif
+		{ "multiply_aliased", test_multiply_aliased },
+		{ "copy_on_write", test_copy_on_write },
+		{ "save_load", test_save_load },
+		{ "sparse", test_sparse },
+		{ "factor", test_factor },
+		{ "padding", test_padding }
+	};
+	const size_t num_tests = sizeof(tests) / sizeof(tests[0]);
+
+	int failed = 0;
+	for(size_t t = 0; t < num_tests; ++ t) {
+		test_failures_ = 0;
+		tests[t].run();
+		std::printf("%-24s %s\n", tests[t].name, (test_failures_ == 0) ? "ok" : "FAILED");
+		if(test_failures_ > 0) ++ failed;
+	} // for
+	return failed;
+} // main()
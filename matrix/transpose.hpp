@@ -0,0 +1,202 @@
+/**
+ *  Project: The Stock Libraries
+ *
+ *  File: transpose.hpp
+ *  Created: Oct 18, 2026
+ *
+ *  Author: Abhinav Sarje <abhinav.sarje@gmail.com>
+ *
+ *  Copyright (c) 2012-2017 Abhinav Sarje
+ *  Distributed under the Boost Software License.
+ *  See accompanying LICENSE file.
+ */
+
+#ifndef __TRANSPOSE_HPP__
+#define __TRANSPOSE_HPP__
+
+#include <vector>
+#include <iostream>
+#include <algorithm>
+#ifdef __SSE2__
+#include <immintrin.h>
+#endif
+
+namespace stock {
+
+	const size_t TRANSPOSE_TILE_SIZE_ = 64;	// tile edge, in elements, processed by a thread
+
+	/* transpose engine on raw row-major buffers.
+	 * the matrix is processed in tiles so that both the reads and the writes of a tile stay
+	 * in cache, tiles are distributed over threads, and float/double tiles are transposed
+	 * in registers in 4x4 (or 2x2) blocks. */
+
+	// ////
+	// scalar transpose of a rows x cols block: out(j, i) = in(i, j)
+	// ////
+	template <typename value_type>
+	inline void transpose_block(size_t rows, size_t cols,
+								const value_type* in, size_t ld_in,
+								value_type* out, size_t ld_out) {
+		for(size_t i = 0; i < rows; ++ i) {
+			for(size_t j = 0; j < cols; ++ j) {
+				out[j * ld_out + i] = in[i * ld_in + j];
+			} // for
+		} // for
+	} // transpose_block()
+
+
+#ifdef __SSE2__
+	// ////
+	// float: 4x4 blocks in sse registers, scalar for the edges
+	// ////
+	inline void transpose_block(size_t rows, size_t cols,
+								const float* in, size_t ld_in,
+								float* out, size_t ld_out) {
+		size_t rows4 = rows & ~(size_t) 3, cols4 = cols & ~(size_t) 3;
+		for(size_t i = 0; i < rows4; i += 4) {
+			for(size_t j = 0; j < cols4; j += 4) {
+				const float* a = in + i * ld_in + j;
+				__m128 r0 = _mm_loadu_ps(a);
+				__m128 r1 = _mm_loadu_ps(a + ld_in);
+				__m128 r2 = _mm_loadu_ps(a + 2 * ld_in);
+				__m128 r3 = _mm_loadu_ps(a + 3 * ld_in);
+				_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+				float* b = out + j * ld_out + i;
+				_mm_storeu_ps(b, r0);
+				_mm_storeu_ps(b + ld_out, r1);
+				_mm_storeu_ps(b + 2 * ld_out, r2);
+				_mm_storeu_ps(b + 3 * ld_out, r3);
+			} // for
+		} // for
+		// right edge and bottom edge
+		transpose_block<float>(rows4, cols - cols4, in + cols4, ld_in, out + cols4 * ld_out, ld_out);
+		transpose_block<float>(rows - rows4, cols, in + rows4 * ld_in, ld_in, out + rows4, ld_out);
+	} // transpose_block()
+
+
+	// ////
+	// double: 4x4 blocks in avx registers (2x2 in sse2), scalar for the edges
+	// ////
+	inline void transpose_block(size_t rows, size_t cols,
+								const double* in, size_t ld_in,
+								double* out, size_t ld_out) {
+	#ifdef __AVX__
+		const size_t B = 4;
+	#else
+		const size_t B = 2;
+	#endif
+		size_t rowsb = rows - rows % B, colsb = cols - cols % B;
+		for(size_t i = 0; i < rowsb; i += B) {
+			for(size_t j = 0; j < colsb; j += B) {
+				const double* a = in + i * ld_in + j;
+				double* b = out + j * ld_out + i;
+	#ifdef __AVX__
+				__m256d r0 = _mm256_loadu_pd(a);
+				__m256d r1 = _mm256_loadu_pd(a + ld_in);
+				__m256d r2 = _mm256_loadu_pd(a + 2 * ld_in);
+				__m256d r3 = _mm256_loadu_pd(a + 3 * ld_in);
+				__m256d t0 = _mm256_unpacklo_pd(r0, r1);
+				__m256d t1 = _mm256_unpackhi_pd(r0, r1);
+				__m256d t2 = _mm256_unpacklo_pd(r2, r3);
+				__m256d t3 = _mm256_unpackhi_pd(r2, r3);
+				_mm256_storeu_pd(b, _mm256_permute2f128_pd(t0, t2, 0x20));
+				_mm256_storeu_pd(b + ld_out, _mm256_permute2f128_pd(t1, t3, 0x20));
+				_mm256_storeu_pd(b + 2 * ld_out, _mm256_permute2f128_pd(t0, t2, 0x31));
+				_mm256_storeu_pd(b + 3 * ld_out, _mm256_permute2f128_pd(t1, t3, 0x31));
+	#else
+				__m128d r0 = _mm_loadu_pd(a);
+				__m128d r1 = _mm_loadu_pd(a + ld_in);
+				_mm_storeu_pd(b, _mm_unpacklo_pd(r0, r1));
+				_mm_storeu_pd(b + ld_out, _mm_unpackhi_pd(r0, r1));
+	#endif
+			} // for
+		} // for
+		// right edge and bottom edge
+		transpose_block<double>(rowsb, cols - colsb, in + colsb, ld_in, out + colsb * ld_out, ld_out);
+		transpose_block<double>(rows - rowsb, cols, in + rowsb * ld_in, ld_in, out + rowsb, ld_out);
+	} // transpose_block()
+#endif // __SSE2__
+
+
+	// ////
+	// out-of-place transpose of a rows x cols matrix with leading dimension ld_in
+	// into a cols x rows matrix with leading dimension ld_out given by the caller
+	// ////
+	template <typename value_type>
+	bool matrix_transpose(size_t rows, size_t cols, const value_type* in, size_t ld_in,
+							value_type* out, size_t ld_out) {
+		if(in == NULL || out == NULL) {
+			std::cerr << "error: matrix is NULL while transposing" << std::endl;
+			return false;
+		} // if
+		const size_t T = TRANSPOSE_TILE_SIZE_;
+		size_t row_tiles = (rows + T - 1) / T, col_tiles = (cols + T - 1) / T;
+		#pragma omp parallel for collapse(2) schedule(static)
+		for(size_t ti = 0; ti < row_tiles; ++ ti) {
+			for(size_t tj = 0; tj < col_tiles; ++ tj) {
+				size_t i = ti * T, j = tj * T;
+				transpose_block(std::min(T, rows - i), std::min(T, cols - j),
+								in + i * ld_in + j, ld_in, out + j * ld_out + i, ld_out);
+			} // for
+		} // for
+		return true;
+	} // matrix_transpose()
+
+
+	// ////
+	// out-of-place transpose of packed buffers
+	// ////
+	template <typename value_type>
+	bool matrix_transpose(size_t rows, size_t cols, const value_type* in, value_type* out) {
+		return matrix_transpose(rows, cols, in, cols, out, rows);
+	} // matrix_transpose()
+
+
+	// ////
+	// in-place transpose of a packed rows x cols buffer.
+	// square matrices swap tile pairs in parallel,
+	// rectangular matrices follow the permutation cycles
+	// ////
+	template <typename value_type>
+	bool matrix_transpose_in(size_t rows, size_t cols, value_type* data) {
+		if(data == NULL) {
+			std::cerr << "error: matrix is NULL while transposing" << std::endl;
+			return false;
+		} // if
+		if(rows == cols) {
+			const size_t T = TRANSPOSE_TILE_SIZE_;
+			size_t n = rows, tiles = (n + T - 1) / T;
+			#pragma omp parallel for schedule(dynamic)
+			for(size_t ti = 0; ti < tiles; ++ ti) {
+				size_t i0 = ti * T, i1 = std::min(n, i0 + T);
+				for(size_t tj = ti; tj < tiles; ++ tj) {
+					size_t j0 = tj * T, j1 = std::min(n, j0 + T);
+					for(size_t i = i0; i < i1; ++ i) {
+						for(size_t j = (ti == tj ? i + 1 : j0); j < j1; ++ j) {
+							std::swap(data[i * n + j], data[j * n + i]);
+						} // for
+					} // for
+				} // for
+			} // for
+			return true;
+		} // if
+		// element at position p moves to position p * rows mod (N - 1)
+		size_t num = rows * cols;
+		if(num < 3) return true;
+		std::vector<bool> visited(num, false);
+		for(size_t start = 1; start < num - 1; ++ start) {
+			if(visited[start]) continue;
+			value_type temp = data[start];
+			size_t p = start;
+			do {
+				p = (p * rows) % (num - 1);
+				std::swap(temp, data[p]);
+				visited[p] = true;
+			} while(p != start);
+		} // for
+		return true;
+	} // matrix_transpose_in()
+
+} // namespace stock
+
+#endif // __TRANSPOSE_HPP__
@@ -0,0 +1,244 @@
+/**
+ *  Project: The Stock Libraries
+ *
+ *  File: view.hpp
+ *  Created: Oct 18, 2026
+ *
+ *  Author: Abhinav Sarje <abhinav.sarje@gmail.com>
+ *
+ *  Copyright (c) 2012-2017 Abhinav Sarje
+ *  Distributed under the Boost Software License.
+ *  See accompanying LICENSE file.
+ */
+
+#ifndef __VIEW_HPP__
+#define __VIEW_HPP__
+
+#include <vector>
+#include <iostream>
+
+namespace stock {
+
+	/* non-owning strided n-dimensional view over a matrix buffer.
+	 * strides are in number of elements and may be negative (reversed dimension).
+	 * all the slicing operations return a new view on the same memory, nothing is copied. */
+	template <typename value_type>
+	class MatrixView {
+		private:
+			value_type* data_;					// pointer to the first element of the view
+			size_t num_dims_;					// number of dimensions
+			std::vector<size_t> dims_;			// size of each dimension
+			std::vector<long int> strides_;		// stride of each dimension (in elements)
+
+		public:
+			// ////
+			// default constructor: empty view
+			// ////
+			MatrixView(): data_(NULL), num_dims_(0) {
+			} // MatrixView()
+
+
+			// ////
+			// view over a packed row-major buffer with given dimensions
+			// ////
+			MatrixView(value_type* data, const std::vector<size_t>& dims):
+					data_(data), num_dims_(dims.size()), dims_(dims), strides_(dims.size()) {
+				long int stride = 1;
+				for(int d = (int) num_dims_ - 1; d >= 0; -- d) {
+					strides_[d] = stride;
+					stride *= dims_[d];
+				} // for
+			} // MatrixView()
+
+
+			// ////
+			// view with explicit strides
+			// ////
+			MatrixView(value_type* data, const std::vector<size_t>& dims,
+						const std::vector<long int>& strides):
+					data_(data), num_dims_(dims.size()), dims_(dims), strides_(strides) {
+				if(strides.size() != dims.size()) {
+					std::cerr << "error: number of strides does not match number of dimensions"
+								<< std::endl;
+					data_ = NULL; num_dims_ = 0; dims_.clear(); strides_.clear();
+				} // if
+			} // MatrixView()
+
+
+			~MatrixView() { }
+
+
+			// ////
+			// accessors
+			// ////
+
+			size_t dims() const { return num_dims_; }
+			size_t dim_size(size_t d) const { return dims_[d]; }
+			long int stride(size_t d) const { return strides_[d]; }
+			const std::vector<size_t>& extents() const { return dims_; }
+			const std::vector<long int>& strides() const { return strides_; }
+
+			// raw pointer to the first element, to be used together with the strides
+			value_type* data() const { return data_; }
+
+			size_t size() const {
+				if(num_dims_ == 0) return 0;
+				size_t tot_elems = 1;
+				for(size_t d = 0; d < num_dims_; ++ d) tot_elems *= dims_[d];
+				return tot_elems;
+			} // size()
+
+			// true if the view elements occupy a packed row-major block of memory
+			bool is_contiguous() const {
+				long int stride = 1;
+				for(int d = (int) num_dims_ - 1; d >= 0; -- d) {
+					if(dims_[d] != 1 && strides_[d] != stride) return false;
+					stride *= dims_[d];
+				} // for
+				return true;
+			} // is_contiguous()
+
+
+			// ////
+			// element access
+			// ////
+
+			value_type& operator()(size_t i) const {
+				return data_[strides_[0] * (long int) i];
+			} // operator()()
+
+			value_type& operator()(size_t i, size_t j) const {
+				return data_[strides_[0] * (long int) i + strides_[1] * (long int) j];
+			} // operator()()
+
+			value_type& operator()(size_t i, size_t j, size_t k) const {
+				return data_[strides_[0] * (long int) i + strides_[1] * (long int) j +
+								strides_[2] * (long int) k];
+			} // operator()()
+
+			value_type& operator()(const std::vector<size_t>& index) const {
+				long int offset = 0;
+				for(size_t d = 0; d < num_dims_; ++ d) offset += strides_[d] * (long int) index[d];
+				return data_[offset];
+			} // operator()()
+
+
+			// ////
+			// view transformations
+			// ////
+
+			// ////
+			// fix dimension d at given index, the resulting view has one less dimension
+			// ////
+			MatrixView slice(size_t d, size_t index) const {
+				if(d >= num_dims_ || index >= dims_[d]) {
+					std::cerr << "error: slice index out of range" << std::endl;
+					return MatrixView();
+				} // if
+				std::vector<size_t> dims;
+				std::vector<long int> strides;
+				for(size_t i = 0; i < num_dims_; ++ i) {
+					if(i == d) continue;
+					dims.push_back(dims_[i]);
+					strides.push_back(strides_[i]);
+				} // for
+				return MatrixView(data_ + strides_[d] * (long int) index, dims, strides);
+			} // slice()
+
+
+			// ////
+			// restrict dimension d to the range [begin, end) taking every step-th element
+			// ////
+			MatrixView range(size_t d, size_t begin, size_t end,
+								size_t step = 1) const {
+				if(d >= num_dims_ || begin > end || end > dims_[d] || step == 0) {
+					std::cerr << "error: invalid range for view dimension " << d << std::endl;
+					return MatrixView();
+				} // if
+				std::vector<size_t> dims(dims_);
+				std::vector<long int> strides(strides_);
+				dims[d] = (end - begin + step - 1) / step;
+				strides[d] = strides_[d] * (long int) step;
+				return MatrixView(data_ + strides_[d] * (long int) begin, dims, strides);
+			} // range()
+
+
+			// ////
+			// sub-block starting at given indices with given sizes, in all dimensions
+			// ////
+			MatrixView block(const std::vector<size_t>& begin,
+								const std::vector<size_t>& sizes) const {
+				if(begin.size() != num_dims_ || sizes.size() != num_dims_) {
+					std::cerr << "error: block specification does not match number of dimensions"
+								<< std::endl;
+					return MatrixView();
+				} // if
+				long int offset = 0;
+				for(size_t d = 0; d < num_dims_; ++ d) {
+					if(begin[d] + sizes[d] > dims_[d]) {
+						std::cerr << "error: block exceeds view dimension " << d << std::endl;
+						return MatrixView();
+					} // if
+					offset += strides_[d] * (long int) begin[d];
+				} // for
+				return MatrixView(data_ + offset, sizes, strides_);
+			} // block()
+
+
+			// ////
+			// reverse the order of elements along dimension d
+			// ////
+			MatrixView reverse(size_t d) const {
+				if(d >= num_dims_) {
+					std::cerr << "error: invalid dimension to reverse" << std::endl;
+					return MatrixView();
+				} // if
+				std::vector<long int> strides(strides_);
+				strides[d] = - strides_[d];
+				value_type* data = data_;
+				if(dims_[d] > 0) data += strides_[d] * (long int) (dims_[d] - 1);
+				return MatrixView(data, dims_, strides);
+			} // reverse()
+
+
+			// ////
+			// permute the axes: new dimension i is the old dimension order[i]
+			// ////
+			MatrixView permute(const std::vector<size_t>& order) const {
+				if(order.size() != num_dims_) {
+					std::cerr << "error: permutation does not match number of dimensions" << std::endl;
+					return MatrixView();
+				} // if
+				std::vector<bool> seen(num_dims_, false);
+				std::vector<size_t> dims(num_dims_);
+				std::vector<long int> strides(num_dims_);
+				for(size_t i = 0; i < num_dims_; ++ i) {
+					if(order[i] >= num_dims_ || seen[order[i]]) {
+						std::cerr << "error: invalid axis permutation" << std::endl;
+						return MatrixView();
+					} // if
+					seen[order[i]] = true;
+					dims[i] = dims_[order[i]];
+					strides[i] = strides_[order[i]];
+				} // for
+				return MatrixView(data_, dims, strides);
+			} // permute()
+
+
+			// ////
+			// swap the last two dimensions
+			// ////
+			MatrixView transpose() const {
+				if(num_dims_ < 2) return *this;
+				std::vector<size_t> order(num_dims_);
+				for(size_t i = 0; i < num_dims_; ++ i) order[i] = i;
+				order[num_dims_ - 2] = num_dims_ - 1;
+				order[num_dims_ - 1] = num_dims_ - 2;
+				return permute(order);
+			} // transpose()
+
+	}; // class MatrixView
+
+} // namespace stock
+
+#endif // __VIEW_HPP__